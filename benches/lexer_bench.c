@@ -0,0 +1,106 @@
+#include "lexer.h"
+
+#include <time.h>
+
+/*
+Tokenizer throughput benchmark
+usage: lexer_bench [--scan=avx2|sse2|scalar] [--stream] [--threads=N] [file.nex]
+(--stream lexes through lexer_tokenize_all instead of one lexer_next_token call per token,
+--threads=N through lexer_tokenize_parallel with N workers, 0 for every online cpu)
+(synthesizes ~32MB of declarations when no file is given)
+*/
+
+static const char* unit =
+    "fn compute_%zu => (int: accumulated_sample_weight_%zu, short uint: c) {\n"
+    "    var long int: table_entry_with_a_fairly_descriptive_name_%zu = 123_456_789_012;\n"
+    "    if (accumulated_sample_weight_%zu > 30) {\n"
+    "        fprint(\"sample %zu exceeded the configured weight\", c * 9 + 4 - 7);\n"
+    "    }\n"
+    "    return (accumulated_sample_weight_%zu * 9) + (c << 2) - 3.1415f;\n"
+    "}\n\n";
+
+static char* bench_synthesize(size_t target, size_t* size) {
+    size_t capacity = target + 4096, len = 0;
+    char* buf = malloc(capacity);
+
+    if (!buf) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t n = 0; len + 1024 < target; n++) {
+        len += (size_t)sprintf(buf + len, unit, n, n, n, n, n, n);
+    }
+
+    buf[len] = '\0';
+    *size = len;
+
+    return buf;
+}
+
+static double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    Lexer* lexer;
+    char* synth = NULL;
+    char* file = NULL;
+    bool stream = false;
+    int threads = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--scan=", 7) == 0) {
+            if (!scan_use(argv[i] + 7)) {
+                fprintf(stderr, "[lexer_bench] scanner '%s' is not available\n", argv[i] + 7);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = true;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+        } else {
+            file = argv[i];
+        }
+    }
+
+    if (file) {
+        lexer = lexer_init(file);
+    } else {
+        size_t size;
+        synth = bench_synthesize((size_t)32 << 20, &size);
+        lexer = lexer_init_from_buffer(synth, size);
+    }
+
+    size_t tokens = 0;
+    double start = bench_now();
+
+    if (stream || threads >= 0) {
+        TokenStream* all = (threads >= 0) ? lexer_tokenize_parallel(lexer, (unsigned int)threads) : lexer_tokenize_all(lexer);
+
+        tokens = all->size;
+        token_stream_free(all);
+    } else {
+        while (true) {
+            Token* token = lexer_next_token(lexer);
+            tokens++;
+
+            if (token->type == TOK_EOF) {
+                break;
+            }
+        }
+    }
+
+    double elapsed = bench_now() - start;
+
+    printf("[lexer_bench] %zu bytes, %zu tokens in %.3f s (%s scanner)\n",
+        lexer->buf_size, tokens, elapsed, scanner.isa);
+    printf("[lexer_bench] %.2f Mtokens/s, %.2f MB/s\n",
+        (double)tokens / elapsed / 1e6, (double)lexer->buf_size / elapsed / (1 << 20));
+
+    lexer_free(lexer);
+    free(synth);
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "parser.h"
+#include "nexast.h"
+#include "io.h"
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+Parser throughput and AST footprint benchmark
+usage: parser_bench [--threads=N] [--lazy] [--cons] [--nexast] [--reparse] [--decls=D] [file.nex]
+(N defaults to every online cpu; --lazy skips function bodies; --cons shares structurally equal
+pure expressions (hash-consing); --nexast also times loading the
+tree back from a .nexast image; --reparse also times one-character edits of a digit in the
+middle of the file; synthesizes ~2MB of functions into a temporary file when no file
+is given, or D small ones with --decls, as edits should cost the same however many
+declarations the file has)
+*/
+
+static const char* head =
+    "fn compute_%zu => (int: accumulated_sample_weight, short uint: c) {\n"
+    "    var long int: table_entry = accumulated_sample_weight * 9 + (c << 2) - 3;\n"
+    "    while (accumulated_sample_weight < table_entry) {\n"
+    "        return (accumulated_sample_weight * 9) + (c << 2) - 3 * table_entry;\n"
+    "    }\n";
+
+static const char* body =
+    "    return (accumulated_sample_weight * 9) + (c << 2) - 3 * table_entry;\n";
+
+static char* bench_synthesize(size_t target, size_t decls) {
+    static char path[] = "/tmp/parser_bench_XXXXXX";
+    int fd = mkstemp(path);
+    FILE* file = (fd >= 0) ? fdopen(fd, "w") : NULL;
+
+    if (!file) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t n = 0, len = 0; (decls) ? n < decls : len < target; n++) {
+        len += (size_t)fprintf(file, head, n);
+
+        for (int i = 0; i < 32 && !decls; i++) {
+            len += (size_t)fprintf(file, "%s", body);
+        }
+
+        len += (size_t)fprintf(file, "}\n\n");
+    }
+
+    fclose(file);
+
+    return path;
+}
+
+static double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    char* synth = NULL;
+    char* file = NULL;
+    unsigned int threads = 0;
+    size_t decls = 0;
+    bool lazy = false, cons = false, cache = false, reparse = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = (unsigned int)atoi(argv[i] + 10);
+        } else if (strcmp(argv[i], "--lazy") == 0) {
+            lazy = true;
+        } else if (strcmp(argv[i], "--cons") == 0) {
+            cons = true;
+        } else if (strcmp(argv[i], "--nexast") == 0) {
+            cache = true;
+        } else if (strcmp(argv[i], "--reparse") == 0) {
+            reparse = true;
+        } else if (strncmp(argv[i], "--decls=", 8) == 0) {
+            decls = (size_t)atol(argv[i] + 8);
+        } else {
+            file = argv[i];
+        }
+    }
+
+    if (!file) {
+        synth = bench_synthesize((size_t)2 << 20, decls);
+        file = synth;
+    }
+
+    double start = bench_now();
+    Parser* parser = parser_init(file);
+    double lexed = bench_now();
+
+    parser->lazy = lazy;
+
+    if (cons) {
+        ast_pool_cons(&parser->exprs);
+    }
+    parser_parse_parallel(parser, threads);
+
+    double parsed = bench_now();
+
+    size_t lines = parser->lexer->lines_size;
+    size_t bytes = parser->arena.allocated + ast_pool_bytes(&parser->exprs);
+
+    printf("[parser_bench] %zu bytes, %zu lines, %zu tokens\n",
+        parser->lexer->buf_size, lines, parser->tokens->size);
+    printf("[parser_bench] lexed in %.3f s, parsed in %.3f s (%.2f Mlines/s)\n",
+        lexed - start, parsed - lexed, (double)lines / (parsed - lexed) / 1e6);
+    printf("[parser_bench] %zu AST bytes (%zu expression nodes), %.1f bytes/line\n",
+        bytes, parser->exprs.size, (double)bytes / (double)lines);
+
+    if (cache) {
+        char* path = nexast_path(".", file);
+        SourceBuffer src = io_load_file(file);
+        uint64_t hash = nexast_hash(src.data, src.size);
+        size_t size = src.size;
+
+        io_free_file(&src);
+        nexast_write(path, hash, size, parser->root, &parser->exprs, parser->tbl);
+
+        // (as the driver does on a rebuild: hash the source, then map its cache)
+        double before = bench_now();
+
+        src = io_load_file(file);
+        hash = nexast_hash(src.data, src.size);
+        io_free_file(&src);
+
+        NexAst* ast = nexast_load(path, hash, size);
+        double loaded = bench_now();
+
+        printf("[parser_bench] hashed and loaded from .nexast in %.4f s%s\n", loaded - before,
+            (!ast) ? " (failed)" : "");
+
+        nexast_free(ast);
+        remove(path);
+        free(path);
+    }
+
+    if (reparse) {
+        // (first single-digit token past the middle of the file, as an editor would touch it)
+        TokenStream* tokens = parser->tokens;
+        size_t offset = parser->lexer->buf_size;
+
+        for (size_t i = 0; i < tokens->size; i++) {
+            char c = parser->lexer->buf[tokens->offset[i]];
+
+            if (tokens->offset[i] >= parser->lexer->buf_size / 2 && tokens->len[i] == 1 && c >= '0' && c <= '8') {
+                offset = tokens->offset[i];
+                break;
+            }
+        }
+
+        if (offset == parser->lexer->buf_size) {
+            printf("[parser_bench] no digit to edit past the middle of the file\n");
+        } else {
+            // (the digit and back, over and over)
+            char digits[] = { (char)(parser->lexer->buf[offset] + 1), parser->lexer->buf[offset] };
+            double total = 0, slowest = 0;
+            int edits = 32, applied = 0;
+
+            for (int i = 0; i < edits; i++) {
+                double before = bench_now();
+                applied += parser_reparse(parser, offset, 1, &digits[i % 2], 1);
+                double took = bench_now() - before;
+
+                total += took;
+                slowest = (took > slowest) ? took : slowest;
+            }
+
+            printf("[parser_bench] reparsed a one-character edit in %.6f s on average, %.6f s at most (%d of %d in place, %.0fx faster than lexing and parsing)\n",
+                total / edits, slowest, applied, edits, (parsed - start) / (total / edits));
+        }
+    }
+
+    parser_free(parser);
+
+    if (synth) {
+        remove(synth);
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include "symtbl.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+Symbol table scaling benchmark
+usage: symtbl_bench [--max=N] [--threads=N]
+(declares 1024, 2048, ... up to N symbols (1M by default) in a fresh table, then looks every one
+of them up, and as many names that aren't declared; the time per symbol should hold flat as the
+table grows. --threads=N then stresses one index from 1, 2, ... up to N threads (0 for every
+online cpu): each adds N / threads symbols of its own through a table sharing the index, looking
+up another thread's symbols as it goes, and all of them race for the same contested keys, each
+of which must end up held by exactly one)
+*/
+
+static double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void bench_name(char* buf, const char* prefix, size_t n) {
+    sprintf(buf, "%s_%zu", prefix, n);
+}
+
+#define BENCH_MAX_THREADS 64
+
+typedef struct BenchRun {
+    SymTable* table; // shares the index of every other run
+    Symbol** own; // symbols of its own, added in order
+    Symbol** contested; // symbols of the keys every run adds
+    size_t size, contested_size;
+    struct BenchRun* next; // run whose symbols this one looks up
+    size_t found, held;
+} BenchRun;
+
+static void* bench_run(void* arg) {
+    BenchRun* run = (BenchRun*)arg;
+
+    for (size_t n = 0; n < run->size; n++) {
+        symtbl_add(run->table, run->own[n]);
+
+        // (whatever the other run has added so far, without waiting on it)
+        Symbol* other = run->next->own[n / 2];
+        run->found += symtbl_find(run->table, other->data.atom, other->data.scope) == other;
+
+        if (n % 8 == 0 && n / 8 < run->contested_size) {
+            Symbol* symb = run->contested[n / 8];
+            run->held += symtbl_add(run->table, symb) == symb;
+        }
+    }
+
+    return NULL;
+}
+
+static void bench_threads(size_t max, unsigned int threads) {
+    /*
+    Adds max symbols to one index from 1, 2, ... up to provided # of threads
+    */
+
+    char name[64];
+
+    printf("[symtbl_bench] %10s %12s %12s %12s\n", "threads", "add ns", "adds/s", "contested");
+
+    for (unsigned int size = 1; size <= threads; size *= 2) {
+        SymTable* table = symtbl_init();
+        BenchRun runs[BENCH_MAX_THREADS];
+        pthread_t handles[BENCH_MAX_THREADS];
+        size_t per = max / size, contested = (per + 7) / 8;
+
+        for (unsigned int t = 0; t < size; t++) {
+            runs[t] = (BenchRun){ symtbl_init_shared(table), malloc(per * sizeof(Symbol*)),
+                malloc(contested * sizeof(Symbol*)), per, contested, &runs[(t + 1) % size], 0, 0 };
+
+            if (!runs[t].own || !runs[t].contested) {
+                exit(EXIT_FAILURE);
+            }
+
+            for (size_t n = 0; n < per; n++) {
+                bench_name(name, "thread_local", (size_t)t * per + n);
+                runs[t].own[n] = symbol_init(intern_atom(name, strlen(name)), SYMBOL_VARIABLE, (unsigned int)(n % 4096), 0, 0, 0, 0, 0, 0, 0);
+            }
+
+            for (size_t n = 0; n < contested; n++) {
+                bench_name(name, "contested", n);
+                runs[t].contested[n] = symbol_init(intern_atom(name, strlen(name)), SYMBOL_VARIABLE, (unsigned int)(n % 4096), 0, 0, 0, 0, 0, 0, 0);
+            }
+        }
+
+        double start = bench_now();
+
+        for (unsigned int t = 1; t < size; t++) {
+            pthread_create(&handles[t], NULL, bench_run, &runs[t]);
+        }
+
+        bench_run(&runs[0]);
+
+        for (unsigned int t = 1; t < size; t++) {
+            pthread_join(handles[t], NULL);
+        }
+
+        double time = bench_now() - start;
+        size_t adds = 0, held = 0, found = 0;
+
+        for (unsigned int t = 0; t < size; t++) {
+            adds += runs[t].size + runs[t].contested_size;
+            held += runs[t].held;
+            found += runs[t].found;
+        }
+
+        printf("[symtbl_bench] %10u %12.1f %12.0f %6zu of %zu (%zu found while adding)\n", size,
+            time / (double)adds * 1e9, (double)adds / time, held, contested, found);
+
+        if (held != contested) {
+            printf("[symtbl_bench] contested keys held %zu times, expected %zu\n", held, contested);
+            exit(EXIT_FAILURE);
+        }
+
+        for (unsigned int t = 0; t < size; t++) {
+            // (contested symbols that lost their key aren't linked into any table)
+            for (size_t n = 0; n < contested; n++) {
+                if (symtbl_find(table, runs[t].contested[n]->data.atom, runs[t].contested[n]->data.scope) != runs[t].contested[n]) {
+                    free(runs[t].contested[n]);
+                }
+            }
+
+            free(runs[t].own);
+            free(runs[t].contested);
+            symtbl_free(runs[t].table);
+        }
+
+        symtbl_free(table);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t max = (size_t)1 << 20;
+    int threads = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--max=", 6) == 0) {
+            max = (size_t)strtoull(argv[i] + 6, NULL, 10);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+        }
+    }
+
+    char name[64];
+
+    printf("[symtbl_bench] %10s %12s %12s %12s\n", "symbols", "insert ns", "hit ns", "miss ns");
+
+    for (size_t size = 1024; size <= max; size *= 2) {
+        SymTable* table = symtbl_init();
+        Symbol** symbols = malloc(size * sizeof(Symbol*));
+
+        if (!symbols) {
+            exit(EXIT_FAILURE);
+        }
+
+        // (names and scopes of a large file: many locals spread over as many scopes)
+        for (size_t n = 0; n < size; n++) {
+            bench_name(name, "local_variable", n);
+            symbols[n] = symbol_init(intern_atom(name, strlen(name)), SYMBOL_VARIABLE, (unsigned int)(n % 4096), 0, 0, 0, 0, 0, 0, 0);
+        }
+
+        double start = bench_now();
+
+        for (size_t n = 0; n < size; n++) {
+            symtbl_add(table, symbols[n]);
+        }
+
+        double insert = bench_now() - start;
+        size_t found = 0;
+
+        start = bench_now();
+
+        for (size_t n = 0; n < size; n++) {
+            found += symtbl_find(table, symbols[n]->data.atom, symbols[n]->data.scope) != NULL;
+        }
+
+        double hit = bench_now() - start;
+        uint32_t* missing = malloc(size * sizeof(uint32_t));
+
+        if (!missing) {
+            exit(EXIT_FAILURE);
+        }
+
+        for (size_t n = 0; n < size; n++) {
+            bench_name(name, "undeclared", n);
+            missing[n] = intern_atom(name, strlen(name));
+        }
+
+        start = bench_now();
+
+        for (size_t n = 0; n < size; n++) {
+            found += symtbl_find(table, missing[n], (unsigned int)(n % 4096)) != NULL;
+        }
+
+        double miss = bench_now() - start;
+
+        printf("[symtbl_bench] %10zu %12.1f %12.1f %12.1f (%zu found)\n", size,
+            insert / (double)size * 1e9, hit / (double)size * 1e9, miss / (double)size * 1e9, found);
+
+        free(missing);
+        free(symbols);
+        symtbl_free(table);
+    }
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (int)online : 1;
+    }
+
+    if (threads > 0) {
+        bench_threads(max, (threads < BENCH_MAX_THREADS) ? (unsigned int)threads : BENCH_MAX_THREADS);
+    }
+
+    return 0;
+}
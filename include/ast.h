@@ -1,4 +1,6 @@
 #include "p_info.h"
+#include "memory.h"
+#include "scope.h"
 #include <stdlib.h>
 #include <inttypes.h>
 #include <stdbool.h>
@@ -8,15 +10,7 @@ typedef struct AST_Node AST_Node;
 typedef struct ASTN_Literal ASTN_Literal;
 typedef struct ASTN_DataTypeSpecifier ASTN_DataTypeSpecifier;
 typedef struct ASTN_Statement ASTN_Statement;
-typedef struct ASTN_Expression ASTN_Expression;
 typedef struct ASTN_Call ASTN_Call;
-typedef struct ASTN_PrimaryExpr ASTN_PrimaryExpr;
-typedef struct ASTN_FactorExpr ASTN_FactorExpr;
-typedef struct ASTN_TermExpr ASTN_TermExpr;
-typedef struct ASTN_MultiplicationExpr ASTN_MultiplicationExpr;
-typedef struct ASTN_AdditionExpr ASTN_AdditionExpr;
-typedef struct ASTN_BitwiseExpr ASTN_BitwiseExpr;
-typedef struct ASTN_ComparisonExpr ASTN_ComparisonExpr;
 typedef struct ASTN_Parameters ASTN_Parameters;
 typedef struct ASTN_Module ASTN_Module;
 typedef struct ASTN_ImportDecl ASTN_ImportDecl;
@@ -40,6 +34,29 @@ typedef struct ASTN_ThrowStm ASTN_ThrowStm;
 typedef struct ASTN_Statements ASTN_Statements;
 typedef struct ASTN_MEP ASTN_MEP;
 
+// growable array of provided item type: the first AST_VEC_INLINE bytes of items live in the
+// vector itself, later ones spill into an arena array that doubles whenever it's full; nothing
+// points into the vector, so it may be copied by value (items are reached by AST_VEC_ITEMS)
+#define AST_VEC_INLINE 16
+
+#define AST_VEC_FIELDS(type) \
+    uint32_t size; \
+    uint32_t capacity; /* # of items the spilled array holds; 0 while they're inline */ \
+    union { \
+        type* heap; \
+        type small[(sizeof(type) <= AST_VEC_INLINE) ? AST_VEC_INLINE / sizeof(type) : 1]; \
+    } items
+
+#define AST_VEC(type) struct { AST_VEC_FIELDS(type); }
+
+// (vec is evaluated more than once; a zeroed vector is empty and valid)
+#define AST_VEC_ITEMS(vec) (((vec).capacity) ? (vec).items.heap : (vec).items.small)
+#define AST_VEC_SMALL(vec) (sizeof((vec).items.small) / sizeof((vec).items.small[0]))
+#define AST_VEC_RESERVE(arena, vec, count) \
+    ast_vec_reserve((arena), &(vec).capacity, &(vec).items, (vec).size, (count), sizeof((vec).items.small[0]), AST_VEC_SMALL(vec))
+#define AST_VEC_PUSH(arena, vec, item) \
+    (AST_VEC_RESERVE((arena), (vec), (vec).size + 1), AST_VEC_ITEMS(vec)[(vec).size++] = (item))
+
 typedef struct ASTN_Literal {
     int type;
     union {
@@ -65,11 +82,7 @@ typedef struct ASTN_Literal {
         char* string;
         int boolean;
         size_t size;
-        struct {
-            AST_Node** items;
-            size_t size;
-            size_t item_size;
-        } array;
+        AST_VEC(AST_Node*) array;
     } value;
 } ASTN_Literal;
 
@@ -82,16 +95,31 @@ typedef struct ASTN_DataTypeSpecifier {
 } ASTN_DataTypeSpecifier;
 
 typedef struct ASTN_Statements {
-    AST_Node** statement;
-    size_t size;
-    size_t item_size;
+    AST_VEC_FIELDS(AST_Node*);
 } ASTN_Statements;
 
-typedef struct ASTN_CallParams {
-    AST_Node** parameter;
-    size_t size;
-    size_t item_size;
-} ASTN_CallParams;
+typedef struct ASTN_Root {
+    AST_VEC_FIELDS(AST_Node*); // top-level declarations, in source order
+} ASTN_Root;
+
+typedef struct ASTN_Body {
+    size_t start, end; // [start, end) token range of the statements, skipped by a lazy parser
+    ScopeId scope; // scope and nest the statements are parsed in
+    uint8_t nest;
+    uint32_t owner; // stamp of the declaration it belongs to, given to the symbols it declares
+    struct Symbol** bound; // symbols in scope where it was skipped (outermost first), bound again to parse it
+    size_t bound_size;
+} ASTN_Body;
+
+typedef uint32_t ASTN_ExprRef; // index of an expression in its ASTN_ExprPool; 0 is no expression
+
+// symbol an identifier names: the atom of its name (see intern_atom) and the scope it's declared in
+typedef struct ASTN_Iden {
+    uint32_t atom;
+    ScopeId scope;
+} ASTN_Iden;
+
+#define AST_IDEN_EQ(a, b) ((a).atom == (b).atom && (a).scope == (b).scope)
 
 typedef struct ASTN_Call {
     enum {
@@ -100,155 +128,77 @@ typedef struct ASTN_Call {
         CALL_CLASS
     } type;
 
-    int32_t identifier;
-    ASTN_CallParams* params;
+    ASTN_Iden identifier;
+    uint32_t args; // index of the first argument in the pool's args
+    uint32_t size; // # of arguments
 } ASTN_Call;
 
-typedef struct ASTN_PrimaryExpr {
-    enum {
-        PRIMARY_CALL,
-        PRIMARY_IDENTIFIER,
-        PRIMARY_LITERAL,
-    } type;
-
-    union {
-        ASTN_Call call;
-        int32_t identifier;
-        ASTN_Literal literal;
-    } data;
-} ASTN_PrimaryExpr;
-
-typedef struct ASTN_FactorExpr {
-    enum {
-        FACTOR_PRIMARY,
-        FACTOR_UNARY_OP
-    } type;
+typedef enum ASTN_ExprType {
+    EXPR_FUNCTION_CALL,
+    EXPR_IDENTIFIER,
+    EXPR_LITERAL,
+    EXPR_PRIMARY,
+    EXPR_FACTOR, // prefix operator
+    EXPR_TERM, // binary operators, by precedence level
+    EXPR_MULTIPLICATION,
+    EXPR_ADDITION,
+    EXPR_BITWISE,
+    EXPR_COMPARISON,
+    EXPR_NEST, // parenthesized expression
+    EXPR_POSTFIX // postfix ++ and --
+} ASTN_ExprType;
+
+typedef struct ASTN_ExprNode {
+    uint8_t type; // ASTN_ExprType
+    uint8_t op; // operator token type of unary and binary expressions
 
     union {
-        ASTN_PrimaryExpr primary;
         struct {
-            int op;
-            ASTN_Expression* expr;
-        } unary_op;
-    } data;
-} ASTN_FactorExpr;
-
-typedef struct ASTN_TermExpr {
-    enum {
-        TERM_FACTOR,
-        TERM_BINARY_OP
-    } type;
-
-    union {
-        ASTN_FactorExpr factor;
-        struct {
-            int op;
-            ASTN_Expression* left;
-            ASTN_Expression* right;
+            ASTN_ExprRef left;
+            ASTN_ExprRef right;
         } binary_op;
-    } data;
-} ASTN_TermExpr;
-
-typedef struct ASTN_MultiplicationExpr {
-    enum {
-        MULTIPLICATION_TERM,
-        MULTIPLICATION_BINARY_OP
-    } type;
-
-    union {
-        ASTN_TermExpr term;
         struct {
-            int op;
-            ASTN_Expression* left;
-            ASTN_Expression* right;
-        } binary_op;
+            ASTN_ExprRef expr;
+        } unary_op; // EXPR_FACTOR, EXPR_NEST and EXPR_POSTFIX
+        ASTN_Iden identifier;
+        uint32_t literal; // index in the pool's literals
+        uint32_t call; // index in the pool's calls
     } data;
-} ASTN_MultiplicationExpr;
+} ASTN_ExprNode;
 
-typedef struct ASTN_AdditionExpr {
-    enum {
-        ADDITION_MULTIPLICATION,
-        ADDITION_BINARY_OP
-    } type;
+typedef struct ASTN_ExprPool {
+    // expressions are fixed size nodes in one array, refering to their operands by index;
+    // payloads that don't fit a node live in the side tables below
+    ASTN_ExprNode* nodes; // nodes[0] is reserved so 0 can stand for no expression
+    size_t size, capacity;
 
-    union {
-        ASTN_MultiplicationExpr multiplication;
-        struct {
-            int op;
-            ASTN_Expression* left;
-            ASTN_Expression* right;
-        } binary_op;
-    } data;
-} ASTN_AdditionExpr;
+    ASTN_Literal* literals;
+    size_t literals_size, literals_capacity;
 
-typedef struct ASTN_BitwiseExpr {
-    enum {
-        BITWISE_ADDITION,
-        BITWISE_BINARY_OP
-    } type;
+    ASTN_Call* calls;
+    size_t calls_size, calls_capacity;
 
-    union {
-        ASTN_AdditionExpr addition;
-        struct {
-            int op;
-            ASTN_Expression* left;
-            ASTN_Expression* right;
-        } binary_op;
-    } data;
-} ASTN_BitwiseExpr;
+    ASTN_ExprRef* args; // arguments of every call, contiguous per call
+    size_t args_size, args_capacity;
 
-typedef struct ASTN_ComparisonExpr {
-    enum {
-        COMPARISON_BITWISE,
-        COMPARISON_BINARY_OP
-    } type;
+    ASTN_ExprRef* scratch; // arguments of the calls being parsed (nested calls stack up)
+    size_t scratch_size, scratch_capacity;
 
-    union {
-        ASTN_BitwiseExpr bitwise;
-        struct {
-            int op;
-            ASTN_Expression* left;
-            ASTN_Expression* right;
-        } binary_op;
-    } data;
-} ASTN_ComparisonExpr;
+    // hash-consing, once ast_pool_cons turns it on: pure expressions built through ast_expr_cons
+    // share one node with every structurally equal one
+    bool cons;
+    uint64_t* hashes; // structural hash of every node (stable across runs); 0 for unshared nodes
+    size_t hashes_capacity;
+    ASTN_ExprRef* shared; // shared nodes by hash (open addressing, 0 is an empty slot)
+    size_t shared_size, shared_capacity;
+} ASTN_ExprPool;
 
-typedef struct ASTN_Expression {
-    enum {
-        EXPR_FUNCTION_CALL,
-        EXPR_IDENTIFIER,
-        EXPR_LITERAL,
-        EXPR_PRIMARY,
-        EXPR_FACTOR,
-        EXPR_TERM,
-        EXPR_MULTIPLICATION,
-        EXPR_ADDITION,
-        EXPR_BITWISE,
-        EXPR_COMPARISON,
-        EXPR_NEST
-    } type;
+typedef struct ASTN_PoolBase {
+    uint32_t nodes; // added to the expression references of an appended pool
+    uint32_t args; // added to its argument indices
+} ASTN_PoolBase;
 
-    union {
-        ASTN_Call function_call;
-        int32_t identifier;
-        struct {
-            union {
-                struct {
-                    ASTN_Expression* left;
-                    ASTN_Expression* right;
-                } binary_op;
-            } data;
-        } nest;
-        ASTN_Literal literal;
-        ASTN_PrimaryExpr primary;
-        ASTN_FactorExpr factor;
-        ASTN_TermExpr term;
-        ASTN_MultiplicationExpr multiplication;
-        ASTN_AdditionExpr addition;
-        ASTN_BitwiseExpr bitwise;
-        ASTN_ComparisonExpr comparison;
-    } data;
-} ASTN_Expression;
+#define AST_EXPR(pool, ref) (&(pool)->nodes[(ref)]) // invalidated by the next ast_expr_init
 
 typedef struct ASTN_Parameter {
     ASTN_DataTypeSpecifier data_type_specifier;
@@ -256,9 +206,7 @@ typedef struct ASTN_Parameter {
 } ASTN_Parameter;
 
 typedef struct ASTN_Parameters {
-    ASTN_Parameter** parameter;
-    size_t size;
-    size_t item_size;
+    AST_VEC_FIELDS(ASTN_Parameter*);
 } ASTN_Parameters;
 
 typedef struct ASTN_Module {
@@ -267,11 +215,7 @@ typedef struct ASTN_Module {
 } ASTN_Module;
 
 typedef struct ASTN_ImportDecl {
-    struct {
-        ASTN_Module** items;
-        size_t size;
-        size_t item_size;
-    } modules;
+    AST_VEC(ASTN_Module*) modules;
 
     ASTN_Module* source;
     char* alias;
@@ -290,22 +234,18 @@ typedef struct ASTN_AttributeUnit {
         AST_Node* fn;
     } data;
 
-    __uint128_t re_scope;
-    __uint128_t scope;
+    ScopeId re_scope; // scope of the declaration it was brought into by 'ext' (see parser_parse_extend_attr)
+    ScopeId scope; // scope of the attribute or class declaring it
 } ASTN_AttributeUnit;
 
 typedef struct ASTN_AttributeList {
-    AST_Node** items;
-
-    size_t size;
-    size_t item_size;
-
+    AST_VEC_FIELDS(AST_Node*);
 } ASTN_AttributeList;
 
 
 typedef struct ASTN_AttributeDecl {
     ASTN_AttributeList* list;
-    int32_t identifier;
+    ASTN_Iden identifier;
 } ASTN_AttributeDecl;
 
 
@@ -314,123 +254,117 @@ typedef struct ASTN_VariableDecl {
     storage;
     ASTN_DataTypeSpecifier data_type_specifier;
     union {
-        int sg;
+        ASTN_Iden sg;
         struct {
-            int* items;
+            ASTN_Iden* items;
             size_t size;
         } mult;
     } iden;
 
-    AST_Node* expr;
+    ASTN_ExprRef expr;
 } ASTN_VariableDecl;
 
 typedef struct ASTN_FunctionDecl {
-    int access, storage, identifier;
+    int access, storage;
+    ASTN_Iden identifier;
     ASTN_DataTypeSpecifier data_type_specifier;
     ASTN_Parameters* parameters;
     ASTN_Statements* statements;
+    ASTN_Body* body; // skipped body, parsed by parser_parse_body; NULL once parsed
 } ASTN_FunctionDecl;
 
 typedef struct ASTN_StructMemberDecl {
     int storage;
     ASTN_DataTypeSpecifier data_type_specifier;
-    int32_t identifier;
+    ASTN_Iden identifier;
 } ASTN_StructMemberDecl;
 
 typedef struct ASTN_StructDecl {
     int access;
-    int32_t identifier;
-    struct {
-        ASTN_StructMemberDecl* items;
-        size_t size;
-        size_t item_size;
-    } members;
+    ASTN_Iden identifier;
+    AST_VEC(ASTN_StructMemberDecl) members;
 } ASTN_StructDecl;
 
 typedef struct ASTN_ClassDecl {
-    int32_t identifier;
+    ASTN_Iden identifier;
 
-    ASTN_FunctionDecl init, free;
+    ASTN_FunctionDecl *init, *free;
 
     ASTN_AttributeList* attributes;
 } ASTN_ClassDecl;
 
 typedef struct ASTN_EnumDecl {
-    int32_t identifier;
-    struct {
-        uint32_t* items;
-        size_t size;
-        size_t item_size;
-    } members;
+    ASTN_Iden identifier;
+    AST_VEC(ASTN_Iden) members;
 } ASTN_EnumDecl;
 
+typedef struct ASTN_ErrMember {
+    ASTN_DataTypeSpecifier dts;
+    ASTN_Iden identifier;
+} ASTN_ErrMember;
+
 typedef struct ASTN_ErrDecl {
-    int32_t identifier;
-    struct {
-        ASTN_DataTypeSpecifier* dtss;
-        uint32_t* identifiers;
-        size_t size;
-        size_t item_size;
-    } members;
+    ASTN_Iden identifier;
+    AST_VEC(ASTN_ErrMember) members;
 } ASTN_ErrDecl;
 
+typedef struct ASTN_ElifBranch {
+    ASTN_ExprRef condition;
+    ASTN_Statements* statements;
+} ASTN_ElifBranch;
+
 typedef struct ASTN_ConditionalStm {
-    AST_Node* if_condition;
+    ASTN_ExprRef if_condition;
     ASTN_Statements* if_statements;
-    struct {
-        AST_Node** conditions;
-        ASTN_Statements** statements;
-        size_t size;
-        size_t item_size_a, item_size_b;
-    } elif_branches;
-    AST_Node* else_statements;
+    AST_VEC(ASTN_ElifBranch) elif_branches;
+    ASTN_Statements* else_statements;
 } ASTN_ConditionalStm;
 
 typedef struct ASTN_ForStm {
-    char var[MAX_IDENTIFIER_LEN];
     ASTN_VariableDecl var_decl;
 
-    AST_Node* condition_expr;
-    AST_Node* next_expr;
+    ASTN_ExprRef condition_expr;
+    ASTN_ExprRef next_expr;
 
     ASTN_Statements* statements;
 } ASTN_ForStm;
 
+typedef struct ASTN_SwitchClause {
+    ASTN_ExprRef value;
+    ASTN_Statements* statements;
+} ASTN_SwitchClause;
+
 typedef struct ASTN_SwitchStm {
-    AST_Node* condition_expr;
-    ASTN_Statement* default_stms;
-    struct {
-        AST_Node** value;
-        ASTN_Statements** statements;
-        size_t size;
-        size_t item_size;
-    } clauses;
+    ASTN_ExprRef condition_expr;
+    ASTN_Statements* default_stms;
+    AST_VEC(ASTN_SwitchClause) clauses;
 } ASTN_SwitchStm;
 
+typedef struct ASTN_ExceptBranch {
+    ASTN_Iden error;
+    ASTN_Statements* statements;
+} ASTN_ExceptBranch;
+
 typedef struct ASTN_TryStm {
     ASTN_Statements* try_statements;
-    struct {
-        uint32_t* errors;
-        ASTN_Statements** statements;
-        size_t size;
-        size_t item_size_a, item_size_b;
-    } except_branches;
+    AST_VEC(ASTN_ExceptBranch) except_branches;
     ASTN_Statements* finally_statements;
 } ASTN_TryStm;
 
 typedef struct ASTN_WhileStm {
-    AST_Node* condition_expr;
+    ASTN_ExprRef condition_expr;
     ASTN_Statements* statements;
 } ASTN_WhileStm;
 
 typedef struct ASTN_ReturnStm {
-    AST_Node* expr;
+    ASTN_ExprRef expr;
 } ASTN_ReturnStm;
 
 typedef struct ASTN_ThrowStm {
-    ASTN_CallParams* params;
+    uint32_t args; // index of the first argument in the pool's args
+    uint32_t size; // # of arguments
 
-    uint8_t iden;
+    ASTN_Iden iden;
 } ASTN_ThrowStm;
 
 typedef struct ASTN_Statement {
@@ -473,7 +407,7 @@ typedef struct ASTN_Statement {
         ASTN_SwitchStm switch_stm;
         ASTN_TryStm try_stm;
         ASTN_WhileStm while_loop;
-        ASTN_Expression expression;
+        ASTN_ExprRef expression;
         ASTN_ReturnStm return_stm;
         ASTN_ThrowStm throw_stm;
         bool brak;
@@ -484,27 +418,40 @@ typedef struct ASTN_Statement {
 typedef struct ASTN_MEP {
     ASTN_Parameters* parameters;
     ASTN_Statements* statements;
+    ASTN_Body* body; // skipped body, parsed by parser_parse_body; NULL once parsed
 } ASTN_MEP;
 
 struct AST_Node {
     enum {
         STMT,
         MEP,
-        EXPR,
         ROOT
     } type;
 
     union {
-        bool root;
+        ASTN_Root root;
         ASTN_Statement stm;
         ASTN_MEP mep;
-        ASTN_Expression expr;
-    } data;
+    } data; // expressions aren't nodes of their own, statements refer to them by ASTN_ExprRef
 
     AST_Node* parent;
     AST_Node* right;
     AST_Node* left;
 };
 
-AST_Node* ast_init(int type);
-void ast_free(AST_Node* node);
+AST_Node* ast_init(Arena* arena, int type);
+void ast_vec_reserve(Arena* arena, uint32_t* capacity, void* items, size_t size, size_t count, size_t item_size, size_t small);
+
+void ast_pool_init(ASTN_ExprPool* pool);
+void ast_pool_free(ASTN_ExprPool* pool);
+ASTN_ExprRef ast_expr_init(ASTN_ExprPool* pool, uint8_t type, uint8_t op);
+void ast_pool_cons(ASTN_ExprPool* pool);
+ASTN_ExprRef ast_expr_cons(ASTN_ExprPool* pool, ASTN_ExprRef ref);
+uint64_t ast_expr_hash(ASTN_ExprPool* pool, ASTN_ExprRef ref);
+uint32_t ast_literal_push(ASTN_ExprPool* pool, ASTN_Literal* literal);
+uint32_t ast_call_push(ASTN_ExprPool* pool, ASTN_Call* call);
+void ast_scratch_push(ASTN_ExprPool* pool, ASTN_ExprRef arg);
+uint32_t ast_scratch_pop(ASTN_ExprPool* pool, size_t from);
+size_t ast_pool_bytes(ASTN_ExprPool* pool);
+ASTN_PoolBase ast_pool_append(ASTN_ExprPool* pool, ASTN_ExprPool* from);
+void ast_rebase(AST_Node* node, ASTN_PoolBase base);
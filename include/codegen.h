@@ -6,8 +6,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-void GEN(AST_Node *root);
-void generate_code_for_ast(AST_Node *node, FILE *fp);
-void generate_code_for_statement(AST_Node *statement, FILE *fp);
+void GEN(AST_Node *root, ASTN_ExprPool *exprs);
+void generate_code_for_ast(AST_Node *node, ASTN_ExprPool *exprs, FILE *fp);
+void generate_code_for_statement(AST_Node *statement, ASTN_ExprPool *exprs, FILE *fp);
 
 #endif /* CODEGEN_H */
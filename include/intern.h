@@ -0,0 +1,33 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// process-wide string interner: every distinct name gets a dense 32-bit atom (1, 2, ...) the
+// first time it's interned, so names compare and hash as integers from then on; 0 is no atom.
+// Atoms are handed out in the order names are first seen (by any thread), so whatever outlives
+// the process keeps intern_hash or intern_name rather than the atom
+
+#define INTERN_SHARDS 64 // tables names are spread over by hash, each behind its own lock
+#define INTERN_BLOCK 4096 // names per block of the atom directory
+#define INTERN_BLOCKS 16384 // blocks of the atom directory (caps the # of atoms)
+#define INTERN_CACHE 256 // entries of an InternCache
+
+// atoms one thread interned lately, by hash (direct-mapped); hits take no lock, so threads
+// interning the same names over and over don't queue up on one shard. A zeroed cache is empty
+typedef struct InternCache {
+    uint32_t atoms[INTERN_CACHE];
+} InternCache;
+
+uint32_t intern_atom(const char* str, size_t len);
+uint32_t intern_atom_cached(InternCache* cache, const char* str, size_t len);
+uint32_t intern_count(void);
+
+const char* intern_name(uint32_t atom);
+size_t intern_len(uint32_t atom);
+uint64_t intern_hash(uint32_t atom);
+
+uint64_t intern_hash_bytes(const char* str, size_t len);
+
+#endif // INTERN_H
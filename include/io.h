@@ -1,6 +1,15 @@
 #ifndef IO_H
 #define IO_H
 
-char* io_load_file(char* filename);
+#include <stddef.h>
 
-#endif // IO_H
\ No newline at end of file
+typedef struct SourceBuffer {
+    char* data; // file contents, always followed by a '\0'
+    size_t size; // # of content bytes (excluding the trailing '\0')
+    size_t map_size; // # of bytes mapped at data; 0 when data is heap allocated
+} SourceBuffer;
+
+SourceBuffer io_load_file(char* filename);
+void io_free_file(SourceBuffer* src);
+
+#endif // IO_H
@@ -2,6 +2,10 @@
 #define LEXER_H
 
 #include "token.h"
+#include "io.h"
+#include "scan.h"
+#include "intern.h"
+#include "memory.h"
 
 #include <ctype.h>
 #include <stddef.h>
@@ -12,47 +16,85 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+typedef struct LexerDiag {
+    char* message;
+    size_t offset; // where in the buffer it was raised (the source line is rendered on print)
+} LexerDiag;
+
 typedef struct Lexer {
     char c; // current charachter
-    unsigned int i; // current index 
+    size_t i; // current index 
 
     char* buf; // buffer
-    unsigned int buf_size; // buffer size 
-     
-    uint8_t cc; // current column
-    unsigned int cl; // current line
+    size_t buf_size; // buffer size 
+    SourceBuffer src; // backing storage when loaded from a file (src.data is NULL for borrowed buffers)
+
+    size_t* lines; // offset of every line start (lines[0] is 0), indexed once on load
+    size_t lines_size; // # of lines
+
+    Token tok; // token being lexed; handed out by lexer_scan_token, copied by its callers
+    Arena arena; // tokens of lexer_next_token and every token value, released by lexer_free
+    InternCache atoms; // atoms of the identifiers it lexed lately
+
+    LexerDiag* diag; // diagnostics held back (parallel lexing); NULL prints them right away
+    size_t diags, diag_cap; // # of held back diagnostics (at most LEXER_MAX_ERRORS are kept)
+    size_t errors; // # of diagnostics raised; past LEXER_MAX_ERRORS they are only counted
 } Lexer;
 
 // allocating and freeing methods
 
 Lexer* lexer_init(char* filename);
+Lexer* lexer_init_from_source(SourceBuffer src);
+Lexer* lexer_init_from_buffer(char* buf, size_t size);
+Lexer* lexer_view(Lexer* lexer, size_t i);
 void lexer_free(Lexer* lexer);
+void lexer_view_free(Lexer* view);
 
-Token* lexer_token_init(Lexer* lexer, char* value, uint8_t type);
-void token_free(Token* token);
+Token* lexer_token_init(Lexer* lexer, size_t offset, size_t len, uint8_t type);
+char* lexer_token_value(Lexer* lexer, Token* token);
+
+TokenStream* token_stream_init(const char* buf, size_t capacity);
+void token_stream_push(TokenStream* stream, Token* token);
+void token_stream_append(TokenStream* stream, TokenStream* from, size_t index);
+void token_stream_splice(TokenStream* stream, size_t index, size_t count, TokenStream* from);
+void token_stream_reserve(TokenStream* stream, size_t count);
+char* token_stream_value(TokenStream* stream, size_t index);
+__uint128_t token_stream_number(TokenStream* stream, size_t index);
+void token_stream_free(TokenStream* stream);
 
 // important and general functions 
 
 Token* lexer_next_token(Lexer* lexer);
+Token* lexer_scan_token(Lexer* lexer);
+TokenStream* lexer_tokenize_all(Lexer* lexer);
+TokenStream* lexer_tokenize_parallel(Lexer* lexer, unsigned int threads);
+
+bool lexer_edit(Lexer* lexer, size_t offset, size_t removed, const char* text, size_t inserted);
+size_t lexer_retokenize(Lexer* lexer, TokenStream* stream, size_t from, size_t edit_end, ptrdiff_t delta, size_t* lexed);
+
+unsigned int lexer_line(Lexer* lexer, size_t offset);
+unsigned int lexer_column(Lexer* lexer, size_t offset);
 
 char* lexer_peek(Lexer* lexer, int8_t offset);
 char lexer_peep(Lexer* lexer, int8_t offset);
 void lexer_advance(Lexer* lexer, uint8_t offset);
+void lexer_skip(Lexer* lexer, size_t count);
 
 // helper functions
 
 void lexer_handle_fillers(Lexer* lexer);
 void lexer_handle_error(Lexer* lexer);
 
+uint8_t lexer_keyword(const char* iden, size_t len);
 Token* lexer_handle_alpha(Lexer* lexer);
 Token* lexer_handle_numeric(Lexer* lexer, bool is_negative);
 Token* lexer_handle_1char(Lexer* lexer);
 
 // helper-helper functions
 
-void lexer_process_digits(Lexer* lexer, char** buf, bool has_decimal);
-uint8_t lexer_process_decimal_type(char* buf, uint8_t diadc);
-uint8_t lexer_process_int_type(char* buf);
+bool lexer_process_digits(Lexer* lexer, size_t* separators, bool has_decimal);
+uint8_t lexer_process_decimal_type(const char* buf, size_t len, uint8_t diadc);
+uint8_t lexer_process_int_type(const char* buf, size_t len, __uint128_t* value);
 
 Token* lexer_process_pos_singlechar(Lexer* lexer, char next_char,
     char c_pos1, char c_pos2,
@@ -61,7 +103,8 @@ Token* lexer_process_minus_op(Lexer* lexer, char next_char);
 
 Token* lexer_process_single_quote(Lexer* lexer);
 Token* lexer_process_double_quote(Lexer* lexer);
-void lexer_process_escape_code(Lexer* lexer, char **buf);
+void lexer_process_string_run(Lexer* lexer);
+void lexer_process_escape_code(Lexer* lexer, char* buf, size_t* len);
 
 // error manager
 
@@ -76,6 +119,9 @@ extern struct ErrorTemplate templates[];
 
 char* lexer_get_reference(Lexer* lexer);
 void lexer_report_error(Lexer* lexer, char* error_code, ...);
+void lexer_emit(Lexer* lexer, const char* message, size_t offset);
+void lexer_replay_diag(Lexer* lexer, size_t from, size_t until, Lexer* to);
+void lexer_flush_diag(Lexer* lexer, size_t from, Lexer* to);
 
 
 #endif // LEXER_H
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+
+// bump allocator: allocations are carved out of large blocks and released together by
+// arena_free; nothing is freed on its own
+
+#define ARENA_BLOCK_SIZE (64 * 1024) // usable bytes of a regular block
+#define ARENA_ALIGN 16 // alignment of every allocation (enough for __int128)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t size; // usable bytes following the (aligned) header
+    size_t used;
+} ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock* head; // block allocations are carved from; a zeroed Arena is empty and valid
+    size_t allocated; // # of bytes handed out
+} Arena;
+
+void arena_init(Arena* arena);
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+void* arena_realloc(Arena* arena, void* ptr, size_t size, size_t new_size);
+char* arena_strndup(Arena* arena, const char* str, size_t len);
+void arena_adopt(Arena* arena, Arena* from);
+void arena_free(Arena* arena);
+
+#endif // MEMORY_H
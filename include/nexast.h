@@ -0,0 +1,46 @@
+#ifndef NEXAST_H
+#define NEXAST_H
+
+#include "symtbl.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// .nexast: the tree, expressions and symbols of a parsed file as one image whose pointers are
+// written as offsets from its start; once mapped (anywhere) its relocation table turns them into
+// addresses in one pass, without parsing or allocating anything per object. Atoms are numbered
+// by the image itself, which carries their names, so its atom table maps them to the loading
+// process's own the same way
+
+typedef struct NexAstHeader {
+    char magic[8]; // "NEXAST\0\0"
+    uint32_t version; // NEXAST_VERSION
+    uint32_t layout; // sizes of the node types the image was written with
+    uint64_t source_hash; // nexast_hash of the source file
+    uint64_t source_size;
+
+    uint64_t size; // # of bytes of the image (the whole file)
+    uint64_t relocs, relocs_size; // offset and # of the offsets of every pointer in the image
+
+    uint64_t root, exprs, symbols; // offsets of the root node, the expression pool and the first symbol
+    uint64_t atoms, atoms_size; // offset and # of the '\0' terminated names of the image's atoms 1, 2, ...
+    uint64_t atom_slots, atom_slots_size; // offset and # of the offsets of every atom in the image
+} NexAstHeader;
+
+typedef struct NexAst {
+    NexAstHeader* image; // the whole file
+    size_t map_size; // # of bytes mapped at image; 0 when image is heap allocated
+
+    AST_Node* root;
+    ASTN_ExprPool* exprs; // read only: never grown nor freed on its own
+    SymTable tbl;
+} NexAst;
+
+char* nexast_path(char* dir, char* filename);
+uint64_t nexast_hash(const char* data, size_t size);
+
+bool nexast_write(char* path, uint64_t hash, size_t source_size, AST_Node* root, ASTN_ExprPool* exprs, SymTable* tbl);
+NexAst* nexast_load(char* path, uint64_t hash, size_t source_size);
+void nexast_free(NexAst* ast);
+
+#endif // NEXAST_H
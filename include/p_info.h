@@ -3,9 +3,19 @@
 
 #define TAB_LEN 4
 #define MAX_IDENTIFIER_LEN 81
+#define MAX_NUMERIC_LIT_LEN 64
 
 #define MAX_FLOAT_LIT_DIGITS 7
 #define MAX_DOUBLE_LIT_DIGITS 15
 #define WRITE_ERRORS_TO 0
+#define LEXER_MAX_ERRORS 100 // diagnostics printed before the rest are suppressed
+
+#define LEXER_PARALLEL_MIN_CHUNK (1 << 20) // bytes per worker below which lexing stays sequential
+#define LEXER_MAX_THREADS 64
+
+#define PARSER_PARALLEL_MIN_TOKENS (1 << 16) // function tokens per worker below which parsing stays sequential
+#define PARSER_MAX_THREADS 64
+
+#define NEXAST_VERSION 8 // bumped whenever the node types or the .nexast layout change
 
 #endif // P_INFO_H
\ No newline at end of file
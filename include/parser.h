@@ -4,37 +4,85 @@
 #include "lexer.h"
 #include "tmp/alphadev.h"
 
+#include <setjmp.h>
+
+typedef struct ParserSpan {
+    size_t start, end; // [start, end) token range of a declaration of the root
+    uint32_t owner; // stamp of the symbols it declared (Symbol.data.owner)
+    size_t bytes; // bytes of nodes, expressions and scopes parsing it took (see parser_bytes)
+    Symbol* symbols; // its symbols, one run of the table's list (NULL if it declared none)
+    Symbol* last;
+} ParserSpan;
+
 typedef struct Parser {
     Lexer* lexer;
-    Token* cur;
-    AST_Node* tree;
-    AST_Node* root;
+    TokenStream* tokens; // whole file, lexed up front
+    size_t pos; // index of the current token in tokens
+    AST_Node* root; // its declarations are the top-level ones
+    Arena arena; // every AST node and child array of the compilation, released by parser_free
+    ASTN_ExprPool exprs; // every expression of the compilation
     SymTable* tbl;
 
-    __uint128_t highest_scope;
-    __uint128_t scope;
+    ParserSpan* spans; // token range of every declaration of root, in order, for parser_reparse
+    size_t spans_size;
+    size_t garbage; // bytes of the declarations parser_reparse replaced, still held until the whole file is parsed again
+    uint32_t owner; // stamp given to the symbols being declared
+    uint32_t owners; // # of stamps handed out
+    uint32_t* ranks; // position in root of the declaration of each stamp (by owner), for what it sees
+    bool displaced; // a declaration was refused a name held by one ranked after it (only while parser_reparse runs)
+    ScopeTree* scopes; // every scope of the compilation (shared with the workers), ids reserved a declaration at a time
+
+    ScopeId highest_scope; // last id handed out of the current declaration's run
+    ScopeId scope; // innermost open scope
     uint8_t nest;
+    bool lazy; // function and MEP bodies are skipped (their token range kept) for parser_parse_body
+
+    jmp_buf* bail; // where parser_consume jumps at TOK_EOF (instead of exiting) while parser_parse runs a declaration
+    Symbol* symb; // symbol of the function declaration about to be parsed, declared up front by parser_parse
+    Symbol* hidden; // symbol of the function whose body is being parsed, if already declared (not seen by the body)
+    char* value; // text of the token at value_pos, the last one resolved by PCV
+    size_t value_pos;
 } Parser;
 
 Parser* parser_init(char* filename);
+Parser* parser_init_from_source(SourceBuffer src);
 void parser_free(Parser* parser);
+void parser_parse(Parser* parser);
+void parser_parse_parallel(Parser* parser, unsigned int threads);
+ASTN_Statements* parser_parse_body(Parser* parser, AST_Node* node);
+bool parser_reparse(Parser* parser, size_t offset, size_t removed, const char* text, size_t inserted);
 
 bool parser_expectsq(Parser* parser, ...);
 bool parser_expect(Parser* parser, uint8_t expected);
 void parser_consume(Parser* parser);
+uint8_t parser_peek(Parser* parser, size_t offset);
+char* parser_value(Parser* parser, size_t index);
+uint32_t parser_atom(Parser* parser, size_t index);
+Symbol* parser_find(Parser* parser, uint32_t atom);
+
+// enters a scope of provided kind (enum ScopeKind) inside the current one, taking the next id
+// of the declaration's run
+#define PES(parser, kind)                                          \
+    do {                                                           \
+        ScopeId entered_ = ++(parser)->highest_scope;              \
+        scope_open((parser)->scopes, entered_, (parser)->scope, (kind)); \
+        (parser)->scope = entered_;                                \
+        symtbl_enter((parser)->tbl);                               \
+    } while (0)
 
-#define PES(parser)                                \
-    do {                                           \
-        if ((parser)->scope < (parser)->highest_scope) { \
-            (parser)->scope = (parser)->highest_scope + 1; \
-        } else {                                   \
-            (parser)->scope += 1;                  \
-        }                                          \
-        if ((parser)->scope > (parser)->highest_scope) { \
-            (parser)->highest_scope = (parser)->scope; \
-        }                                          \
+// leaves the scope PES entered last (its symbols stop hiding the outer ones), back to its parent
+#define PLS(parser)                                                \
+    do {                                                           \
+        (parser)->scope = scope_parent((parser)->scopes, (parser)->scope); \
+        symtbl_leave((parser)->tbl, symtbl_depth((parser)->tbl) - 1); \
     } while (0)
 
+#define PCT(parser) ((parser)->tokens->type[(parser)->pos])
+#define PCV(parser) parser_value((parser), (parser)->pos)
+#define PCA(parser) parser_atom((parser), (parser)->pos)
+#define PCL(parser) lexer_line((parser)->lexer, (parser)->tokens->offset[(parser)->pos])
+#define PCC(parser) lexer_column((parser)->lexer, (parser)->tokens->offset[(parser)->pos])
+
 #define PER(parser) ((parser)->root_scope += 1)
 #define PEN(parser) ((parser)->nest += 1)
 
@@ -47,16 +95,12 @@ int parse_accspec(Parser* parser, bool expect_further);
 ASTN_Literal parser_parse_literal(Parser* parser);
 ASTN_DataTypeSpecifier parser_parse_dt_spec(Parser* parser, bool expect_further);
 
-ASTN_Call parser_parse_call(Parser* parser, uint8_t scopeOS);
-ASTN_PrimaryExpr parser_parse_prim_expr(Parser* parser, uint8_t scopeOS);
-ASTN_FactorExpr parser_parse_factor_expr(Parser* parser, uint8_t scopeOS);
-ASTN_TermExpr parser_parse_term_expr(Parser* parser, uint8_t scopeOS);
-ASTN_MultiplicationExpr parser_parse_mult_expr(Parser* parser, uint8_t scopeOS);
-ASTN_AdditionExpr parser_parse_add_expr(Parser* parser, uint8_t scopeOS);
-ASTN_BitwiseExpr parser_parse_bitw_expr(Parser* parser, uint8_t scopeOS);
-ASTN_ComparisonExpr parser_parse_comp_expr(Parser* parser, uint8_t scopeOS);
-ASTN_Expression* parser_parse_expression(Parser* parser, uint8_t scopeOS);
-AST_Node* parser_parse_expr(Parser* parser, uint8_t scopeOS);
+ASTN_Call parser_parse_call(Parser* parser);
+ASTN_ExprRef parser_parse_prim_expr(Parser* parser);
+ASTN_ExprRef parser_parse_factor_expr(Parser* parser);
+ASTN_ExprRef parser_parse_binary_expr(Parser* parser, uint8_t min_prec);
+ASTN_ExprRef parser_parse_expression(Parser* parser);
+AST_Node* parser_parse_expr(Parser* parser);
 
 ASTN_Parameter* parser_parse_parameter(Parser* parser);
 ASTN_Parameters* parser_parse_parameters(Parser* parser);
@@ -67,7 +111,7 @@ AST_Node* parser_parse_import(Parser* parser);
 AST_Node* parser_parse_attr_decl(Parser* parser);
 // void parser_parse_extend_attr(Parser* parser, ASTN_AttributeList* src, ASTN_AttributeList* dest);
 
-ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS);
+ASTN_VariableDecl parser_parse_var_decl(Parser* parser);
 AST_Node* parser_parse_function_decl(Parser* parser);
 
 ASTN_StructMemberDecl parser_parse_struct_mem(Parser* parser);
@@ -79,16 +123,16 @@ AST_Node* parser_parse_err_decl(Parser* parser);
 
 AST_Node* parser_parse_enum_decl(Parser* parser);
 
-ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS);
-ASTN_ForStm parser_parse_for_stm(Parser* parser, uint8_t scopeOS);
-ASTN_SwitchStm parser_parse_switch_stm(Parser* parser, uint8_t scopeOS);
-ASTN_TryStm parser_parse_try_stm(Parser* parser, uint8_t scopeOS);
-ASTN_WhileStm parser_parse_while_stm(Parser* parser, uint8_t scopeOS);
-ASTN_ReturnStm parser_parse_return_stm(Parser* parser, uint8_t scopeOS);
-ASTN_ThrowStm parser_parse_throw_stm(Parser* parser, uint8_t scopeOS);
+ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser);
+ASTN_ForStm parser_parse_for_stm(Parser* parser);
+ASTN_SwitchStm parser_parse_switch_stm(Parser* parser);
+ASTN_TryStm parser_parse_try_stm(Parser* parser);
+ASTN_WhileStm parser_parse_while_stm(Parser* parser);
+ASTN_ReturnStm parser_parse_return_stm(Parser* parser);
+ASTN_ThrowStm parser_parse_throw_stm(Parser* parser);
 
-ASTN_Statement parser_parse_statement(Parser* parser, uint8_t scopeOS);
-ASTN_Statements* parser_parse_statements(Parser* parser, uint8_t scopeOS);
+ASTN_Statement parser_parse_statement(Parser* parser);
+ASTN_Statements* parser_parse_statements(Parser* parser);
 
 AST_Node* parser_parse_mep_decl(Parser* parser);
 
@@ -0,0 +1,26 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// byte-run scanners used by the lexer; each returns the # of leading bytes of buf[0..n)
+// that belong to the run (n if the whole range does). Kernels never read past buf + n
+
+typedef size_t (*ScanFn)(const char* buf, size_t n);
+
+typedef struct Scanner {
+    const char* isa; // name of the selected implementation ("avx2", "sse2" or "scalar")
+    ScanFn blanks; // ' ', '\t', '\r'
+    ScanFn iden; // [A-Za-z0-9_]
+    ScanFn digits; // [0-9]
+    ScanFn string; // anything but '"', '\\' and '\0'
+    ScanFn line; // anything but the line breaks '\n' and '\v'
+} Scanner;
+
+extern Scanner scanner;
+
+void scan_init(void);
+bool scan_use(const char* isa);
+
+#endif // SCAN_H
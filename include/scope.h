@@ -0,0 +1,49 @@
+#ifndef SCOPE_H
+#define SCOPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// tree of the scopes of a compilation: every scope gets a dense 32-bit id indexing its entry,
+// which links it to the scope enclosing it, so the enclosing scope (and its depth) of any
+// scope is one load away. Ids are handed out in runs (one per declaration, see scope_reserve),
+// so a declaration numbers its scopes the same way whichever thread parses it; 0 is the top level
+
+typedef uint32_t ScopeId;
+
+enum ScopeKind {
+    SCOPE_ROOT, // top level (id 0)
+    SCOPE_DECL, // a top-level declaration's own
+    SCOPE_FUNCTION,
+    SCOPE_ATTR,
+    SCOPE_CLASS,
+    SCOPE_ERR,
+    SCOPE_BRANCH, // if, elif and else
+    SCOPE_LOOP, // for and while
+    SCOPE_SWITCH,
+    SCOPE_TRY // try, except and finally
+};
+
+typedef struct Scope {
+    ScopeId parent; // scope enclosing it (the top level is its own)
+    uint16_t depth; // # of scopes enclosing it
+    uint8_t kind; // enum ScopeKind; SCOPE_ROOT while reserved but not opened
+} Scope;
+
+typedef struct ScopeTree {
+    Scope* scopes; // by id
+    size_t size; // ids below it are reserved
+    size_t capacity;
+} ScopeTree;
+
+ScopeTree* scope_init();
+void scope_free(ScopeTree* tree);
+
+ScopeId scope_reserve(ScopeTree* tree, size_t count);
+void scope_open(ScopeTree* tree, ScopeId id, ScopeId parent, uint8_t kind);
+
+ScopeId scope_parent(ScopeTree* tree, ScopeId id);
+uint16_t scope_depth(ScopeTree* tree, ScopeId id);
+uint8_t scope_kind(ScopeTree* tree, ScopeId id);
+
+#endif // SCOPE_H
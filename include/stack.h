@@ -3,17 +3,18 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct Stack {
-    __uint128_t* data;
+    uint32_t* data;
     size_t size;
     size_t capacity;
 } Stack;
 
 Stack* stack_init();
-void stack_push(Stack* stack, __uint128_t value);
-__uint128_t stack_pop(Stack* stack);
-__uint128_t stack_peek(Stack* stack);
+void stack_push(Stack* stack, uint32_t value);
+uint32_t stack_pop(Stack* stack);
+uint32_t stack_peek(Stack* stack);
 bool stack_is_empty(Stack* stack);
 void stack_free(Stack* stack);
 
@@ -3,14 +3,19 @@
 
 #include "token.h"
 #include "ast.h"
+#include "intern.h"
+#include "scope.h"
+#include "stack.h"
 
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdlib.h>
 
 typedef struct Symbol {
     struct {
-        int32_t id; 
-        unsigned int scope, nest;
+        uint32_t atom; // interned name; a symbol is known by its atom and scope
+        ScopeId scope;
+        unsigned int nest;
         uint8_t mem_type, mem_mod, mem_sto, access_type;
         
         enum SymbolType {
@@ -24,6 +29,7 @@ typedef struct Symbol {
             SYMBOL_ATTR,
             SYMBOL_ERR
         } type;
+        uint32_t owner; // stamp of the top-level declaration that declared it (ParserSpan.owner)
         
         AST_Node* data;
 
@@ -36,21 +42,77 @@ typedef struct Symbol {
         int decl_col;
     } data;
     struct Symbol* next;
+    struct Symbol* shadow; // symbol of the same name it hides while bound in an open scope
 } Symbol;
 
+#define SYMBOL_IDEN(symb) ((ASTN_Iden){ (symb)->data.atom, (symb)->data.scope })
+
+#define SYMTBL_SHARDS 16 // tables an index is split over by hash, each behind its own lock
+
+// slot of an index shard; linear probing keyed by atom and scope, emptied only by symtbl_index
+// (symtbl_remove leaves its key, so probes go on past it and the key can take it again)
+typedef struct SymSlot {
+    uint32_t atom;
+    ScopeId scope;
+    Symbol* symbol; // NULL while empty, SYMTBL_REMOVED once removed; stored after the key, so a reader that sees it sees the key
+} SymSlot;
+
+typedef struct SymSlots {
+    size_t capacity; // power of 2, kept at most 3/4 full
+    struct SymSlots* retired; // slots the shard outgrew, kept for readers still probing them
+    SymSlot slot[];
+} SymSlots;
+
+typedef struct SymShard {
+    pthread_mutex_t lock; // taken to add or remove (lookups take no lock)
+    SymSlots* slots;
+    size_t size;
+    size_t removed; // slots holding a removed key (taken back by the key or dropped on growth)
+} SymShard;
+
+// first symbol of each key, looked up and added to from any # of threads at once
+typedef struct SymIndex {
+    SymShard shards[SYMTBL_SHARDS];
+} SymIndex;
+
 typedef struct SymTable {
-    Symbol* symbol;
+    Symbol* symbol; // symbols added to this table, in declaration order
+    Symbol* last;
+    SymIndex* index;
+    struct SymTable* owner; // table whose index this one adds to (see symtbl_init_shared); NULL if its own
+
+    // scopes open while parsing: the innermost symbol bound under each atom, whose shadow chain
+    // leads out through the ones it hides
+    Symbol** visible; // by atom; NULL where none is bound
+    size_t visible_size;
+    Stack* bound; // atoms of the symbols bound in the open scopes, innermost last
+    Stack* frames; // size of bound as each open scope was entered
 } SymTable;
 
 
 SymTable* symtbl_init();
+SymTable* symtbl_init_shared(SymTable* owner);
 void symtbl_free(SymTable* table);
-Symbol* symbol_init(char* id, unsigned int type, unsigned int scope, unsigned int nest, uint8_t mem_type, 
-    uint8_t mem_mod, uint8_t mem_sto, uint8_t  access_type, uint8_t decl_line, uint8_t decl_col);
+void symtbl_release(SymTable* table);
+Symbol* symbol_init(uint32_t atom, unsigned int type, ScopeId scope, unsigned int nest, uint8_t mem_type, 
+    uint8_t mem_mod, uint8_t mem_sto, uint8_t  access_type, unsigned int decl_line, unsigned int decl_col);
+
+Symbol* symtbl_add(SymTable* table, Symbol* symbol);
+void symtbl_remove(SymTable* table, Symbol* symbol);
+void symtbl_index(SymTable* table);
+Symbol* symtbl_detach(SymTable* table, Symbol** last);
+
+void symtbl_enter(SymTable* table);
+void symtbl_bind(SymTable* table, Symbol* symbol);
+void symtbl_leave(SymTable* table, size_t depth);
+size_t symtbl_depth(SymTable* table);
+size_t symtbl_bound(SymTable* table, Symbol** symbols);
 
-Symbol* symtbl_lookup(SymTable* table, char* id,  unsigned int scope, uint8_t scope_offset);
+Symbol* symtbl_lookup(SymTable* table, uint32_t atom);
+Symbol* symtbl_find(SymTable* table, uint32_t atom, ScopeId scope);
+size_t symtbl_size(SymTable* table);
 
-int32_t symtbl_hash(const char* key, unsigned int scope);
+uint64_t symtbl_hash(uint32_t atom, ScopeId scope);
 void symtbl_borrowsym(SymTable* table, Symbol* symbol, Symbol* borrower);
 
 #endif // SYMTBL_H
\ No newline at end of file
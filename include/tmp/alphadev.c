@@ -6,7 +6,11 @@ void print_indent(int indent_level) {
     }
 }
 
-void print_ast_node(AST_Node* node, int indent_level) {
+void print_iden(ASTN_Iden iden) {
+    printf("%s@%u", intern_name(iden.atom), iden.scope);
+}
+
+void print_ast_node(ASTN_ExprPool* exprs, AST_Node* node, int indent_level) {
     if (!node) return;
 
     print_indent(indent_level);
@@ -22,10 +26,11 @@ void print_ast_node(AST_Node* node, int indent_level) {
                     printf("Variable Declaration (symb: ");
                     if (node->data.stm.data.variable_decl.iden.mult.size) {
                         for (int i = 0; i < node->data.stm.data.variable_decl.iden.mult.size; i++) {
-                            printf("%i, ", node->data.stm.data.variable_decl.iden.mult.items[i]);
+                            print_iden(node->data.stm.data.variable_decl.iden.mult.items[i]);
+                            printf(", ");
                         }
                     } else {
-                        printf("%i", node->data.stm.data.variable_decl.iden.sg);
+                        print_iden(node->data.stm.data.variable_decl.iden.sg);
                     }
 
                     printf(")\n");
@@ -33,22 +38,29 @@ void print_ast_node(AST_Node* node, int indent_level) {
                     break;
                 case STMT_FUNCTION_DECL:
                     print_indent(indent_level + 2);
-                    printf("Function Declaration (symb id: %i)\n", node->data.stm.data.function_decl.identifier);
+                    printf("Function Declaration (symb: ");
+                    print_iden(node->data.stm.data.function_decl.identifier);
+                    printf(")\n");
                     print_indent(indent_level + 3);
                     
-                    printf("Parameters: %zu\n", node->data.stm.data.function_decl.parameters->size);
+                    printf("Parameters: %u\n", node->data.stm.data.function_decl.parameters->size);
 
                     for (int i = 0; i < node->data.stm.data.function_decl.parameters->size; i++) {
                         print_indent(indent_level + 4);
-                        printf("%i: %s \n", (i + 1), node->data.stm.data.function_decl.parameters->parameter[i]->identifier);
+                        printf("%i: %s \n", (i + 1), AST_VEC_ITEMS(*node->data.stm.data.function_decl.parameters)[i]->identifier);
                     }
 
                     print_indent(indent_level + 3);
 
-                    printf("Statements: %zu\n", node->data.stm.data.function_decl.statements->size);
+                    if (node->data.stm.data.function_decl.body) {
+                        printf("Statements: not parsed (tokens %zu to %zu)\n", node->data.stm.data.function_decl.body->start, node->data.stm.data.function_decl.body->end);
+                        break;
+                    }
+
+                    printf("Statements: %u\n", node->data.stm.data.function_decl.statements->size);
 
                     for (int i = 0; i < node->data.stm.data.function_decl.statements->size; i++) {
-                        print_ast_node(node->data.stm.data.function_decl.statements->statement[i], indent_level + 4);
+                        print_ast_node(exprs, AST_VEC_ITEMS(*node->data.stm.data.function_decl.statements)[i], indent_level + 4);
                     }
 
                     break;
@@ -59,18 +71,19 @@ void print_ast_node(AST_Node* node, int indent_level) {
                     printf("Modules:\n");
                     print_indent(indent_level + 3);
                     for (int i = 0; i < node->data.stm.data.import_decl.modules.size; i++) {
-                        printf("%i: %s ", (i+1), node->data.stm.data.import_decl.modules.items[i]->module);
+                        printf("%i: %s ", (i+1), AST_VEC_ITEMS(node->data.stm.data.import_decl.modules)[i]->module);
                     }
                     printf("\n");
                     break;
                 case STMT_EXPRESSION:
                     print_indent(indent_level + 2);
                     printf("Expression\n");
+                    print_expr(exprs, node->data.stm.data.expression, indent_level + 2);
                     break;
                 case STMT_RETURN:
                     print_indent(indent_level + 2);
                     printf("Return Statement\n");
-                    print_ast_node(node->data.stm.data.return_stm.expr, indent_level + 2);
+                    print_expr(exprs, node->data.stm.data.return_stm.expr, indent_level + 2);
                     break;
                 case STMT_ATTR_DECL:
                     print_indent(indent_level + 2);
@@ -106,78 +119,41 @@ void print_ast_node(AST_Node* node, int indent_level) {
                     break;
             }
             break;
-        case EXPR:
-            print_indent(indent_level + 1);
-            printf("Expression Type: %d\n", node->data.expr.type);
-            switch (node->data.expr.type) {
-                case EXPR_LITERAL:
-                    print_indent(indent_level + 2);
-                    printf("Literal\n");
-                    break;
-                case EXPR_IDENTIFIER:
-                    print_indent(indent_level + 2);
-                    printf("Identifier: %i\n", node->data.expr.data.identifier);
-                    break;
-                case EXPR_FUNCTION_CALL:
-                    print_indent(indent_level + 2);
-                    printf("Function Call\n");
-                    break;
-                case EXPR_NEST:
-                    print_indent(indent_level + 2);
-                    printf("Nested Expression\n");
-                    break;
-                case EXPR_FACTOR:
-                    print_indent(indent_level + 2);
-                    printf("Factor\n");
-                    break;
-                case EXPR_TERM:
-                    print_indent(indent_level + 2);
-                    printf("Term\n");
-                    break;
-                case EXPR_MULTIPLICATION:
-                    print_indent(indent_level + 2);
-                    printf("Multiplication\n");
-                    break;
-                case EXPR_ADDITION:
-                    print_indent(indent_level + 2);
-                    printf("Addition\n");
-                    break;
-                case EXPR_BITWISE:
-                    print_indent(indent_level + 2);
-                    printf("Bitwise Operation\n");
-                    break;
-                case EXPR_COMPARISON:
-                    print_indent(indent_level + 2);
-                    printf("Comparison\n");
-                    break;
-                default:
-                    print_indent(indent_level + 2);
-                    printf("Unknown Expression Type\n");
-                    break;
-            }
-            break;
         case ROOT:
             print_indent(indent_level + 1);
             printf("Root Node\n");
+
+            print_indent(indent_level + 2);
+            printf("Declarations: %u\n", node->data.root.size);
+
+            for (size_t i = 0; i < node->data.root.size; i++) {
+                print_ast_node(exprs, AST_VEC_ITEMS(node->data.root)[i], indent_level + 3);
+            }
+
             break;
         case MEP:
             print_indent(indent_level + 1);
             printf("MEP\n");
 
             print_indent(indent_level + 2);
-            printf("Parameters: %zu\n", node->data.mep.parameters->size);
+            printf("Parameters: %u\n", node->data.mep.parameters->size);
 
             for (int i = 0; i < node->data.mep.parameters->size; i++) {
                 print_indent(indent_level + 3);
-                printf("%i: %s \n", (i + 1), node->data.mep.parameters->parameter[i]->identifier);
+                printf("%i: %s \n", (i + 1), AST_VEC_ITEMS(*node->data.mep.parameters)[i]->identifier);
             }
 
             print_indent(indent_level + 2);
 
-            printf("Statements: %zu\n", node->data.mep.statements->size);
+            if (node->data.mep.body) {
+                printf("Statements: not parsed (tokens %zu to %zu)\n", node->data.mep.body->start, node->data.mep.body->end);
+                break;
+            }
+
+            printf("Statements: %u\n", node->data.mep.statements->size);
 
             for (int i = 0; i < node->data.mep.statements->size; i++) {
-                print_ast_node(node->data.mep.statements->statement[i], indent_level + 3);
+                print_ast_node(exprs, AST_VEC_ITEMS(*node->data.mep.statements)[i], indent_level + 3);
             }
 
             break;
@@ -191,17 +167,80 @@ void print_ast_node(AST_Node* node, int indent_level) {
     if (node->left) {
         print_indent(indent_level + 1);
         printf("Left:\n");
-        print_ast_node(node->left, indent_level + 2);
+        print_ast_node(exprs, node->left, indent_level + 2);
     }
     if (node->parent) {
         print_indent(indent_level + 1);
         printf("Parent:\n");
-        print_ast_node(node->left, indent_level + 2);
+        print_ast_node(exprs, node->left, indent_level + 2);
     }
     if (node->right) {
         print_indent(indent_level + 1);
         printf("Right:\n");
-        print_ast_node(node->right, indent_level + 2);
+        print_ast_node(exprs, node->right, indent_level + 2);
+    }
+}
+
+
+
+void print_expr(ASTN_ExprPool* exprs, ASTN_ExprRef ref, int indent_level) {
+    if (!ref) return;
+
+    ASTN_ExprNode* expr = AST_EXPR(exprs, ref);
+
+    print_indent(indent_level + 1);
+    printf("Expression Type: %d\n", expr->type);
+    switch (expr->type) {
+        case EXPR_LITERAL:
+            print_indent(indent_level + 2);
+            printf("Literal\n");
+            break;
+        case EXPR_IDENTIFIER:
+            print_indent(indent_level + 2);
+            printf("Identifier: ");
+            print_iden(expr->data.identifier);
+            printf("\n");
+            break;
+        case EXPR_FUNCTION_CALL:
+            print_indent(indent_level + 2);
+            printf("Function Call\n");
+            break;
+        case EXPR_NEST:
+            print_indent(indent_level + 2);
+            printf("Nested Expression\n");
+            break;
+        case EXPR_FACTOR:
+            print_indent(indent_level + 2);
+            printf("Factor\n");
+            break;
+        case EXPR_POSTFIX:
+            print_indent(indent_level + 2);
+            printf("Postfix\n");
+            break;
+        case EXPR_TERM:
+            print_indent(indent_level + 2);
+            printf("Term\n");
+            break;
+        case EXPR_MULTIPLICATION:
+            print_indent(indent_level + 2);
+            printf("Multiplication\n");
+            break;
+        case EXPR_ADDITION:
+            print_indent(indent_level + 2);
+            printf("Addition\n");
+            break;
+        case EXPR_BITWISE:
+            print_indent(indent_level + 2);
+            printf("Bitwise Operation\n");
+            break;
+        case EXPR_COMPARISON:
+            print_indent(indent_level + 2);
+            printf("Comparison\n");
+            break;
+        default:
+            print_indent(indent_level + 2);
+            printf("Unknown Expression Type\n");
+            break;
     }
 }
 
@@ -213,8 +252,8 @@ void print_symb_tbl(Symbol* cur) {
            "ID", "Scope", "Nest", "Mem Type", "Mem Mod", "Mem Sto", "Access Type", "Type", "Line", "Col");
     printf("---------------------------------------------------------------------------------------------------------------------\n");
     while (cur != NULL) {
-        printf("| %-15d | %-5u | %-4u | %-10d | %-8d | %-9d | %-11d | %-10s | %-5d | %-5d |\n", 
-               cur->data.id, cur->data.scope, cur->data.nest, cur->data.mem_type, cur->data.mem_mod, cur->data.mem_sto, 
+        printf("| %-15s | %-5u | %-4u | %-10d | %-8d | %-9d | %-11d | %-10s | %-5d | %-5d |\n", 
+               intern_name(cur->data.atom), cur->data.scope, cur->data.nest, cur->data.mem_type, cur->data.mem_mod, cur->data.mem_sto, 
                cur->data.access_type, 
                cur->data.type == SYMBOL_ATTR ? "Attribute" : 
                cur->data.type == SYMBOL_VARIABLE ? "Variable" : 
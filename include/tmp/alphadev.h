@@ -13,7 +13,9 @@
 #define PRINT_SYMB_TBL print_symb_tbl
 
 
-void print_ast_node(AST_Node* node, int indent_level);
+void print_iden(ASTN_Iden iden);
+void print_ast_node(ASTN_ExprPool* exprs, AST_Node* node, int indent_level);
+void print_expr(ASTN_ExprPool* exprs, ASTN_ExprRef ref, int indent_level);
 void print_symb_tbl(Symbol* cur);
 
 #endif // ALPHADEV_H
\ No newline at end of file
@@ -2,17 +2,80 @@
 #define TOKEN_H
 
 #include "p_info.h"
+#include "memory.h"
+
+#include <stddef.h>
+#include <stdint.h>
 
 #define NO_OF_KEYWORDS 45
-#define KEYWORDS keywords
-#define MAX_KEYWORD_LEN 7
+#define MAX_KEYWORD_LEN 8
+
+// perfect hash over the keyword list (first char, last char, length); constants were searched
+// so that no two keywords share a slot (the lexer refuses to start if two do; see lexer::keywords)
+#define KEYWORD_TABLE_SIZE 128
+#define KEYWORD_HASH(first, last, len) \
+    ((2u * (unsigned char)(first) + 24u * (unsigned char)(last) + 9u * (unsigned)(len)) & (KEYWORD_TABLE_SIZE - 1))
+
+// every keyword with its token type, as X(name, type) for the macro provided (name is a string
+// literal, so its first char, last char and length come from it)
+#define KEYWORD_LIST(X) \
+    X("as", TOK_AS) \
+    X("attr", TOK_ATTR) \
+    X("bool", TOK_BOOL) \
+    X("char", TOK_CHAR) \
+    X("class", TOK_CLASS) \
+    X("const", TOK_CONST) \
+    X("double", TOK_DOUBLE) \
+    X("enum", TOK_ENUM) \
+    X("ext", TOK_EXT) \
+    X("false", TOK_FALSE) \
+    X("float", TOK_FLOAT) \
+    X("fn", TOK_FN) \
+    X("from", TOK_FROM) \
+    X("glob", TOK_GLOB) \
+    X("import", TOK_IMPORT) \
+    X("int", TOK_INT) \
+    X("l_long", TOK_L_LONG) \
+    X("long", TOK_LONG) \
+    X("mut", TOK_MUT) \
+    X("priv", TOK_PRIV) \
+    X("pub", TOK_PUB) \
+    X("return", TOK_RETURN) \
+    X("short", TOK_SHORT) \
+    X("s_short", TOK_S_SHORT) \
+    X("size", TOK_SIZE) \
+    X("str", TOK_STRING) \
+    X("struct", TOK_STRUCT) \
+    X("true", TOK_TRUE) \
+    X("uint", TOK_UINT) \
+    X("var", TOK_VAR) \
+    X("if", TOK_IF) \
+    X("elif", TOK_ELIF) \
+    X("else", TOK_ELSE) \
+    X("for", TOK_FOR) \
+    X("while", TOK_WHILE) \
+    X("switch", TOK_SWITCH) \
+    X("case", TOK_CASE) \
+    X("try", TOK_TRY) \
+    X("except", TOK_EXCEPT) \
+    X("finally", TOK_FINALLY) \
+    X("break", TOK_BREAK) \
+    X("continue", TOK_CONTINUE) \
+    X("err", TOK_ERR) \
+    X("throw", TOK_THROW) \
+    X("default", TOK_DEFAULT)
 
 #define IS_LITERAL(type) \
     ((type) >= TOK_L_SSINT && (type) <= TOK_L_SIZE)
 
+#define IS_INT_LITERAL(type) \
+    ((type) >= TOK_L_SSINT && (type) <= TOK_L_LLUINT)
+
 typedef struct Token {
-    unsigned int line, col;
-    char* value;
+    size_t offset, len; // view into the lexer buffer; line and column resolve lazily from offset
+    char* value; // text in the lexer's arena; NULL until materialized (set by the lexer only for escaped/separated literals)
+    __uint128_t num; // parsed value of integer literals (two's complement for the signed types)
+    uint32_t atom; // interned name of identifiers (see intern_atom); 0 for every other token
     enum TokenType {
         // Special tokens
         TOK_ERROR,              // Error token
@@ -125,4 +188,25 @@ typedef struct Token {
     } type;
 } Token;
 
+// structure-of-arrays token stream produced by lexer_tokenize_all; index i of every array
+// describes the i-th token, the last token is always TOK_EOF
+typedef struct TokenStream {
+    const char* buf; // source the offsets point into
+    size_t size; // # of tokens
+    size_t capacity;
+
+    uint8_t* type;
+    size_t* offset;
+    uint32_t* len;
+    char** value; // text in the lexer's or the stream's arena; NULL until materialized (see Token.value)
+    uint32_t* atom; // see Token.atom
+    Arena arena; // values materialized by token_stream_value
+
+    // parsed values of the integer literals only, kept apart so other tokens don't pay for them
+    size_t nums; // # of integer literals
+    size_t nums_capacity;
+    size_t* num_index; // token index of each integer literal (ascending)
+    __uint128_t* num; // value of each integer literal (see Token.num)
+} TokenStream;
+
 #endif // TOKEN_H
\ No newline at end of file
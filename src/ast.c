@@ -1,17 +1,633 @@
 #include "ast.h"
+#include "token.h"
+#include "intern.h"
 
-AST_Node* ast_init(int type) {
-    AST_Node* node = calloc(1, sizeof(AST_Node));
+#include <string.h>
+
+AST_Node* ast_init(Arena* arena, int type) {
+    /*
+    Allocates a zeroed node out of provided arena; nodes are never freed on their own, the
+    whole tree goes with arena_free
+    return: pointer to the node
+    */
+
+    AST_Node* node = arena_calloc(arena, 1, sizeof(AST_Node));
 
     node->type = type;
-    
-    if (type == ROOT) {
-        node->data.root = true;
-    }
 
     return node;
 }
 
-void ast_free(AST_Node* node) {
-    free(node);
-}
\ No newline at end of file
+void ast_vec_reserve(Arena* arena, uint32_t* capacity, void* items, size_t size, size_t count, size_t item_size, size_t small) {
+    /*
+    Makes room for provided # of items in a vector (see AST_VEC) holding size items: spills its
+    inline items into the arena once they don't fit, doubling the spilled array after that (the
+    old copy stays in the arena until arena_free)
+    */
+
+    size_t fits = (*capacity) ? *capacity : small;
+
+    if (count <= fits) {
+        return;
+    }
+
+    size_t grown = (fits * 2 > 4) ? fits * 2 : 4;
+
+    while (grown < count) {
+        grown *= 2;
+    }
+
+    if (grown > UINT32_MAX) {
+        exit(EXIT_FAILURE);
+    }
+
+    void* heap = arena_alloc(arena, grown * item_size);
+
+    // (the heap pointer overlaps the inline items, so they're copied out before it's set)
+    memcpy(heap, (*capacity) ? *(void**)items : items, size * item_size);
+    *(void**)items = heap;
+    *capacity = (uint32_t)grown;
+}
+
+static void* ast_pool_reserve(void* items, size_t* capacity, size_t size, size_t count, size_t item_size) {
+    /*
+    Makes room for provided # of items more in a pool array, doubling its capacity until they fit
+    return: pointer to the (possibly moved) array
+    */
+
+    if (size + count <= *capacity) {
+        return items;
+    }
+
+    while (*capacity < size + count) {
+        *capacity = (*capacity > 0) ? *capacity * 2 : 64;
+    }
+
+    items = realloc(items, *capacity * item_size);
+
+    if (!items) {
+        exit(EXIT_FAILURE);
+    }
+
+    return items;
+}
+
+void ast_pool_init(ASTN_ExprPool* pool) {
+    /*
+    Initializes an empty expression pool (with the reserved node 0)
+    */
+
+    *pool = (ASTN_ExprPool){0};
+    ast_expr_init(pool, EXPR_PRIMARY, 0);
+}
+
+void ast_pool_free(ASTN_ExprPool* pool) {
+    /*
+    Releases every expression of the pool at once
+    */
+
+    free(pool->nodes);
+    free(pool->literals);
+    free(pool->calls);
+    free(pool->args);
+    free(pool->scratch);
+    free(pool->hashes);
+    free(pool->shared);
+
+    *pool = (ASTN_ExprPool){0};
+}
+
+ASTN_ExprRef ast_expr_init(ASTN_ExprPool* pool, uint8_t type, uint8_t op) {
+    /*
+    Appends a zeroed expression of provided type to the pool
+    return: its index
+    */
+
+    pool->nodes = ast_pool_reserve(pool->nodes, &pool->capacity, pool->size, 1, sizeof(ASTN_ExprNode));
+
+    ASTN_ExprNode* node = &pool->nodes[pool->size];
+    *node = (ASTN_ExprNode){0};
+    node->type = type;
+    node->op = op;
+
+    if (pool->cons) {
+        pool->hashes = ast_pool_reserve(pool->hashes, &pool->hashes_capacity, pool->size, 1, sizeof(uint64_t));
+        pool->hashes[pool->size] = 0;
+    }
+
+    return (ASTN_ExprRef)pool->size++;
+}
+
+void ast_pool_cons(ASTN_ExprPool* pool) {
+    /*
+    Turns hash-consing on for the expressions built from now on (those already in the pool are
+    never shared)
+    */
+
+    if (pool->cons) {
+        return;
+    }
+
+    pool->cons = true;
+    pool->hashes = ast_pool_reserve(pool->hashes, &pool->hashes_capacity, 0, pool->size, sizeof(uint64_t));
+    memset(pool->hashes, 0, pool->size * sizeof(uint64_t));
+}
+
+static uint64_t ast_mix(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 29);
+}
+
+static uint64_t ast_literal_hash(ASTN_Literal* lit) {
+    /*
+    Hashes the type and value of a literal (only the field its type fills)
+    return: the hash
+    */
+
+    uint64_t hash = ast_mix(0, (uint64_t)lit->type);
+
+    if (IS_INT_LITERAL(lit->type)) {
+        // (signed literals fill the same bits through int_)
+        return ast_mix(ast_mix(hash, (uint64_t)lit->value.uint.bit128), (uint64_t)(lit->value.uint.bit128 >> 64));
+    }
+
+    switch (lit->type) {
+        case TOK_L_FLOAT: {
+            uint32_t bits;
+            memcpy(&bits, &lit->value.float_.bit32, sizeof(bits));
+            return ast_mix(hash, bits);
+        }
+        case TOK_L_DOUBLE: {
+            uint64_t bits;
+            memcpy(&bits, &lit->value.float_.bit64, sizeof(bits));
+            return ast_mix(hash, bits);
+        }
+        case TOK_L_CHAR:
+            return ast_mix(hash, (uint8_t)lit->value.character);
+        case TOK_L_STRING:
+            for (const char* c = lit->value.string; c && *c; c++) {
+                hash = ast_mix(hash, (uint8_t)*c);
+            }
+            return hash;
+        case TOK_L_BOOL:
+            return ast_mix(hash, (uint64_t)lit->value.boolean);
+        case TOK_L_SIZE:
+            return ast_mix(hash, (uint64_t)lit->value.size);
+        default:
+            return hash;
+    }
+}
+
+static bool ast_literal_eq(ASTN_Literal* a, ASTN_Literal* b) {
+    if (a->type != b->type) {
+        return false;
+    }
+
+    if (IS_INT_LITERAL(a->type)) {
+        return a->value.uint.bit128 == b->value.uint.bit128;
+    }
+
+    switch (a->type) {
+        case TOK_L_FLOAT:
+            return memcmp(&a->value.float_.bit32, &b->value.float_.bit32, sizeof(float)) == 0;
+        case TOK_L_DOUBLE:
+            return memcmp(&a->value.float_.bit64, &b->value.float_.bit64, sizeof(double)) == 0;
+        case TOK_L_CHAR:
+            return a->value.character == b->value.character;
+        case TOK_L_STRING:
+            return a->value.string == b->value.string ||
+                (a->value.string && b->value.string && strcmp(a->value.string, b->value.string) == 0);
+        case TOK_L_BOOL:
+            return a->value.boolean == b->value.boolean;
+        case TOK_L_SIZE:
+            return a->value.size == b->value.size;
+        default:
+            return true;
+    }
+}
+
+static bool ast_is_unary(uint8_t type) {
+    return type == EXPR_FACTOR || type == EXPR_NEST || type == EXPR_POSTFIX;
+}
+
+static bool ast_is_binary(uint8_t type) {
+    return type == EXPR_TERM || type == EXPR_MULTIPLICATION || type == EXPR_ADDITION ||
+        type == EXPR_BITWISE || type == EXPR_COMPARISON;
+}
+
+static uint64_t ast_node_hash(ASTN_ExprPool* pool, ASTN_ExprNode* node) {
+    /*
+    Hashes a node from its type, operator and payload, operands by their own hashes (so equal
+    trees hash alike wherever their nodes lie in the pool)
+    return: the hash; 0 if an operand isn't shared or the node can't be
+    */
+
+    uint64_t hash = ast_mix(0, ((uint64_t)node->type << 8) | node->op);
+
+    if (node->type == EXPR_IDENTIFIER) {
+        // (atoms are numbered in the order names are first seen; the name's own hash isn't)
+        hash = ast_mix(ast_mix(hash, intern_hash(node->data.identifier.atom)), node->data.identifier.scope);
+    } else if (node->type == EXPR_LITERAL) {
+        hash = ast_mix(hash, ast_literal_hash(&pool->literals[node->data.literal]));
+    } else if (ast_is_unary(node->type)) {
+        uint64_t operand = pool->hashes[node->data.unary_op.expr];
+
+        if (!operand) {
+            return 0;
+        }
+
+        hash = ast_mix(hash, operand);
+    } else if (ast_is_binary(node->type)) {
+        uint64_t left = pool->hashes[node->data.binary_op.left];
+        uint64_t right = pool->hashes[node->data.binary_op.right];
+
+        if (!left || !right) {
+            return 0;
+        }
+
+        hash = ast_mix(ast_mix(hash, left), right);
+    } else {
+        return 0;
+    }
+
+    return (hash) ? hash : 1;
+}
+
+static bool ast_node_eq(ASTN_ExprPool* pool, ASTN_ExprNode* a, ASTN_ExprNode* b) {
+    // (operands are shared already, so equal ones are the same node)
+    if (a->type != b->type || a->op != b->op) {
+        return false;
+    }
+
+    if (a->type == EXPR_IDENTIFIER) {
+        return AST_IDEN_EQ(a->data.identifier, b->data.identifier);
+    } else if (a->type == EXPR_LITERAL) {
+        return ast_literal_eq(&pool->literals[a->data.literal], &pool->literals[b->data.literal]);
+    } else if (ast_is_unary(a->type)) {
+        return a->data.unary_op.expr == b->data.unary_op.expr;
+    }
+
+    return a->data.binary_op.left == b->data.binary_op.left && a->data.binary_op.right == b->data.binary_op.right;
+}
+
+static ASTN_ExprRef ast_shared_find(ASTN_ExprPool* pool, ASTN_ExprRef ref, size_t* slot) {
+    /*
+    Looks for a shared node equal to provided one
+    return: the shared node (0 if there's none, slot then being where it'd go)
+    */
+
+    size_t mask = pool->shared_capacity - 1;
+    size_t i = (size_t)pool->hashes[ref] & mask;
+
+    for (; pool->shared[i]; i = (i + 1) & mask) {
+        ASTN_ExprRef other = pool->shared[i];
+
+        if (pool->hashes[other] == pool->hashes[ref] && ast_node_eq(pool, &pool->nodes[other], &pool->nodes[ref])) {
+            return other;
+        }
+    }
+
+    *slot = i;
+
+    return 0;
+}
+
+static void ast_shared_grow(ASTN_ExprPool* pool) {
+    /*
+    Makes room for one more shared node, keeping the table at most half full
+    */
+
+    if (2 * (pool->shared_size + 1) <= pool->shared_capacity) {
+        return;
+    }
+
+    ASTN_ExprRef* old = pool->shared;
+    size_t old_capacity = pool->shared_capacity;
+
+    pool->shared_capacity = (old_capacity) ? old_capacity * 2 : 1024;
+    pool->shared = calloc(pool->shared_capacity, sizeof(ASTN_ExprRef));
+
+    if (!pool->shared) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i]) {
+            size_t j = (size_t)pool->hashes[old[i]] & (pool->shared_capacity - 1);
+
+            while (pool->shared[j]) {
+                j = (j + 1) & (pool->shared_capacity - 1);
+            }
+
+            pool->shared[j] = old[i];
+        }
+    }
+
+    free(old);
+}
+
+static ASTN_ExprRef ast_share(ASTN_ExprPool* pool, ASTN_ExprRef ref) {
+    /*
+    Hashes a node and looks it up among the shared ones, sharing it if it's new
+    return: the equal shared node; ref itself if there's none (or it can't be shared)
+    */
+
+    pool->hashes[ref] = ast_node_hash(pool, &pool->nodes[ref]);
+
+    if (!pool->hashes[ref]) {
+        return ref;
+    }
+
+    ast_shared_grow(pool);
+
+    size_t slot;
+    ASTN_ExprRef other = ast_shared_find(pool, ref, &slot);
+
+    if (other) {
+        return other;
+    }
+
+    pool->shared[slot] = ref;
+    pool->shared_size++;
+
+    return ref;
+}
+
+ASTN_ExprRef ast_expr_cons(ASTN_ExprPool* pool, ASTN_ExprRef ref) {
+    /*
+    Shares provided expression, the last one built, with a structurally equal one built before;
+    only pure expressions may be passed (calls and ++/-- aren't, nor what holds them), and their
+    operands must have been passed first
+    return: the equal expression built before (dropping ref and its literal); ref itself if
+    there's none or hash-consing is off
+    */
+
+    if (!pool->cons || !ref) {
+        return ref;
+    }
+
+    ASTN_ExprRef other = ast_share(pool, ref);
+
+    if (other != ref && ref + 1 == pool->size) {
+        ASTN_ExprNode* node = &pool->nodes[ref];
+
+        if (node->type == EXPR_LITERAL && node->data.literal + 1 == pool->literals_size) {
+            pool->literals_size--;
+        }
+
+        pool->size--;
+    }
+
+    return other;
+}
+
+uint64_t ast_expr_hash(ASTN_ExprPool* pool, ASTN_ExprRef ref) {
+    /*
+    return: structural hash of provided expression, equal for equal pure expressions across
+    runs; 0 if it isn't shared (or hash-consing was off)
+    */
+
+    return (pool->hashes && ref < pool->size) ? pool->hashes[ref] : 0;
+}
+
+uint32_t ast_literal_push(ASTN_ExprPool* pool, ASTN_Literal* literal) {
+    /*
+    Copies provided literal into the pool's literal table
+    return: its index in the table
+    */
+
+    pool->literals = ast_pool_reserve(pool->literals, &pool->literals_capacity, pool->literals_size, 1, sizeof(ASTN_Literal));
+    pool->literals[pool->literals_size] = *literal;
+
+    return (uint32_t)pool->literals_size++;
+}
+
+uint32_t ast_call_push(ASTN_ExprPool* pool, ASTN_Call* call) {
+    /*
+    Copies provided call into the pool's call table
+    return: its index in the table
+    */
+
+    pool->calls = ast_pool_reserve(pool->calls, &pool->calls_capacity, pool->calls_size, 1, sizeof(ASTN_Call));
+    pool->calls[pool->calls_size] = *call;
+
+    return (uint32_t)pool->calls_size++;
+}
+
+void ast_scratch_push(ASTN_ExprPool* pool, ASTN_ExprRef arg) {
+    /*
+    Holds an argument of the call being parsed until all of its arguments are known
+    */
+
+    pool->scratch = ast_pool_reserve(pool->scratch, &pool->scratch_capacity, pool->scratch_size, 1, sizeof(ASTN_ExprRef));
+    pool->scratch[pool->scratch_size++] = arg;
+}
+
+uint32_t ast_scratch_pop(ASTN_ExprPool* pool, size_t from) {
+    /*
+    Moves the arguments held since provided scratch size into args, keeping them contiguous
+    return: index of the first moved argument in args
+    */
+
+    uint32_t start = (uint32_t)pool->args_size;
+
+    for (size_t i = from; i < pool->scratch_size; i++) {
+        pool->args = ast_pool_reserve(pool->args, &pool->args_capacity, pool->args_size, 1, sizeof(ASTN_ExprRef));
+        pool->args[pool->args_size++] = pool->scratch[i];
+    }
+
+    pool->scratch_size = from;
+
+    return start;
+}
+
+size_t ast_pool_bytes(ASTN_ExprPool* pool) {
+    /*
+    Computes the memory held by the pool's used entries
+    return: # of bytes
+    */
+
+    return pool->size * sizeof(ASTN_ExprNode) + pool->literals_size * sizeof(ASTN_Literal) +
+        pool->calls_size * sizeof(ASTN_Call) + pool->args_size * sizeof(ASTN_ExprRef) +
+        ((pool->hashes) ? pool->size * sizeof(uint64_t) : 0) + pool->shared_capacity * sizeof(ASTN_ExprRef);
+}
+
+static ASTN_ExprRef ast_rebase_ref(ASTN_ExprRef ref, ASTN_PoolBase base) {
+    return (ref) ? ref + base.nodes : 0;
+}
+
+ASTN_PoolBase ast_pool_append(ASTN_ExprPool* pool, ASTN_ExprPool* from) {
+    /*
+    Appends every expression of from (but its reserved node 0) to the pool, shifting the
+    references between them; statements refering to them are shifted by ast_rebase. When both
+    pools hash-cons, the appended shared nodes join the pool's (those equal to one it shares
+    already stay apart, as statements still refer to them)
+    return: offsets the appended expressions moved by
+    */
+
+    ASTN_PoolBase base = { (uint32_t)pool->size - 1, (uint32_t)pool->args_size };
+    uint32_t literals = (uint32_t)pool->literals_size;
+    uint32_t calls = (uint32_t)pool->calls_size;
+
+    pool->nodes = ast_pool_reserve(pool->nodes, &pool->capacity, pool->size, from->size - 1, sizeof(ASTN_ExprNode));
+    pool->literals = ast_pool_reserve(pool->literals, &pool->literals_capacity, pool->literals_size, from->literals_size, sizeof(ASTN_Literal));
+    pool->calls = ast_pool_reserve(pool->calls, &pool->calls_capacity, pool->calls_size, from->calls_size, sizeof(ASTN_Call));
+    pool->args = ast_pool_reserve(pool->args, &pool->args_capacity, pool->args_size, from->args_size, sizeof(ASTN_ExprRef));
+
+    for (size_t i = 1; i < from->size; i++) {
+        ASTN_ExprNode node = from->nodes[i];
+
+        switch (node.type) {
+            case EXPR_LITERAL:
+                node.data.literal += literals;
+                break;
+            case EXPR_FUNCTION_CALL:
+                node.data.call += calls;
+                break;
+            case EXPR_FACTOR:
+            case EXPR_NEST:
+            case EXPR_POSTFIX:
+                node.data.unary_op.expr = ast_rebase_ref(node.data.unary_op.expr, base);
+                break;
+            case EXPR_TERM:
+            case EXPR_MULTIPLICATION:
+            case EXPR_ADDITION:
+            case EXPR_BITWISE:
+            case EXPR_COMPARISON:
+                node.data.binary_op.left = ast_rebase_ref(node.data.binary_op.left, base);
+                node.data.binary_op.right = ast_rebase_ref(node.data.binary_op.right, base);
+                break;
+            default:
+                break;
+        }
+
+        pool->nodes[pool->size++] = node;
+    }
+
+    for (size_t i = 0; i < from->literals_size; i++) {
+        pool->literals[pool->literals_size++] = from->literals[i];
+    }
+
+    for (size_t i = 0; i < from->calls_size; i++) {
+        ASTN_Call call = from->calls[i];
+        call.args += base.args;
+
+        pool->calls[pool->calls_size++] = call;
+    }
+
+    for (size_t i = 0; i < from->args_size; i++) {
+        pool->args[pool->args_size++] = ast_rebase_ref(from->args[i], base);
+    }
+
+    if (pool->cons) {
+        pool->hashes = ast_pool_reserve(pool->hashes, &pool->hashes_capacity, 0, pool->size, sizeof(uint64_t));
+
+        for (size_t i = 1; i < from->size; i++) {
+            ASTN_ExprRef ref = (ASTN_ExprRef)(i + base.nodes);
+            pool->hashes[ref] = (from->cons) ? from->hashes[i] : 0;
+
+            if (!pool->hashes[ref]) {
+                continue;
+            }
+
+            size_t slot;
+            ast_shared_grow(pool);
+
+            if (!ast_shared_find(pool, ref, &slot)) {
+                pool->shared[slot] = ref;
+                pool->shared_size++;
+            }
+        }
+    }
+
+    return base;
+}
+
+static void ast_rebase_statements(ASTN_Statements* stms, ASTN_PoolBase base) {
+    if (!stms) {
+        return;
+    }
+
+    for (size_t i = 0; i < stms->size; i++) {
+        ast_rebase(AST_VEC_ITEMS(*stms)[i], base);
+    }
+}
+
+void ast_rebase(AST_Node* node, ASTN_PoolBase base) {
+    /*
+    Shifts every expression reference of a function declaration or statement (and of the
+    statements nested in it) after its expressions were moved by ast_pool_append; attribute and
+    class declarations share nodes between their lists and are never moved
+    */
+
+    if (!node || node->type != STMT) {
+        return;
+    }
+
+    ASTN_Statement* stm = &node->data.stm;
+
+    switch (stm->type) {
+        case STMT_FUNCTION_DECL:
+            ast_rebase_statements(stm->data.function_decl.statements, base);
+            break;
+        case STMT_VARIABLE_DECL:
+            stm->data.variable_decl.expr = ast_rebase_ref(stm->data.variable_decl.expr, base);
+            break;
+        case STMT_CALL:
+            stm->data.call.args += base.args;
+            break;
+        case STMT_CONDITIONAL:
+            stm->data.conditional.if_condition = ast_rebase_ref(stm->data.conditional.if_condition, base);
+            ast_rebase_statements(stm->data.conditional.if_statements, base);
+
+            for (size_t i = 0; i < stm->data.conditional.elif_branches.size; i++) {
+                ASTN_ElifBranch* branch = &AST_VEC_ITEMS(stm->data.conditional.elif_branches)[i];
+                branch->condition = ast_rebase_ref(branch->condition, base);
+                ast_rebase_statements(branch->statements, base);
+            }
+
+            ast_rebase_statements(stm->data.conditional.else_statements, base);
+            break;
+        case STMT_FOR_LOOP:
+            stm->data.for_loop.var_decl.expr = ast_rebase_ref(stm->data.for_loop.var_decl.expr, base);
+            stm->data.for_loop.condition_expr = ast_rebase_ref(stm->data.for_loop.condition_expr, base);
+            stm->data.for_loop.next_expr = ast_rebase_ref(stm->data.for_loop.next_expr, base);
+            ast_rebase_statements(stm->data.for_loop.statements, base);
+            break;
+        case STMT_SWITCH:
+            stm->data.switch_stm.condition_expr = ast_rebase_ref(stm->data.switch_stm.condition_expr, base);
+
+            for (size_t i = 0; i < stm->data.switch_stm.clauses.size; i++) {
+                ASTN_SwitchClause* clause = &AST_VEC_ITEMS(stm->data.switch_stm.clauses)[i];
+                clause->value = ast_rebase_ref(clause->value, base);
+                ast_rebase_statements(clause->statements, base);
+            }
+
+            ast_rebase_statements(stm->data.switch_stm.default_stms, base);
+            break;
+        case STMT_TRY:
+            ast_rebase_statements(stm->data.try_stm.try_statements, base);
+
+            for (size_t i = 0; i < stm->data.try_stm.except_branches.size; i++) {
+                ast_rebase_statements(AST_VEC_ITEMS(stm->data.try_stm.except_branches)[i].statements, base);
+            }
+
+            ast_rebase_statements(stm->data.try_stm.finally_statements, base);
+            break;
+        case STMT_WHILE_LOOP:
+            stm->data.while_loop.condition_expr = ast_rebase_ref(stm->data.while_loop.condition_expr, base);
+            ast_rebase_statements(stm->data.while_loop.statements, base);
+            break;
+        case STMT_EXPRESSION:
+            stm->data.expression = ast_rebase_ref(stm->data.expression, base);
+            break;
+        case STMT_RETURN:
+            stm->data.return_stm.expr = ast_rebase_ref(stm->data.return_stm.expr, base);
+            break;
+        case STMT_THROW:
+            stm->data.throw_stm.args += base.args;
+            break;
+        default:
+            break;
+    }
+}
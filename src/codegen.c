@@ -1,6 +1,6 @@
 #include "codegen.h"
 
-void GEN(AST_Node *root) {
+void GEN(AST_Node *root, ASTN_ExprPool *exprs) {
     FILE *fp = fopen("prog.asm", "w");
     if (fp == NULL) {
         perror("Error opening output file");
@@ -11,12 +11,14 @@ void GEN(AST_Node *root) {
     fprintf(fp, "global _start\n\n");
 
     
-    generate_code_for_ast(root, fp);
+    for (size_t i = 0; i < root->data.root.size; i++) {
+        generate_code_for_ast(AST_VEC_ITEMS(root->data.root)[i], exprs, fp);
+    }
 
     fclose(fp);
 }
 
-void generate_code_for_ast(AST_Node *node, FILE *fp) {
+void generate_code_for_ast(AST_Node *node, ASTN_ExprPool *exprs, FILE *fp) {
     if (node == NULL) {
         return;
     }
@@ -26,7 +28,7 @@ void generate_code_for_ast(AST_Node *node, FILE *fp) {
             fprintf(fp, "_start:\n");
 
             for (size_t i = 0; i < node->data.mep.statements->size; i++) {
-                generate_code_for_statement(node->data.mep.statements->statement[i], fp);
+                generate_code_for_statement(AST_VEC_ITEMS(*node->data.mep.statements)[i], exprs, fp);
             }
 
             fprintf(fp, "    mov eax, 60        ; System call number for exit (sys_exit)\n");
@@ -37,11 +39,11 @@ void generate_code_for_ast(AST_Node *node, FILE *fp) {
             break;
     }
 
-    generate_code_for_ast(node->left, fp);
-    generate_code_for_ast(node->right, fp);
+    generate_code_for_ast(node->left, exprs, fp);
+    generate_code_for_ast(node->right, exprs, fp);
 }
 
-void generate_code_for_statement(AST_Node *statement, FILE *fp) {
+void generate_code_for_statement(AST_Node *statement, ASTN_ExprPool *exprs, FILE *fp) {
     if (statement == NULL) {
         return;
     }
@@ -49,7 +51,8 @@ void generate_code_for_statement(AST_Node *statement, FILE *fp) {
     switch (statement->data.stm.type) {
         case STMT_RETURN:
 
-            int return_value = statement->data.stm.data.return_stm.expr->data.expr.data.literal.value.uint.bit64;
+            ASTN_ExprNode* expr = AST_EXPR(exprs, statement->data.stm.data.return_stm.expr);
+            int return_value = (expr->type == EXPR_LITERAL) ? exprs->literals[expr->data.literal].value.uint.bit64 : 0;
             fprintf(fp, "    mov edi, %d        ;\n", return_value);
             break;
         default:
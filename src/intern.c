@@ -0,0 +1,229 @@
+#include "intern.h"
+#include "memory.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct InternName {
+    const char* str; // '\0' terminated copy in its shard's arena
+    size_t len;
+    uint64_t hash; // intern_hash_bytes of the name
+} InternName;
+
+typedef struct InternShard {
+    pthread_mutex_t lock;
+    uint64_t* slots; // high half of the name's hash, then its atom (open addressing, 0 is an empty slot)
+    size_t size, capacity;
+    Arena arena; // copies of its names
+} InternShard;
+
+static InternShard shards[INTERN_SHARDS];
+static pthread_once_t shards_once = PTHREAD_ONCE_INIT;
+
+// names by atom, in blocks that never move once allocated, so they're read without locking
+static InternName* blocks[INTERN_BLOCKS];
+static uint32_t count;
+static pthread_mutex_t count_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void intern_init(void) {
+    for (size_t i = 0; i < INTERN_SHARDS; i++) {
+        pthread_mutex_init(&shards[i].lock, NULL);
+    }
+}
+
+static InternName none = { "", 0, 0 }; // name of atom 0
+
+static InternName* intern_entry(uint32_t atom) {
+    return (atom) ? &blocks[atom / INTERN_BLOCK][atom % INTERN_BLOCK] : &none;
+}
+
+uint64_t intern_hash_bytes(const char* str, size_t len) {
+    /*
+    Hashes provided bytes 8 at a time (multiply and xor-shift mixing)
+    return: 64-bit hash, the same on every run
+    */
+
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ (uint64_t)len;
+    uint64_t word;
+
+    for (; len >= 8; str += 8, len -= 8) {
+        memcpy(&word, str, 8);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+
+    if (len) {
+        word = 0;
+        memcpy(&word, str, len);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+
+    hash *= 0x94D049BB133111EBull;
+
+    return hash ^ (hash >> 29);
+}
+
+static void intern_grow(InternShard* shard) {
+    uint64_t* slots = shard->slots;
+    size_t old = shard->capacity;
+
+    shard->capacity = (old) ? old * 2 : 256;
+    shard->slots = calloc(shard->capacity, sizeof(uint64_t));
+
+    if (!shard->slots) {
+        exit(EXIT_FAILURE);
+    }
+
+    size_t mask = shard->capacity - 1;
+
+    for (size_t k = 0; k < old; k++) {
+        if (!slots[k]) {
+            continue;
+        }
+
+        size_t i = intern_entry((uint32_t)slots[k])->hash & mask;
+
+        while (shard->slots[i]) {
+            i = (i + 1) & mask;
+        }
+
+        shard->slots[i] = slots[k];
+    }
+
+    free(slots);
+}
+
+static uint32_t intern_new(const char* str, size_t len, uint64_t hash) {
+    /*
+    Hands out the next atom to provided (copied) name
+    return: its atom
+    */
+
+    pthread_mutex_lock(&count_lock);
+
+    uint32_t atom = ++count;
+
+    if (atom >= (uint32_t)INTERN_BLOCK * INTERN_BLOCKS) {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!blocks[atom / INTERN_BLOCK]) {
+        blocks[atom / INTERN_BLOCK] = malloc(INTERN_BLOCK * sizeof(InternName));
+
+        if (!blocks[atom / INTERN_BLOCK]) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    *intern_entry(atom) = (InternName){ str, len, hash };
+
+    pthread_mutex_unlock(&count_lock);
+
+    return atom;
+}
+
+static uint32_t intern_atom_hashed(const char* str, size_t len, uint64_t hash) {
+    pthread_once(&shards_once, intern_init);
+
+    uint64_t tag = hash & 0xFFFFFFFF00000000ull;
+    InternShard* shard = &shards[(hash >> 26) % INTERN_SHARDS];
+
+    pthread_mutex_lock(&shard->lock);
+
+    if ((shard->size + 1) * 4 > shard->capacity * 3) {
+        intern_grow(shard);
+    }
+
+    size_t mask = shard->capacity - 1;
+    size_t i = hash & mask;
+
+    for (; shard->slots[i]; i = (i + 1) & mask) {
+        if ((shard->slots[i] & 0xFFFFFFFF00000000ull) != tag) {
+            continue;
+        }
+
+        uint32_t atom = (uint32_t)shard->slots[i];
+        InternName* name = intern_entry(atom);
+
+        if (name->len == len && memcmp(name->str, str, len) == 0) {
+            pthread_mutex_unlock(&shard->lock);
+            return atom;
+        }
+    }
+
+    uint32_t atom = intern_new(arena_strndup(&shard->arena, str, len), len, hash);
+
+    shard->slots[i] = tag | atom;
+    shard->size++;
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return atom;
+}
+
+uint32_t intern_atom(const char* str, size_t len) {
+    /*
+    Interns provided name (safe to call from any # of threads)
+    return: its atom, the same for every call with the same bytes
+    */
+
+    return intern_atom_hashed(str, len, intern_hash_bytes(str, len));
+}
+
+uint32_t intern_atom_cached(InternCache* cache, const char* str, size_t len) {
+    /*
+    Interns provided name as intern_atom does, trying provided cache (owned by the calling
+    thread) first
+    return: its atom
+    */
+
+    uint64_t hash = intern_hash_bytes(str, len);
+    uint32_t* slot = &cache->atoms[(hash >> 40) % INTERN_CACHE];
+
+    // (an atom this thread got from intern_atom_hashed already has its name written)
+    if (*slot) {
+        InternName* name = intern_entry(*slot);
+
+        if (name->hash == hash && name->len == len && memcmp(name->str, str, len) == 0) {
+            return *slot;
+        }
+    }
+
+    *slot = intern_atom_hashed(str, len, hash);
+
+    return *slot;
+}
+
+uint32_t intern_count(void) {
+    /*
+    return: # of atoms handed out so far (the highest atom)
+    */
+
+    pthread_mutex_lock(&count_lock);
+    uint32_t size = count;
+    pthread_mutex_unlock(&count_lock);
+
+    return size;
+}
+
+const char* intern_name(uint32_t atom) {
+    /*
+    return: '\0' terminated name of provided atom (lives as long as the process)
+    */
+
+    return intern_entry(atom)->str;
+}
+
+size_t intern_len(uint32_t atom) {
+    return intern_entry(atom)->len;
+}
+
+uint64_t intern_hash(uint32_t atom) {
+    /*
+    return: hash of the name of provided atom, which unlike the atom is the same on every run
+    */
+
+    return intern_entry(atom)->hash;
+}
@@ -3,39 +3,120 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-char* io_load_file(char* filename) {
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static SourceBuffer io_read_stream(FILE* f) {
+    /*
+    reads provided stream into a heap buffer (used when the source can not be mapped)
+    return: SourceBuffer with map_size 0
+    */
+
+    SourceBuffer src = {0};
+    size_t capacity = 4096;
+
+    src.data = malloc(capacity);
+
+    if (!src.data) {
+        exit(EXIT_FAILURE);
+    }
+
+    size_t n;
+    while ((n = fread(src.data + src.size, 1, capacity - src.size - 1, f)) > 0) {
+        src.size += n;
+
+        if (src.size + 1 == capacity) {
+            capacity *= 2;
+            src.data = realloc(src.data, capacity);
+
+            if (!src.data) {
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    src.data[src.size] = '\0';
+
+    return src;
+}
+
+SourceBuffer io_load_file(char* filename) {
     /*
     reads provided filename (from the directory where executable was ran / command was called)
-    return: processed buffer: char* including all contents of provided filename
+    regular files are memory-mapped read-only; the mapping is rounded up so that at least one
+    zero byte (up to a whole sentinel page) follows the contents
+    return: SourceBuffer whose data is '\0' terminated at data[size]
     */
-    
-    char* buffer = 0;
-    __uint128_t length;
-    FILE* f = fopen(filename, "rb");
-    
-    if (!f) {
+
+#if !defined(_WIN32)
+    int fd = open(filename, O_RDONLY);
+
+    if (fd < 0) {
         exit(EXIT_FAILURE);
-        return NULL; 
     }
 
-    fseek(f, 0, SEEK_END);
-    length = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    struct stat st;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t size = (size_t)st.st_size;
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t map_size = ((size / page) + 1) * page;
+
+        // reserve zeroed memory first, then place the file over its head; whatever is left
+        // of the last file page (or the extra page when size is page aligned) reads as '\0'
+        char* base = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 
-    buffer = malloc(sizeof(char) * (length + 1));
+        if (base != MAP_FAILED) {
+            if (mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                close(fd);
+                madvise(base, map_size, MADV_SEQUENTIAL);
 
-    if (!buffer) {
-        fclose(f);
+                return (SourceBuffer){ .data = base, .size = size, .map_size = map_size };
+            }
+
+            munmap(base, map_size);
+        }
+    }
+
+    FILE* f = fdopen(fd, "rb");
+#else
+    FILE* f = fopen(filename, "rb");
+#endif
+
+    if (!f) {
         exit(EXIT_FAILURE);
-        return NULL;
     }
-    
-    fread(buffer, 1, length, f);
-    fclose(f);
 
-    buffer[length + 1] = '\0';
+    SourceBuffer src = io_read_stream(f);
+    fclose(f);
 
-    return buffer;
+    return src;
 }
 
+void io_free_file(SourceBuffer* src) {
+    /*
+    Releases a buffer returned by io_load_file
+    */
 
+    if (!src || !src->data) {
+        return;
+    }
+
+#if !defined(_WIN32)
+    if (src->map_size) {
+        munmap(src->data, src->map_size);
+    } else {
+        free(src->data);
+    }
+#else
+    free(src->data);
+#endif
+
+    src->data = NULL;
+    src->size = 0;
+    src->map_size = 0;
+}
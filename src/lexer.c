@@ -6,111 +6,1050 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
 
-char* keywords[NO_OF_KEYWORDS] = {
-    "as", "attr", "bool", "char", "class", "const", "double", "enum", "ext",
-    "false", "float", "fn", "from", "glob", "import", "int", "l_long", "long", "mut",
-    "priv", "pub", "return", "short", "s_short", "size", "str", "struct", "true", "uint", "var",
-    "if", "elif", "else", "for", "while", "switch", "case", "try", "except", "finally", "break", "continue", "err", "throw", "default"
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+typedef struct Keyword {
+    const char* name;
+    uint8_t len;
+    uint8_t type;
+} Keyword;
+
+#define KEYWORD(name, type) { name, sizeof(name) - 1, type },
+
+static const Keyword keyword_list[NO_OF_KEYWORDS] = {
+    KEYWORD_LIST(KEYWORD)
 };
 
+// keyword table indexed by KEYWORD_HASH, filled from keyword_list; unused slots have len 0 and never match
+static Keyword keywords[KEYWORD_TABLE_SIZE];
+static pthread_once_t keywords_once = PTHREAD_ONCE_INIT;
+
+static void lexer_init_keywords(void) {
+    /*
+    Places every keyword in its slot of the table, keyed by its own first char, last char and
+    length; exits if two keywords share a slot (KEYWORD_HASH needs new constants)
+    */
+
+    for (size_t i = 0; i < NO_OF_KEYWORDS; i++) {
+        const Keyword* kw = &keyword_list[i];
+        Keyword* slot = &keywords[KEYWORD_HASH(kw->name[0], kw->name[kw->len - 1], kw->len)];
+
+        if (slot->len) {
+            fprintf(stderr, "[NEX]: keywords '%s' and '%s' share a slot of the keyword table\n", slot->name, kw->name);
+            exit(EXIT_FAILURE);
+        }
+
+        *slot = *kw;
+    }
+}
+
+static uint8_t lexer_match_keyword(const char* iden, size_t len) {
+    // (the table is filled by the time any lexer exists)
+    const Keyword* kw = &keywords[KEYWORD_HASH(iden[0], iden[len - 1], len)];
+
+    return (kw->len == len && memcmp(kw->name, iden, len) == 0) ? kw->type : TOK_IDEN;
+}
+
+uint8_t lexer_keyword(const char* iden, size_t len) {
+    /*
+    Looks provided identifier up in the keyword table (one probe)
+    return: token type of the keyword it spells; TOK_IDEN if it isn't one
+    */
+
+    pthread_once(&keywords_once, lexer_init_keywords);
+
+    return (len && len <= MAX_KEYWORD_LEN) ? lexer_match_keyword(iden, len) : TOK_IDEN;
+}
+
 Lexer* lexer_init(char* filename) {
     /*
     Initializes lexer to lex provided values
     return: pointer to a propperly initalized lexer struct
     */
 
-    Lexer* lexer = calloc(1, sizeof(Lexer));
+    return lexer_init_from_source(io_load_file(filename));
+}
+
+Lexer* lexer_init_from_source(SourceBuffer src) {
+    /*
+    Initializes lexer to lex a loaded source file, which it takes over (freed with the lexer)
+    return: pointer to a propperly initalized lexer struct
+    */
+
+    Lexer* lexer = lexer_init_from_buffer(src.data, src.size);
+
+    lexer->src = src;
+
+    return (Lexer*)lexer;
+}
+
+static void lexer_index_lines(Lexer* lexer) {
+    /*
+    Records the offset of every line start ('\n' and '\v' end a line) so source locations can
+    be resolved by binary search instead of being tracked while lexing
+    */
+
+    // ~40 bytes per line on typical code; grows if that runs short
+    size_t capacity = lexer->buf_size / 32 + 16;
+
+    lexer->lines = malloc(capacity * sizeof(size_t));
+
+    if (!lexer->lines) {
+        exit(EXIT_FAILURE);
+    }
+
+    lexer->lines[0] = 0;
+    lexer->lines_size = 1;
+
+    for (size_t i = 0; i < lexer->buf_size; i++) {
+        i += scanner.line(lexer->buf + i, lexer->buf_size - i);
+
+        if (i >= lexer->buf_size) {
+            break;
+        }
+
+        if (lexer->lines_size == capacity) {
+            capacity *= 2;
+            lexer->lines = realloc(lexer->lines, capacity * sizeof(size_t));
+
+            if (!lexer->lines) {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        lexer->lines[lexer->lines_size++] = i + 1;
+    }
+}
+
+Lexer* lexer_init_from_buffer(char* buf, size_t size) {
+    /*
+    Initializes lexer to lex provided buffer in place; the buffer is borrowed, not copied,
+    and has to outlive the lexer (lexer_free leaves it untouched)
+    return: pointer to a propperly initalized lexer struct
+    */
+
+    Lexer* lexer = calloc(1, sizeof(Lexer));
+
+    if (!lexer) {
+        exit(EXIT_FAILURE);
+    }
+
+    scan_init();
+    pthread_once(&keywords_once, lexer_init_keywords);
+
+    lexer->buf = buf;
+    lexer->buf_size = size;
+
+    lexer->i = 0;
+    lexer->c = (size > 0) ? lexer->buf[lexer->i] : '\0';
+
+    lexer_index_lines(lexer);
+
+    return (Lexer*)lexer;
+}
+
+void lexer_free(Lexer* lexer) {
+    /*
+    De-initializes provided lexer
+    */
+
+    if (!lexer) {
+        return;
+        exit(EXIT_FAILURE);
+    }
+
+    io_free_file(&lexer->src);
+    arena_free(&lexer->arena);
+    free(lexer->lines);
+
+    for (size_t i = 0; i < lexer->diags; i++) {
+        free(lexer->diag[i].message);
+    }
+
+    free(lexer->diag);
+    free(lexer);
+
+    lexer = NULL;
+}
+
+Lexer* lexer_view(Lexer* lexer, size_t i) {
+    /*
+    Initializes a lexer sharing provided lexer's buffer and line index, positioned at i, that
+    holds its diagnostics back (to be printed in order with lexer_flush_diag/lexer_replay_diag)
+    return: pointer to the lexer, released with lexer_view_free
+    */
+
+    Lexer* view = calloc(1, sizeof(Lexer));
+
+    if (!view) {
+        exit(EXIT_FAILURE);
+    }
+
+    view->buf = lexer->buf;
+    view->buf_size = lexer->buf_size;
+    view->lines = lexer->lines;
+    view->lines_size = lexer->lines_size;
+
+    view->i = i;
+    view->c = (view->i < view->buf_size) ? view->buf[view->i] : '\0';
+
+    view->diag_cap = 16;
+    view->diag = malloc(view->diag_cap * sizeof(LexerDiag));
+
+    if (!view->diag) {
+        exit(EXIT_FAILURE);
+    }
+
+    return view;
+}
+
+void lexer_view_free(Lexer* view) {
+    /*
+    De-initializes a lexer made by lexer_view (the shared buffer and line index stay)
+    */
+
+    if (!view) {
+        return;
+    }
+
+    view->lines = NULL;
+    lexer_free(view);
+}
+
+Token* lexer_token_init(Lexer* lexer, size_t offset, size_t len, uint8_t type) {
+    /*
+    Initializes the lexer's current token to view provided range of the lexer buffer
+    return: pointer to the lexer owned token (valid until the next token is lexed)
+    */
+
+    Token* token = &lexer->tok;
+
+    token->type = type;  
+
+    token->offset = offset;
+    token->len = len;
+    token->value = NULL;
+    token->num = 0;
+    token->atom = 0;
+
+    return (Token*)token;
+}
+
+char* lexer_token_value(Lexer* lexer, Token* token) {
+    /*
+    Resolves the text of provided token, copying it out of the lexer buffer on first use
+    return: '\0' terminated value in the lexer's arena
+    */
+
+    if (!token->value) {
+        token->value = arena_strndup(&lexer->arena, lexer->buf + token->offset, token->len);
+    }
+
+    return token->value;
+}
+
+TokenStream* token_stream_init(const char* buf, size_t capacity) {
+    /*
+    Initializes an empty token stream over provided buffer with room for capacity tokens
+    return: pointer to a propperly initalized token stream struct
+    */
+
+    TokenStream* stream = calloc(1, sizeof(TokenStream));
+
+    if (!stream) {
+        exit(EXIT_FAILURE);
+    }
+
+    stream->buf = buf;
+    stream->capacity = (capacity > 0) ? capacity : 1;
+
+    stream->type = malloc(stream->capacity * sizeof(uint8_t));
+    stream->offset = malloc(stream->capacity * sizeof(size_t));
+    stream->len = malloc(stream->capacity * sizeof(uint32_t));
+    stream->value = malloc(stream->capacity * sizeof(char*));
+    stream->atom = malloc(stream->capacity * sizeof(uint32_t));
+
+    if (!stream->type || !stream->offset || !stream->len || !stream->value || !stream->atom) {
+        exit(EXIT_FAILURE);
+    }
+
+    return stream;
+}
+
+static void token_stream_push_number(TokenStream* stream, size_t index, __uint128_t num) {
+    /*
+    Records the value of the integer literal at provided token index (indices must ascend)
+    */
+
+    if (stream->nums == stream->nums_capacity) {
+        stream->nums_capacity = (stream->nums_capacity > 0) ? stream->nums_capacity * 2 : 64;
+
+        stream->num_index = realloc(stream->num_index, stream->nums_capacity * sizeof(size_t));
+        stream->num = realloc(stream->num, stream->nums_capacity * sizeof(__uint128_t));
+
+        if (!stream->num_index || !stream->num) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    stream->num_index[stream->nums] = index;
+    stream->num[stream->nums++] = num;
+}
+
+static size_t token_stream_find_number(TokenStream* stream, size_t index) {
+    /*
+    Binary searches the integer literal table for provided token index
+    return: position of the first entry at or past index (stream->nums if none)
+    */
+
+    size_t lo = 0, hi = stream->nums;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (stream->num_index[mid] < index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+void token_stream_push(TokenStream* stream, Token* token) {
+    /*
+    Appends provided token to the stream (its value stays in the lexer's arena)
+    */
+
+    token_stream_reserve(stream, 1);
+
+    size_t i = stream->size++;
+
+    stream->type[i] = token->type;
+    stream->offset[i] = token->offset;
+    stream->len[i] = (uint32_t)token->len;
+    stream->value[i] = token->value;
+    stream->atom[i] = token->atom;
+
+    if (IS_INT_LITERAL(token->type)) {
+        token_stream_push_number(stream, i, token->num);
+    }
+}
+
+void token_stream_append(TokenStream* stream, TokenStream* from, size_t index) {
+    /*
+    Appends the tokens of from starting at provided index
+    */
+
+    if (index >= from->size) {
+        return;
+    }
+
+    size_t n = from->size - index;
+    size_t i = stream->size;
+
+    token_stream_reserve(stream, n);
+
+    memcpy(stream->type + i, from->type + index, n * sizeof(uint8_t));
+    memcpy(stream->offset + i, from->offset + index, n * sizeof(size_t));
+    memcpy(stream->len + i, from->len + index, n * sizeof(uint32_t));
+    memcpy(stream->value + i, from->value + index, n * sizeof(char*));
+    memcpy(stream->atom + i, from->atom + index, n * sizeof(uint32_t));
+
+    for (size_t k = token_stream_find_number(from, index); k < from->nums; k++) {
+        token_stream_push_number(stream, from->num_index[k] - index + i, from->num[k]);
+    }
+
+    stream->size += n;
+}
+
+void token_stream_splice(TokenStream* stream, size_t index, size_t count, TokenStream* from) {
+    /*
+    Replaces provided # of tokens from index on with every token of from; the tokens after them
+    move to make room (keeping their offsets)
+    */
+
+    size_t n = from->size;
+    size_t tail = stream->size - index - count;
+
+    if (n > count) {
+        token_stream_reserve(stream, n - count);
+    }
+
+    memmove(stream->type + index + n, stream->type + index + count, tail * sizeof(uint8_t));
+    memmove(stream->offset + index + n, stream->offset + index + count, tail * sizeof(size_t));
+    memmove(stream->len + index + n, stream->len + index + count, tail * sizeof(uint32_t));
+    memmove(stream->value + index + n, stream->value + index + count, tail * sizeof(char*));
+    memmove(stream->atom + index + n, stream->atom + index + count, tail * sizeof(uint32_t));
+
+    memcpy(stream->type + index, from->type, n * sizeof(uint8_t));
+    memcpy(stream->offset + index, from->offset, n * sizeof(size_t));
+    memcpy(stream->len + index, from->len, n * sizeof(uint32_t));
+    memcpy(stream->value + index, from->value, n * sizeof(char*));
+    memcpy(stream->atom + index, from->atom, n * sizeof(uint32_t));
+
+    stream->size = stream->size - count + n;
+
+    // integer literals: the ones before index stay, from's come next, the rest move along
+    size_t lo = token_stream_find_number(stream, index);
+    size_t hi = token_stream_find_number(stream, index + count);
+    size_t nums = stream->nums - (hi - lo) + from->nums;
+
+    if (nums > stream->nums_capacity) {
+        while (nums > stream->nums_capacity) {
+            stream->nums_capacity = (stream->nums_capacity > 0) ? stream->nums_capacity * 2 : 64;
+        }
+
+        stream->num_index = realloc(stream->num_index, stream->nums_capacity * sizeof(size_t));
+        stream->num = realloc(stream->num, stream->nums_capacity * sizeof(__uint128_t));
+
+        if (!stream->num_index || !stream->num) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    memmove(stream->num_index + lo + from->nums, stream->num_index + hi, (stream->nums - hi) * sizeof(size_t));
+    memmove(stream->num + lo + from->nums, stream->num + hi, (stream->nums - hi) * sizeof(__uint128_t));
+
+    for (size_t k = lo + from->nums; k < nums; k++) {
+        stream->num_index[k] = stream->num_index[k] - count + n;
+    }
+
+    for (size_t k = 0; k < from->nums; k++) {
+        stream->num_index[lo + k] = from->num_index[k] + index;
+        stream->num[lo + k] = from->num[k];
+    }
+
+    stream->nums = nums;
+}
+
+void token_stream_reserve(TokenStream* stream, size_t count) {
+    /*
+    Makes room for provided # of tokens past the current end of the stream
+    */
+
+    if (stream->size + count > stream->capacity) {
+        while (stream->size + count > stream->capacity) {
+            stream->capacity *= 2;
+        }
+
+        stream->type = realloc(stream->type, stream->capacity * sizeof(uint8_t));
+        stream->offset = realloc(stream->offset, stream->capacity * sizeof(size_t));
+        stream->len = realloc(stream->len, stream->capacity * sizeof(uint32_t));
+        stream->value = realloc(stream->value, stream->capacity * sizeof(char*));
+        stream->atom = realloc(stream->atom, stream->capacity * sizeof(uint32_t));
+
+        if (!stream->type || !stream->offset || !stream->len || !stream->value || !stream->atom) {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+char* token_stream_value(TokenStream* stream, size_t index) {
+    /*
+    Resolves the text of the token at provided index, copying it out of the buffer on first use
+    return: '\0' terminated value in the lexer's or the stream's arena
+    */
+
+    if (!stream->value[index]) {
+        stream->value[index] = arena_strndup(&stream->arena, stream->buf + stream->offset[index], stream->len[index]);
+    }
+
+    return stream->value[index];
+}
+
+__uint128_t token_stream_number(TokenStream* stream, size_t index) {
+    /*
+    Looks up the parsed value of the integer literal at provided index
+    return: value (two's complement for the signed types), 0 if the token is no integer literal
+    */
+
+    size_t k = token_stream_find_number(stream, index);
+
+    return (k < stream->nums && stream->num_index[k] == index) ? stream->num[k] : 0;
+}
+
+void token_stream_free(TokenStream* stream) {
+    /*
+    De-initializes provided token stream along with every value it materialized
+    */
+
+    if (!stream) {
+        return;
+    }
+
+    arena_free(&stream->arena);
+    free(stream->type);
+    free(stream->offset);
+    free(stream->len);
+    free(stream->value);
+    free(stream->atom);
+    free(stream->num_index);
+    free(stream->num);
+    free(stream);
+}
+
+Token* lexer_next_token(Lexer* lexer) {
+    /*
+    Lexes the next token into its own copy
+    return: token in the lexer's arena (released along with the lexer)
+    */
+
+    Token* token = arena_alloc(&lexer->arena, sizeof(Token));
+    *token = *lexer_scan_token(lexer);
+
+    return token;
+}
+
+TokenStream* lexer_tokenize_all(Lexer* lexer) {
+    /*
+    Lexes the whole (remaining) buffer into one contiguous token stream
+    return: stream ending in TOK_EOF, released with token_stream_free
+    */
+
+    // ~4 source bytes per token on typical code; the stream grows if that runs short
+    TokenStream* stream = token_stream_init(lexer->buf, (lexer->buf_size - lexer->i) / 4 + 16);
+
+    while (true) {
+        Token* token = lexer_scan_token(lexer);
+        token_stream_push(stream, token);
+
+        if (token->type == TOK_EOF) {
+            break;
+        }
+    }
+
+    return stream;
+}
+
+// parallel tokenization: the buffer is split at line starts into chunks that are lexed
+// speculatively on worker threads (as if no token crossed into them), then stitched in order;
+// a chunk whose start turns out to lie inside a token of the previous one (e.g. a multi-line
+// string literal) is re-lexed from the true position until it lines up with its own tokens
+
+typedef struct LexerMark {
+    size_t token; // # of chunk tokens lexed before the diagnostic
+    size_t diag; // # of diagnostics the chunk lexer raised before it
+} LexerMark;
+
+typedef struct LexerChunk {
+    Lexer* parent; // lexer being tokenized (owns the buffer and its line index)
+    size_t start, end; // [start, end) byte range of the chunk, start is always a line start
+
+    Lexer* lexer; // worker lexer, left right where the chunk stopped
+    TokenStream* tokens;
+    size_t* ends; // lexer position after each token (to re-synchronise on)
+
+    LexerMark* marks;
+    size_t marks_size, marks_cap;
+
+    size_t first; // position of the chunk's first token (after leading fillers)
+    bool eof; // lexing ended at a '\0' inside the chunk
+} LexerChunk;
+
+static bool lexer_chunk_step(Lexer* lexer, size_t end, Token** token) {
+    /*
+    Lexes the next token belonging to a chunk that ends at provided position
+    return: false once the chunk is exhausted (next token begins at/after end, or EOF)
+    */
+
+    lexer_handle_fillers(lexer);
+
+    if (lexer->i >= end) {
+        return false;
+    }
+
+    *token = lexer_scan_token(lexer);
+
+    return (*token)->type != TOK_EOF;
+}
+
+static void* lexer_chunk_lex(void* arg) {
+    /*
+    Lexes a chunk into its own token stream, holding its diagnostics back
+    */
+
+    LexerChunk* chunk = (LexerChunk*)arg;
+    Lexer* lexer = lexer_view(chunk->parent, chunk->start);
+
+    size_t capacity = (chunk->end - chunk->start) / 4 + 16;
+
+    chunk->lexer = lexer;
+    chunk->tokens = token_stream_init(lexer->buf, capacity);
+    chunk->ends = malloc(capacity * sizeof(size_t));
+
+    if (!chunk->ends) {
+        exit(EXIT_FAILURE);
+    }
+
+    lexer_handle_fillers(lexer);
+    chunk->first = lexer->i;
+
+    Token* token;
+
+    while (true) {
+        size_t errors = lexer->errors;
+        bool more = lexer_chunk_step(lexer, chunk->end, &token);
+
+        if (lexer->errors != errors) {
+            if (chunk->marks_size == chunk->marks_cap) {
+                chunk->marks_cap = (chunk->marks_cap > 0) ? chunk->marks_cap * 2 : 16;
+                chunk->marks = realloc(chunk->marks, chunk->marks_cap * sizeof(LexerMark));
+
+                if (!chunk->marks) {
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            chunk->marks[chunk->marks_size++] = (LexerMark){ chunk->tokens->size, errors };
+        }
+
+        if (!more) {
+            break;
+        }
+
+        if (chunk->tokens->size == capacity) {
+            capacity *= 2;
+            chunk->ends = realloc(chunk->ends, capacity * sizeof(size_t));
+
+            if (!chunk->ends) {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        chunk->ends[chunk->tokens->size] = lexer->i;
+        token_stream_push(chunk->tokens, token);
+    }
+
+    chunk->eof = lexer->i < chunk->end;
+
+    return NULL;
+}
+
+static size_t lexer_chunk_diag(LexerChunk* chunk, size_t index) {
+    /*
+    Finds the first of the chunk's diagnostics raised while lexing tokens from provided index on
+    return: its # among the chunk lexer's diagnostics
+    */
+
+    for (size_t m = 0; m < chunk->marks_size; m++) {
+        if (chunk->marks[m].token >= index) {
+            return chunk->marks[m].diag;
+        }
+    }
+
+    return chunk->lexer->errors;
+}
+
+static bool lexer_chunk_kept(LexerChunk* chunk, size_t index) {
+    /*
+    Checks whether the chunk kept the text of every diagnostic (from provided token index on)
+    that still has to be printed; a chunk only keeps its first LEXER_MAX_ERRORS
+    return: false if splicing the chunk in from index would lose diagnostics
+    */
+
+    size_t from = lexer_chunk_diag(chunk, index);
+    size_t left = (chunk->parent->errors < LEXER_MAX_ERRORS) ? LEXER_MAX_ERRORS - chunk->parent->errors : 0;
+    size_t needed = chunk->lexer->errors - from;
+
+    return from + ((needed < left) ? needed : left) <= chunk->lexer->diags;
+}
+
+static void lexer_chunk_flush(LexerChunk* chunk, size_t index) {
+    /*
+    Prints the chunk's held back diagnostics raised while lexing tokens from provided index on
+    */
+
+    lexer_flush_diag(chunk->lexer, lexer_chunk_diag(chunk, index), chunk->parent);
+}
+
+static Lexer* lexer_chunk_resync(Lexer* lexer, LexerChunk* chunk, TokenStream* stream) {
+    /*
+    Re-lexes provided chunk from the true lexer state until the lexer lines up with one of
+    the chunk's speculative tokens (same position), then splices in the rest
+    return: lexer holding the state right after the chunk
+    */
+
+    Token* token;
+
+    while (true) {
+        bool more = lexer_chunk_step(lexer, chunk->end, &token);
+        lexer_flush_diag(lexer, 0, chunk->parent);
+
+        if (!more) {
+            chunk->eof = lexer->i < chunk->end;
+            return lexer;
+        }
+
+        token_stream_push(stream, token);
+
+        // ends are strictly increasing; binary search for the current position
+        size_t lo = 0, hi = chunk->tokens->size;
+
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+
+            if (chunk->ends[mid] < lexer->i) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        // (past the limit of kept diagnostics the rest of the chunk is re-lexed as well)
+        if (lo < chunk->tokens->size && chunk->ends[lo] == lexer->i && lexer_chunk_kept(chunk, lo + 1)) {
+            token_stream_append(stream, chunk->tokens, lo + 1);
+            lexer_chunk_flush(chunk, lo + 1);
+
+            return chunk->lexer;
+        }
+    }
+}
+
+TokenStream* lexer_tokenize_parallel(Lexer* lexer, unsigned int threads) {
+    /*
+    Lexes the whole (remaining) buffer like lexer_tokenize_all, spreading it over provided #
+    of threads (0 uses every online cpu); small buffers are lexed on the calling thread
+    return: stream ending in TOK_EOF, released with token_stream_free
+    */
+
+    if (threads == 0) {
+#if !defined(_WIN32)
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (unsigned int)online : 1;
+#else
+        threads = 1;
+#endif
+    }
+
+    size_t size = lexer->buf_size - lexer->i;
+
+    if (threads > LEXER_MAX_THREADS) {
+        threads = LEXER_MAX_THREADS;
+    }
+
+    if (threads > size / LEXER_PARALLEL_MIN_CHUNK) {
+        threads = (unsigned int)(size / LEXER_PARALLEL_MIN_CHUNK);
+    }
+
+    if (threads <= 1) {
+        return lexer_tokenize_all(lexer);
+    }
+
+    LexerChunk chunks[LEXER_MAX_THREADS] = {0};
+    pthread_t workers[LEXER_MAX_THREADS];
+    bool spawned[LEXER_MAX_THREADS] = {0};
+    unsigned int n = 0;
+
+    // split right after line breaks, close to equal sizes
+    for (unsigned int k = 0; k < threads; k++) {
+        size_t start = lexer->i;
+
+        if (k > 0) {
+            size_t nominal = lexer->i + size / threads * k;
+            char* nl = memchr(lexer->buf + nominal, '\n', lexer->buf_size - nominal);
+
+            start = nl ? (size_t)(nl - lexer->buf) + 1 : lexer->buf_size;
+
+            if (start <= chunks[n - 1].start || start >= lexer->buf_size) {
+                continue;
+            }
+
+            chunks[n - 1].end = start;
+        }
+
+        chunks[n].parent = lexer;
+        chunks[n].start = start;
+        chunks[n].end = lexer->buf_size;
+        n++;
+    }
+
+    for (unsigned int k = 1; k < n; k++) {
+        spawned[k] = pthread_create(&workers[k], NULL, lexer_chunk_lex, &chunks[k]) == 0;
+    }
+
+    lexer_chunk_lex(&chunks[0]);
+
+    for (unsigned int k = 1; k < n; k++) {
+        if (spawned[k]) {
+            pthread_join(workers[k], NULL);
+        } else {
+            lexer_chunk_lex(&chunks[k]);
+        }
+    }
+
+    // stitch
+    size_t total = 1;
+
+    for (unsigned int k = 0; k < n; k++) {
+        total += chunks[k].tokens->size;
+    }
+
+    TokenStream* stream = token_stream_init(lexer->buf, total);
+    Lexer* carry = NULL;
+
+    for (unsigned int k = 0; k < n; k++) {
+        LexerChunk* chunk = &chunks[k];
+
+        if (!carry || carry->i == chunk->first) {
+            token_stream_append(stream, chunk->tokens, 0);
+            lexer_chunk_flush(chunk, 0);
+            carry = chunk->lexer;
+        } else {
+            carry = lexer_chunk_resync(carry, chunk, stream);
+        }
+
+        if (chunk->eof) {
+            break;
+        }
+    }
+
+    lexer->i = carry->i;
+    lexer->c = carry->c;
+
+    token_stream_push(stream, lexer_scan_token(lexer));
+
+    for (unsigned int k = 0; k < n; k++) {
+        token_stream_free(chunks[k].tokens);
+        arena_adopt(&lexer->arena, &chunks[k].lexer->arena); // spliced token values live there
+        lexer_view_free(chunks[k].lexer);
+        free(chunks[k].ends);
+        free(chunks[k].marks);
+    }
+
+    return stream;
+}
+
+Token* lexer_scan_token(Lexer* lexer) {
+    /*
+    Lexes the next token in place, without allocating
+    return: pointer to the lexer owned token (valid until the next token is lexed)
+    */
+
+    // malformed tokens come back as TOK_ERROR (already reported); recovery skips the rest of
+    // the malformed run and lexing goes on in this loop, so garbage input of any size is
+    // handled in constant stack space
+    while (true) {
+        Token* token;
+        lexer_handle_fillers(lexer);
+
+        size_t start = lexer->i;
+
+        if (lexer->c == '\0' || lexer->i >= lexer->buf_size) {
+            return lexer_token_init(lexer, lexer->i, 0, TOK_EOF);
+        } else if (isalpha(lexer->c) || lexer->c == '_') {
+            token = lexer_handle_alpha(lexer);
+        } else if (isdigit(lexer->c)) {
+            token = lexer_handle_numeric(lexer, false);
+        } else {
+            token = lexer_handle_1char(lexer);
+        }
+
+        if (token->type != TOK_ERROR) {
+            return token;
+        }
+
+        if (lexer->i == start) {
+            lexer_advance(lexer, 1);
+        }
+
+        lexer_handle_error(lexer);
+    }
+}
+
+static size_t lexer_line_index(Lexer* lexer, size_t offset) {
+    /*
+    Binary searches the line index for the line holding provided offset
+    return: 0 based index of that line in lexer->lines
+    */
+
+    size_t lo = 0, hi = lexer->lines_size;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (lexer->lines[mid] <= offset) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+unsigned int lexer_line(Lexer* lexer, size_t offset) {
+    /*
+    Resolves the line of provided buffer offset
+    return: 1 based line #
+    */
+
+    return (unsigned int)lexer_line_index(lexer, offset) + 1;
+}
+
+unsigned int lexer_column(Lexer* lexer, size_t offset) {
+    /*
+    Resolves the column of provided buffer offset (in bytes from the line start)
+    return: 1 based column #
+    */
+
+    return (unsigned int)(offset - lexer->lines[lexer_line_index(lexer, offset)]) + 1;
+}
+
+bool lexer_edit(Lexer* lexer, size_t offset, size_t removed, const char* text, size_t inserted) {
+    /*
+    Replaces provided # of bytes of the buffer at offset with inserted bytes of text, moving what
+    follows (a mapped or borrowed buffer is copied to the heap first) and patching the line index
+    from the edit on; the lexer is left at offset, tokens already lexed are left to
+    lexer_retokenize
+    return: false (nothing changed) if the range lies past the end of the buffer
+    */
+
+    if (offset > lexer->buf_size || removed > lexer->buf_size - offset) {
+        return false;
+    }
+
+    size_t size = lexer->buf_size - removed + inserted;
+    size_t tail = lexer->buf_size - offset - removed;
+    SourceBuffer* src = &lexer->src;
+
+    if (src->data == lexer->buf && src->map_size == 0) {
+        if (inserted > removed) {
+            src->data = realloc(src->data, size + 1);
+
+            if (!src->data) {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        memmove(src->data + offset + inserted, src->data + offset + removed, tail);
+    } else {
+        // (mapped files are read-only and borrowed buffers aren't the lexer's to change)
+        char* copy = malloc(size + 1);
 
-    if (!lexer) {
-        exit(EXIT_FAILURE);
+        if (!copy) {
+            exit(EXIT_FAILURE);
+        }
+
+        memcpy(copy, lexer->buf, offset);
+        memcpy(copy + offset + inserted, lexer->buf + offset + removed, tail);
+
+        io_free_file(src);
+        src->data = copy;
     }
 
-    lexer->buf = io_load_file(filename);
-    lexer->buf_size = strlen(lexer->buf);
+    memcpy(src->data + offset, text, inserted);
+    src->data[size] = '\0';
+    src->size = size;
 
+    // line starts up to offset stay, the ones in the removed bytes go, the ones after move
+    size_t first = lexer_line_index(lexer, offset) + 1;
+    size_t after = lexer_line_index(lexer, offset + removed) + 1;
+    size_t added = 0;
 
-    lexer->i = 0;
-    lexer->c = lexer->buf[lexer->i];
-    
-    lexer->cc = 1;
-    lexer->cl = 1;
+    for (size_t i = 0; i < inserted; i++) {
+        i += scanner.line(text + i, inserted - i);
+        added += (i < inserted);
+    }
 
-    return (Lexer*)lexer;
-}
+    size_t lines_size = first + added + (lexer->lines_size - after);
 
-void lexer_free(Lexer* lexer) {
-    /*
-    De-initializes provided lexer
-    */
+    if (lines_size > lexer->lines_size) {
+        lexer->lines = realloc(lexer->lines, lines_size * sizeof(size_t));
 
-    if (!lexer) {
-        return;
-        exit(EXIT_FAILURE);
+        if (!lexer->lines) {
+            exit(EXIT_FAILURE);
+        }
     }
 
-    free(lexer->buf);
-    free(lexer);
-
-    lexer = NULL;
-}
+    memmove(lexer->lines + first + added, lexer->lines + after, (lexer->lines_size - after) * sizeof(size_t));
 
-Token* lexer_token_init(Lexer* lexer, char* value, uint8_t type) {
-    /*
-    Initializes token with provided values 
-    return: pointer to a propperly initalized token struct
-    */
+    for (size_t k = first + added; k < lines_size; k++) {
+        lexer->lines[k] = lexer->lines[k] - removed + inserted;
+    }
 
-    Token* token = calloc(1, sizeof(Token));
+    for (size_t i = 0, k = first; i < inserted; i++) {
+        i += scanner.line(text + i, inserted - i);
 
-    if (!token) {
-        exit(EXIT_FAILURE);
+        if (i < inserted) {
+            lexer->lines[k++] = offset + i + 1;
+        }
     }
 
-    token->type = type;  
-    token->col = lexer->cc;
-    token->line = lexer->cl;
+    lexer->lines_size = lines_size;
+    lexer->buf = src->data;
+    lexer->buf_size = size;
 
-    token->value = strdup(value);
+    lexer->i = offset;
+    lexer->c = lexer->buf[lexer->i];
 
-    return (Token*)token;
+    return true;
 }
 
-void token_free(Token* token) {
+size_t lexer_retokenize(Lexer* lexer, TokenStream* stream, size_t from, size_t edit_end, ptrdiff_t delta, size_t* lexed) {
     /*
-    De-initializes provided token
+    Lexes provided stream again from its token at index from on, after lexer_edit changed the
+    buffer (nothing before that token changed, from 0 on the whole buffer is lexed; the old text
+    from edit_end - delta on moved to edit_end), until the lexer lines up with the start of an
+    old token past the edit: from there on lexing would give the old tokens again, so they are
+    kept (moved by delta bytes) and only the tokens before are replaced
+    return: # of old tokens replaced from index from on; *lexed is # of tokens replacing them
     */
 
-    if (!token) {
-        exit(EXIT_FAILURE);
-        return;
-    }
+    TokenStream* fresh = token_stream_init(lexer->buf, 64);
+    size_t until = stream->size;
 
-    free(token->value);
-    free(token);
+    lexer->i = (from > 0) ? stream->offset[from] : 0;
+    lexer->c = lexer->buf[lexer->i];
 
-    token = NULL;
-}
+    while (true) {
+        lexer_handle_fillers(lexer);
 
-Token* lexer_next_token(Lexer* lexer) {
-    Token* token;
-    lexer_handle_fillers(lexer);
+        if (lexer->i >= edit_end) {
+            size_t old = (size_t)((ptrdiff_t)lexer->i - delta);
+            size_t lo = from, hi = stream->size;
 
-    if (lexer->c == '\0' || lexer->i >= lexer->buf_size) {
-        token = lexer_token_init(lexer, "\0", TOK_EOF);
-    } else if (isalpha(lexer->c) || lexer->c == '_') {
-        token = lexer_handle_alpha(lexer);
-    } else if (isdigit(lexer->c)) {
-        token = lexer_handle_numeric(lexer, false);
-    } else {
-        token = lexer_handle_1char(lexer);
-        if (token->type == TOK_ERROR) {
-            lexer_handle_error(lexer);
-            return lexer_next_token(lexer);
+            // offsets ascend; binary search the old tokens for the lexer's position
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+
+                if (stream->offset[mid] < old) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+
+            if (lo < stream->size && stream->offset[lo] == old) {
+                until = lo;
+                break;
+            }
+        }
+
+        Token* token = lexer_scan_token(lexer);
+        token_stream_push(fresh, token);
+
+        if (token->type == TOK_EOF) {
+            break;
         }
     }
 
-    return token;
+    for (size_t i = until; i < stream->size; i++) {
+        stream->offset[i] = (size_t)((ptrdiff_t)stream->offset[i] + delta);
+    }
+
+    stream->buf = lexer->buf;
+    token_stream_splice(stream, from, until - from, fresh);
+
+    *lexed = fresh->size;
+    token_stream_free(fresh);
+
+    return until - from;
 }
 
 char* lexer_peek(Lexer* lexer, int8_t offset) {
@@ -164,43 +1103,57 @@ void lexer_advance(Lexer* lexer, uint8_t offset) {
     Advances current lexer position by provided # of charachters; returns NULL if EOF
     */
 
-    if (lexer->buf[lexer->i + offset] == '\0' || lexer->i + offset >= lexer->buf_size) {
+    if (lexer->i >= lexer->buf_size) {
         return;
     }
 
     lexer->i += offset;
-    lexer->cc += 1;
-    lexer->c = lexer->buf[lexer->i];
+
+    if (lexer->i > lexer->buf_size) {
+        lexer->i = lexer->buf_size;
+    }
+
+    lexer->c = (lexer->i < lexer->buf_size) ? lexer->buf[lexer->i] : '\0';
+}
+
+void lexer_skip(Lexer* lexer, size_t count) {
+    /*
+    Advances current lexer position by a run of provided # of charachters (as measured by one
+    of the scanners)
+    */
+
+    if (count == 0) {
+        return;
+    }
+
+    lexer->i += count;
+    lexer->c = (lexer->i < lexer->buf_size) ? lexer->buf[lexer->i] : '\0';
 }
 
 void lexer_handle_error(Lexer* lexer) {
+    /*
+    Recovers from a malformed token by skipping to the next ';', blank or line break
+    */
+
     while (lexer->c != ';' && lexer->c != '\0' && lexer->c != ' ' && lexer->c != '\n' &&
-           lexer->c != '\v' && lexer->c != '\t' && lexer->buf[lexer->i + 1] != '\0' &&
-           lexer->i + 1 < lexer->buf_size) {
+           lexer->c != '\v' && lexer->c != '\t' && lexer->i < lexer->buf_size) {
         lexer_advance(lexer, 1);
     }
 }
 
 void lexer_handle_fillers(Lexer* lexer) {
     /*
-    Skips un-importaint values (whitespace, newline, horizontal/vertical tab)
+    Skips un-importaint values (whitespace, carriage return, newline, horizontal/vertical tab)
     */
 
-    switch (lexer->c) {
-        case ' ':
-            lexer_advance(lexer, 1);
-            break;
-        case '\n':
-        case '\v':
-            lexer->cl += 1;
-            lexer_advance(lexer, 1);
-            lexer->cc = 1;
-            break;
-        case '\t':
-            lexer_advance(lexer, 2);
-            break;
-        default:
+    while (lexer->i < lexer->buf_size) {
+        lexer_skip(lexer, scanner.blanks(lexer->buf + lexer->i, lexer->buf_size - lexer->i));
+
+        if (lexer->c != '\n' && lexer->c != '\v') {
             break;
+        }
+
+        lexer_advance(lexer, 1);
     }
 }
 
@@ -210,44 +1163,29 @@ Token* lexer_handle_alpha(Lexer* lexer) {
     return: identifiers and keywords
     */
 
-    char* buf = calloc(1, sizeof(char));
+    size_t start = lexer->i;
 
-    while (isalnum(lexer->c) || lexer->c == '_') {
-        buf = realloc(buf, (strlen(buf) + 2) * sizeof(char));
-        
-        if (!buf) {
-            exit(EXIT_FAILURE);
-        }
-        
-        if (strlen(buf) > MAX_IDENTIFIER_LEN) {
-            REPORT_ERROR(lexer, "E_SHORTER_LENIDEN", MAX_IDENTIFIER_LEN);
-            lexer_handle_error(lexer);
-            return lexer_next_token(lexer);
-        }
+    lexer_skip(lexer, scanner.iden(lexer->buf + lexer->i, lexer->buf_size - lexer->i));
 
-        strcat(buf, (char[]){lexer->c, '\0'}); 
-        lexer_advance(lexer, 1);
-    } 
+    size_t len = lexer->i - start;
 
-    if (strlen(buf) > MAX_KEYWORD_LEN) {
-        // early check to avoid keyword checking loop
-        return lexer_token_init(lexer, buf, TOK_IDEN);
+    if (len > MAX_IDENTIFIER_LEN) {
+        REPORT_ERROR(lexer, "E_SHORTER_LENIDEN", MAX_IDENTIFIER_LEN);
+        return lexer_token_init(lexer, start, len, TOK_ERROR);
     }
 
-    uint8_t KWCHAR_TYPE_MAP[NO_OF_KEYWORDS] = {
-        TOK_AS, TOK_ATTR, TOK_BOOL, TOK_CHAR, TOK_CLASS, TOK_CONST, TOK_DOUBLE, TOK_ENUM, TOK_EXT,
-        TOK_FALSE, TOK_FLOAT, TOK_FN, TOK_FROM, TOK_GLOB, TOK_IMPORT, TOK_INT, TOK_L_LONG, TOK_LONG, TOK_MUT,
-        TOK_PRIV, TOK_PUB, TOK_RETURN, TOK_SHORT, TOK_S_SHORT, TOK_SIZE, TOK_STRING, TOK_STRUCT, TOK_TRUE, TOK_UINT, TOK_VAR,
-        TOK_IF, TOK_ELIF, TOK_ELSE, TOK_FOR, TOK_WHILE, TOK_SWITCH, TOK_CASE, TOK_TRY, TOK_EXCEPT, TOK_FINALLY, TOK_BREAK, TOK_CONTINUE, TOK_ERR, TOK_THROW, TOK_DEFAULT
-    };
+    if (len <= MAX_KEYWORD_LEN) {
+        uint8_t type = lexer_match_keyword(lexer->buf + start, len);
 
-    for (uint8_t i = 0; i < NO_OF_KEYWORDS ; i++) {
-        if (strcmp(KEYWORDS[i], buf) == 0) {
-            return lexer_token_init(lexer, buf, KWCHAR_TYPE_MAP[i]);
+        if (type != TOK_IDEN) {
+            return lexer_token_init(lexer, start, len, type);
         }
     }
 
-    return lexer_token_init(lexer, buf, TOK_IDEN);
+    Token* token = lexer_token_init(lexer, start, len, TOK_IDEN);
+    token->atom = intern_atom_cached(&lexer->atoms, lexer->buf + start, len);
+
+    return token;
 }
 
 Token* lexer_handle_numeric(Lexer* lexer, bool is_negative) {
@@ -257,48 +1195,64 @@ Token* lexer_handle_numeric(Lexer* lexer, bool is_negative) {
     */
    
     int type = TOK_ERROR;
-    __uint8_t npre_decimal = 0;
-    char* buf = calloc(2, sizeof(char));
-
-    if (!buf) {
-        exit(EXIT_FAILURE);
-    }
+    size_t start = lexer->i;
+    size_t separators = 0;
 
     if (is_negative) {
         // register sign
-        strcat(buf, (char[]){'-', '\0'}); 
         lexer_advance(lexer, 1);
     }
 
-    lexer_process_digits(lexer, &buf, false);
-    type = lexer_process_int_type(buf);
-    
+    bool valid = lexer_process_digits(lexer, &separators, false);
 
-    if (lexer->c == '.') {
+    if (valid && lexer->c == '.') {
         // register decimal
-        buf = realloc(buf, (strlen(buf) + 2) * sizeof(char));
-        
-        if (!buf) {
-            exit(EXIT_FAILURE);
-        }
-
-        strcat(buf, (char[]){lexer->c, '\0'});
         lexer_advance(lexer, 1);
 
-        npre_decimal = strlen(buf); // # of digits before decimal
+        size_t decimal_start = lexer->i;
+        size_t pre_decimal = separators; // # of separators before decimal
 
-        lexer_process_digits(lexer, &buf, true);
+        valid = lexer_process_digits(lexer, &separators, true);
 
-        type = lexer_process_decimal_type(buf, (strlen(buf) - npre_decimal));
+        type = lexer_process_decimal_type(lexer->buf + decimal_start, lexer->i - decimal_start,
+            (lexer->i - decimal_start) - (separators - pre_decimal));
+    }
+
+    size_t len = lexer->i - start;
+    char digits[MAX_NUMERIC_LIT_LEN + 1];
+    __uint128_t value = 0;
+
+    if (!valid || len - separators > MAX_NUMERIC_LIT_LEN) {
+        type = TOK_ERROR;
+    } else if (type == TOK_ERROR) {
+        type = lexer_process_int_type(lexer->buf + start, len, &value);
+    } else if (separators > 0) {
+        // copy decimals out without separators for the parser's strtof/strtod
+        size_t n = 0;
+
+        for (size_t i = start; i < lexer->i; i++) {
+            if (lexer->buf[i] != '_' && lexer->buf[i] != '\'') {
+                digits[n++] = lexer->buf[i];
+            }
+        }
+
+        digits[n] = '\0';
     }
 
     if (type == TOK_ERROR) {
         REPORT_ERROR(lexer, "U_NUM_LIT_TYPE");
-        lexer_handle_error(lexer);
-        return lexer_next_token(lexer);
+        return lexer_token_init(lexer, start, len, TOK_ERROR);
+    }
+
+    Token* token = lexer_token_init(lexer, start, len, type);
+
+    if (IS_INT_LITERAL(type)) {
+        token->num = value;
+    } else if (separators > 0) {
+        token->value = arena_strndup(&lexer->arena, digits, len - separators);
     }
 
-    return lexer_token_init(lexer, buf, type);
+    return token;
 }
 
 Token* lexer_handle_1char(Lexer* lexer) {
@@ -347,34 +1301,34 @@ Token* lexer_handle_1char(Lexer* lexer) {
                 '=', '\0', TOK_PERC, TOK_PERC_EQ, TOK_ERROR);
             break;
         case '&':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, "&", TOK_AMPER);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_AMPER);
             break;
         case '.':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, ".", TOK_PERIOD);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_PERIOD);
             break;
         case ',':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, ",", TOK_COMMA);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_COMMA);
             break;
         case ';':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, ";", TOK_SC);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_SC);
             break;
         case '(':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, "(", TOK_LPAREN);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_LPAREN);
             break;
         case ')':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, ")", TOK_RPAREN);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_RPAREN);
             break;
         case '{':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, "{", TOK_LBRACE);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_LBRACE);
             break;
         case '}':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, "}", TOK_RBRACE);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_RBRACE);
             break;
         case '[':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, "[", TOK_LBRACK);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_LBRACK);
             break;
         case ']':
-            lexer_advance(lexer, 1); return lexer_token_init(lexer, "]", TOK_RBRACK);
+            lexer_advance(lexer, 1); return lexer_token_init(lexer, lexer->i - 1, 1, TOK_RBRACK);
             break;
         case '-':
             return lexer_process_minus_op(lexer, next_char);
@@ -389,43 +1343,44 @@ Token* lexer_handle_1char(Lexer* lexer) {
             break;
     }
 
-    return lexer_next_token(lexer);
+    // unknown charachter: report and skip it, the caller recovers from the error token
+    REPORT_ERROR(lexer, "U_UNKNOWN_CHAR", lexer->c);
+    lexer_advance(lexer, 1);
+
+    return lexer_token_init(lexer, lexer->i - 1, 1, TOK_ERROR);
 }
 
-void lexer_process_digits(Lexer* lexer, char** buf, bool has_decimal) {
+bool lexer_process_digits(Lexer* lexer, size_t* separators, bool has_decimal) {
+    /*
+    Consumes a run of digits (and float/double suffixes when has_decimal) allowing single
+    '_' or '\'' separators between digits
+    return: false if a separator or decimal point was misplaced
+    */
 
-    while (isdigit(lexer->c) ||
-           ((lexer->c == 'f' || lexer->c == 'F' || lexer->c == 'd' || lexer->c == 'D') && has_decimal == true)) {
-        size_t len = strlen(*buf);
-        *buf = realloc(*buf, (len + 2) * sizeof(char));
+    while (true) {
+        lexer_skip(lexer, scanner.digits(lexer->buf + lexer->i, lexer->buf_size - lexer->i));
 
-        if (!*buf) {
-            exit(EXIT_FAILURE);
+        while (isdigit(lexer->c) ||
+               ((lexer->c == 'f' || lexer->c == 'F' || lexer->c == 'd' || lexer->c == 'D') && has_decimal == true)) {
+            lexer_advance(lexer, 1);
         }
 
-        (*buf)[len] = lexer->c;
-        (*buf)[len + 1] = '\0';
-
-
-        lexer_advance(lexer, 1);
-    }
+        if (lexer->c == '_' || lexer->c == '\'') {
+            if (isdigit(lexer_peep(lexer, -1)) && isdigit(lexer_peep(lexer, 1))) {
+                lexer_advance(lexer, 1);
+                *separators += 1;
+                continue;
+            }
 
-    if (lexer->c == '_' || lexer->c == '\'') {
-        if (isdigit(lexer_peep(lexer, -1)) && isdigit(lexer_peep(lexer, 1))) {
-            lexer_advance(lexer, 1);
-            lexer_process_digits(lexer, buf, has_decimal);
-        } else {
-            free(*buf);
-            lexer_handle_error(lexer);
+            return false;
         }
-    } else if (lexer->c == '.' && has_decimal) {
-        free(*buf);
-        lexer_handle_error(lexer);
+
+        return !(lexer->c == '.' && has_decimal);
     }
 }
 
 
-uint8_t lexer_process_decimal_type(char* buf, uint8_t diadc) {
+uint8_t lexer_process_decimal_type(const char* buf, size_t len, uint8_t diadc) {
     /*
     Processes provided buffer and resolves type; TOK_ERROR if invalid
     return: TOK_ERROR, TOK_L_FLOAT (32-bit float), or TOK_L_DOUBLE (64-bit float)
@@ -434,7 +1389,7 @@ uint8_t lexer_process_decimal_type(char* buf, uint8_t diadc) {
     bool has_Fpfx = false; // has float prefix
     bool has_Dpfx = false; // has double prefix
 
-    for (uint8_t i = 0; i < strlen(buf); i++) {
+    for (size_t i = 0; i < len; i++) {
         if (buf[i] == 'f' || buf[i] == 'F') {
             if (has_Fpfx) { 
                 return TOK_ERROR;
@@ -464,25 +1419,59 @@ uint8_t lexer_process_decimal_type(char* buf, uint8_t diadc) {
 }
 
 
-uint8_t lexer_process_int_type(char* buf) {
+uint8_t lexer_process_int_type(const char* buf, size_t len, __uint128_t* value) {
     /*
-	Processes provided buf-fer and resolutes type; TOK_ERROR if invalid
-	return: TOK_ERROR, TOK_L_(S|SS|L|LL)INT or TOK_L_(S|SS|L|LL)UINT 
-	*/
+    Parses provided literal (optional '-', digits and separators) in a single pass into value
+    (two's complement when negative) and resolves the narrowest type that holds it
+    return: TOK_ERROR on overflow, TOK_L_(SS|S|L|LL)INT/TOK_L_INT for negative literals or
+    TOK_L_(SS|S|L|LL)UINT/TOK_L_UINT otherwise
+    */
+
+    bool is_negative = len > 0 && buf[0] == '-';
+    __uint128_t magnitude = 0;
+
+    for (size_t i = is_negative; i < len; i++) {
+        if (buf[i] == '_' || buf[i] == '\'') {
+            continue;
+        }
+
+        unsigned int digit = (unsigned int)(buf[i] - '0');
+
+        if (digit > 9 || magnitude > (~(__uint128_t)0 - digit) / 10) {
+            return TOK_ERROR;
+        }
 
-    int64_t signed_val;
-    uint64_t unsigned_val;
+        magnitude = magnitude * 10 + digit;
+    }
+
+    if (!is_negative || magnitude == 0) {
+        *value = magnitude;
+
+        if (magnitude <= UINT8_MAX) {
+            return TOK_L_SSUINT;
+        } else if (magnitude <= UINT16_MAX) {
+            return TOK_L_SUINT;
+        } else if (magnitude <= UINT32_MAX) {
+            return TOK_L_UINT;
+        } else if (magnitude <= UINT64_MAX) {
+            return TOK_L_LUINT;
+        }
+
+        return TOK_L_LLUINT;
+    }
 
-    if (sscanf(buf, "%ld" SCNd64, &signed_val) == 1) {
-        return (signed_val >= 0) ? TOK_L_LUINT : TOK_L_LINT;
-    } else if (sscanf(buf, "%ld" SCNu64, &unsigned_val) == 1) {
-        return (unsigned_val >= 0) ? TOK_L_LLUINT : TOK_ERROR;
-    } else if (sscanf(buf, "%ld" SCNd32, &signed_val) == 1) {
-        return (signed_val >= 0) ? TOK_L_UINT : TOK_L_INT;
-    } else if (sscanf(buf, "%ld" SCNd16, &signed_val) == 1) {
-        return (signed_val >= 0) ? TOK_L_SUINT : TOK_L_SINT;
-    } else if (sscanf(buf, "%ld" SCNd8, &signed_val) == 1) {
-        return (signed_val >= 0) ? TOK_L_SSUINT : TOK_L_SSINT;
+    *value = (__uint128_t)0 - magnitude;
+
+    if (magnitude <= (__uint128_t)1 << 7) {
+        return TOK_L_SSINT;
+    } else if (magnitude <= (__uint128_t)1 << 15) {
+        return TOK_L_SINT;
+    } else if (magnitude <= (__uint128_t)1 << 31) {
+        return TOK_L_INT;
+    } else if (magnitude <= (__uint128_t)1 << 63) {
+        return TOK_L_LINT;
+    } else if (magnitude <= (__uint128_t)1 << 127) {
+        return TOK_L_LLINT;
     }
 
     return TOK_ERROR;
@@ -492,128 +1481,180 @@ Token* lexer_process_pos_singlechar(Lexer* lexer, char next_char,
     char c_pos1, char c_pos2,
     uint8_t t_pos0, uint8_t t_pos1, uint8_t t_pos2) {
 
-    char c_pos0 = lexer->c;
-
     if (next_char == c_pos1) {
         lexer_advance(lexer, 2);
-        return lexer_token_init(lexer, (char*)(&(char[]){c_pos0, c_pos1, '\0'}), t_pos1);
+        return lexer_token_init(lexer, lexer->i - 2, 2, t_pos1);
     } else if ((next_char == c_pos2) && (c_pos2 != '\0')){
         lexer_advance(lexer, 2);
-        return lexer_token_init(lexer, (char*)(&(char[]){c_pos0, c_pos2, '\0'}), t_pos2);
+        return lexer_token_init(lexer, lexer->i - 2, 2, t_pos2);
     }
 
     lexer_advance(lexer, 1);
-    return lexer_token_init(lexer, (char*)(&(char[]){c_pos0, '\0'}), t_pos0);
+    return lexer_token_init(lexer, lexer->i - 1, 1, t_pos0);
 }
                     
 Token* lexer_process_minus_op(Lexer* lexer, char next_char) {
     if (next_char == '=') {
         lexer_advance(lexer, 2);
-        return lexer_token_init(lexer, "-=", TOK_MINUS_EQ);
+        return lexer_token_init(lexer, lexer->i - 2, 2, TOK_MINUS_EQ);
     } else if (next_char == '-') {
         lexer_advance(lexer, 2);
-        return lexer_token_init(lexer, "--", TOK_MINUS_MINUS);
+        return lexer_token_init(lexer, lexer->i - 2, 2, TOK_MINUS_MINUS);
     } else if isdigit(next_char) {
         return lexer_handle_numeric(lexer, true);
     }
 
     lexer_advance(lexer, 1);
-    return lexer_token_init(lexer, "-", TOK_MINUS);
+    return lexer_token_init(lexer, lexer->i - 1, 1, TOK_MINUS);
 }
 
 Token* lexer_process_single_quote(Lexer* lexer) {
     lexer_advance(lexer, 1); // consume '
 
-    char* value = calloc(2, sizeof(char));
-    if (!value) {
-        exit(EXIT_FAILURE);
+    size_t start = lexer->i;
+    char value[5];
+    size_t len = 0;
+
+    if (lexer->c == '\\') {
+        lexer_process_escape_code(lexer, value, &len);
+    } else if (lexer->c != '\0') {
+        lexer_advance(lexer, 1); // consume char
     }
-    value[0] = lexer->c;
-    value[1] = '\0';
 
-    lexer_advance(lexer, 1); // consume char
+    if (lexer->c == '\'' && lexer->i > start) {
+        size_t end = lexer->i;
+        lexer_advance(lexer, 1); // consume '
 
-    char next_char = (lexer_peek(lexer, 1))[0];
+        Token* token = lexer_token_init(lexer, start, end - start, TOK_L_CHAR);
 
-    if (next_char == '\\') {
-        lexer_advance(lexer, 1); // consume '\'
-        lexer_process_escape_code(lexer, &value);
-    }
+        if (len > 0) {
+            token->value = arena_strndup(&lexer->arena, value, len);
+        }
 
-    if (lexer->c == '\'') {
-        lexer_advance(lexer, 1); // consume '
-        return lexer_token_init(lexer, value, TOK_L_CHAR);
+        return token;
     }
 
     REPORT_ERROR(lexer, "E_CHAR_TERMINATOR");
-    lexer_handle_error(lexer);
-    return lexer_next_token(lexer);
+    return lexer_token_init(lexer, start, lexer->i - start, TOK_ERROR);
 }
 
 Token* lexer_process_double_quote(Lexer* lexer) {
     lexer_advance(lexer, 1); // consume "
     
-    char* value = calloc(1, sizeof(char) + 1);
+    size_t start = lexer->i;
 
-    if (!value) {
-        exit(EXIT_FAILURE);
-    }
+    lexer_process_string_run(lexer);
 
-    while (lexer->c != '"' && lexer->c != '\0') {
-        if (lexer->c == '\\') {
-            lexer_advance(lexer, 1); // consume '\'
-            lexer_process_escape_code(lexer, &value);
-        } else {
-            value = realloc(value, (strlen(value) + 2) * sizeof(char));
-            
-            if (!value) {
-                exit(EXIT_FAILURE);
+    char* value = NULL;
+
+    if (lexer->c == '\\') {
+        // escaped literal: decode into the arena; decoding never lengthens the text, so the raw
+        // extent of the literal (up to the first unescaped '"') bounds the value
+        size_t extent = lexer->i;
+
+        while (extent < lexer->buf_size && lexer->buf[extent] == '\\') {
+            extent += 2;
+
+            if (extent < lexer->buf_size) {
+                extent += scanner.string(lexer->buf + extent, lexer->buf_size - extent);
+            }
+        }
+
+        size_t len = lexer->i - start;
+        value = arena_alloc(&lexer->arena, ((extent < lexer->buf_size) ? extent : lexer->buf_size) - start + 1);
+        memcpy(value, lexer->buf + start, len);
+
+        while (lexer->c != '"' && lexer->c != '\0') {
+            if (lexer->c == '\\') {
+                lexer_process_escape_code(lexer, value, &len);
+                continue;
             }
-            
-            strncat(value, &(lexer->c), 1);
-            lexer_advance(lexer, 1); // consume char
+
+            size_t run_start = lexer->i;
+            lexer_process_string_run(lexer);
+
+            memcpy(value + len, lexer->buf + run_start, lexer->i - run_start);
+            len += lexer->i - run_start;
         }
+
+        value[len] = '\0';
     }
 
     if (lexer->c == '"') {
-        lexer_advance(lexer, 1);
-        return lexer_token_init(lexer, value, TOK_L_STRING);
+        size_t end = lexer->i;
+        lexer_advance(lexer, 1); // consume "
+
+        Token* token = lexer_token_init(lexer, start, end - start, TOK_L_STRING);
+        token->value = value;
+
+        return token;
     }
 
     REPORT_ERROR(lexer, "E_STRING_TERMINATOR");
-    lexer_handle_error(lexer);
-    return lexer_next_token(lexer);
+    return lexer_token_init(lexer, start, lexer->i - start, TOK_ERROR);
+}
+
+void lexer_process_string_run(Lexer* lexer) {
+    /*
+    Consumes string literal contents up to the next '"', '\\' or the end of the buffer; line
+    breaks are consumed as well since string literals may span lines
+    */
+
+    lexer_skip(lexer, scanner.string(lexer->buf + lexer->i, lexer->buf_size - lexer->i));
 }
 
-void lexer_process_escape_code(Lexer* lexer, char** buf) {
-    char next_char = (lexer_peek(lexer, 1))[0];
-    char esc_chars[12] = "\n\r\t\b\a\f\\\'\"\0";
+void lexer_process_escape_code(Lexer* lexer, char* buf, size_t* len) {
+    /*
+    Decodes the escape sequence at the current '\' into buf (at most 4 bytes are written)
+    */
+
+    lexer_advance(lexer, 1); // consume '\'
 
-    if (next_char == 'x' || next_char == 'u') {
-        int len = (next_char == 'x') ? 5 : 7; 
-        char digits[5];
-        char* peeked_digits = lexer_peek(lexer, len - 1);
+    char code = lexer->c;
+    int digits = (code == 'x') ? 2 : (code == 'u') ? 4 : 0;
 
-        if (peeked_digits && isxdigit(peeked_digits[0]) && isxdigit(peeked_digits[1])) {
-            strncpy(digits, peeked_digits, len - 1);
-            digits[len - 1] = '\0';
-            strncat(*buf, digits, len - 1);
-            lexer_advance(lexer, len);
-        } else {
-            strncat(*buf, &lexer->c, 1);
-            lexer_advance(lexer, 2);
+    if (digits) {
+        uint32_t point = 0;
+        int n = 0;
+
+        while (n < digits && isxdigit(lexer_peep(lexer, n + 1))) {
+            char h = lexer_peep(lexer, n + 1);
+            point = (point << 4) | (uint32_t)(isdigit(h) ? h - '0' : (tolower(h) - 'a' + 10));
+            n++;
         }
 
-        free(peeked_digits);
-    } else if (strchr(esc_chars, next_char)) {
-        *buf = realloc(*buf, (strlen(*buf) + 2) * sizeof(char));
-        if (!*buf) exit(EXIT_FAILURE);
-        strcat(*buf, (char[]){'\\', next_char, '\0'});
-        lexer_advance(lexer, 2);
-    } else {
-        strncat(*buf, &lexer->c, 1);
-        lexer_advance(lexer, 2);
+        if (n == digits) {
+            lexer_advance(lexer, digits + 1);
+
+            if (point < 0x80 || code == 'x') {
+                buf[(*len)++] = (char)point;
+            } else if (point < 0x800) {
+                buf[(*len)++] = (char)(0xC0 | (point >> 6));
+                buf[(*len)++] = (char)(0x80 | (point & 0x3F));
+            } else {
+                buf[(*len)++] = (char)(0xE0 | (point >> 12));
+                buf[(*len)++] = (char)(0x80 | ((point >> 6) & 0x3F));
+                buf[(*len)++] = (char)(0x80 | (point & 0x3F));
+            }
+
+            return;
+        }
+    }
+
+    switch (code) {
+        case 'n': buf[(*len)++] = '\n'; break;
+        case 'r': buf[(*len)++] = '\r'; break;
+        case 't': buf[(*len)++] = '\t'; break;
+        case 'b': buf[(*len)++] = '\b'; break;
+        case 'a': buf[(*len)++] = '\a'; break;
+        case 'f': buf[(*len)++] = '\f'; break;
+        case 'v': buf[(*len)++] = '\v'; break;
+        case '0': buf[(*len)++] = '\0'; break;
+        case '\0': return; // unterminated, leave the '\0' for the caller
+        default: buf[(*len)++] = code; break; // \\, \', \" and unknown codes stand for themselves
     }
+
+    lexer_advance(lexer, 1); // consume code
 }
 
 struct ErrorTemplate templates[] = {
@@ -621,27 +1662,26 @@ struct ErrorTemplate templates[] = {
     {"U_NUM_LIT_TYPE", "Unexpected numeric literal found - accepted formats: docs::literals::numeric"},
     {"U_DB_SOURCE_DECL", "Unexpected double source declration, first sourced: '%s' again: '%s' - expects: single 'from' statement"},
     {"U_MODULE_MULT_ALIAS", "Unexpected attempt to alias %d seperate identifiers into single '%s' - find proper syntax: docs::imports"},
+    {"U_UNKNOWN_CHAR", "Unexpected charachter '%c' found"},
 
     {"E_SHORTER_LENIDEN", "Expected a shorter identifier length - configuration expects: <= %d"},
     {"E_CHAR_TERMINATOR", "Expected a (') character literal terminator after starting of character literal"},
     {"E_STRING_TERMINATOR", "Expected a (\") string literal terminator after starting of string literal"},
     {"E_DTS_FN_PARAM", "Expected a valid data type specifier while specifying parameters for a function, '%s' needs a type"},
     {"E_MEP_MATCH_LBRACK", "Expected a '}' to match brackets for MEP, found '%s'"},
-    {"E_PROP_EXP", "Expected a propper expression, got '%s'"}
+    {"E_PROP_EXP", "Expected a propper expression, got '%s'"},
+    {"E_UNEXPECTED_EOF", "Expected more of the declaration, the source ended before it did"}
 };
 
 char* lexer_get_reference(Lexer* lexer) {
-    size_t line_start = lexer->i;
-
-    while (line_start > 0 && lexer->buf[line_start - 1] != '\n') {
-        line_start--;
-    }
-
-    size_t line_end = lexer->i;
+    /*
+    Copies out the source line holding the current lexer position
+    return: '\0' terminated line without its line break
+    */
 
-    while (lexer->buf[line_end] != '\0' && lexer->buf[line_end] != '\n') {
-        line_end++;
-    }
+    size_t line = lexer_line_index(lexer, lexer->i);
+    size_t line_start = lexer->lines[line];
+    size_t line_end = (line + 1 < lexer->lines_size) ? lexer->lines[line + 1] - 1 : lexer->buf_size;
 
     size_t line_length = line_end - line_start;
     char* line_content = (char*)malloc((line_length + 2) * sizeof(char));
@@ -658,34 +1698,169 @@ char* lexer_get_reference(Lexer* lexer) {
     return line_content;
 }
 
+static bool lexer_count_diag(Lexer* lexer) {
+    /*
+    Counts a diagnostic about to be printed against LEXER_MAX_ERRORS, noting once when the
+    limit is passed
+    return: true if the diagnostic should still be printed
+    */
+
+    lexer->errors += 1;
+
+    if (lexer->errors == LEXER_MAX_ERRORS + 1) {
+        printf("[NEX]: more than %d errors, further diagnostics are suppressed\n", LEXER_MAX_ERRORS);
+    }
+
+    return lexer->errors <= LEXER_MAX_ERRORS;
+}
+
+static bool lexer_drop_diag(Lexer* lexer) {
+    /*
+    Counts the next diagnostic without rendering it if it would not be kept anyway, so runs of
+    malformed input past the limit cost no formatting
+    return: true if the diagnostic was dropped
+    */
+
+    if (lexer->diag) {
+        if (lexer->diags < LEXER_MAX_ERRORS) {
+            return false;
+        }
+
+        lexer->errors += 1;
+        return true;
+    }
+
+    if (lexer->errors < LEXER_MAX_ERRORS) {
+        return false;
+    }
+
+    lexer_count_diag(lexer);
+    return true;
+}
+
+static void lexer_print_diag(Lexer* lexer, const char* message, size_t offset) {
+    /*
+    Prints a diagnostic along with the source line holding provided offset (written straight
+    out of the buffer)
+    */
+
+    size_t line = lexer_line_index(lexer, offset);
+    size_t line_start = lexer->lines[line];
+    size_t line_end = (line + 1 < lexer->lines_size) ? lexer->lines[line + 1] - 1 : lexer->buf_size;
+    const char* eol = memchr(lexer->buf + line_start, '\0', line_end - line_start);
+
+    if (eol) {
+        line_end = (size_t)(eol - lexer->buf);
+    }
+
+    printf("[%zu : %zu] > %s\n\t%zu | ", line + 1, offset - line_start + 1, message, line + 1);
+    fwrite(lexer->buf + line_start, sizeof(char), line_end - line_start, stdout);
+    putchar('\n');
+}
+
 void lexer_report_error(Lexer* lexer, char* error_code, ...) {
     if (error_code[0] != 'U' && error_code[0] != 'E') {
         return;
     }
 
+    if (lexer_drop_diag(lexer)) {
+        return;
+    }
+
     for (size_t i = 0; i < (sizeof(templates) / sizeof(templates[0])); i++) {        
         if (strcmp(templates[i].code, error_code) == 0) {
             va_list args;
             va_start(args, error_code);
 
-            char* final_content = malloc(
-                (strlen(templates[i].content) + sizeof(args)) * sizeof(char)
-            );
+            va_list sizing;
+            va_copy(sizing, args);
+            int length = vsnprintf(NULL, 0, templates[i].content, sizing);
+            va_end(sizing);
+
+            char* final_content = malloc(((length > 0) ? (size_t)length + 1 : 1) * sizeof(char));
 
             if (final_content != NULL) {
-                vsprintf(final_content, templates[i].content, args);
+                vsnprintf(final_content, (length > 0) ? (size_t)length + 1 : 1, templates[i].content, args);
             }
 
             va_end(args);
 
-            char* refrence = lexer_get_reference(lexer);
-
-            printf("[%d : %d] > %s\n\t%d | %s\n", lexer->cl, lexer->cc, final_content, lexer->cl, refrence);
+            lexer_emit(lexer, (final_content != NULL) ? final_content : error_code, lexer->i);
             free(final_content);
             return;
         }
     }
 
-    char* refrence = lexer_get_reference(lexer);
-    printf("[%d : %d] > %s\n\t%d | %s\n", lexer->cl, lexer->cc, error_code, lexer->cl, refrence);
-}
\ No newline at end of file
+    lexer_emit(lexer, error_code, lexer->i);
+}
+
+void lexer_emit(Lexer* lexer, const char* message, size_t offset) {
+    /*
+    Prints a diagnostic located at provided buffer offset, or appends it to the lexer's held back
+    diagnostics; only the first LEXER_MAX_ERRORS diagnostics are kept, the rest are counted
+    */
+
+    if (lexer_drop_diag(lexer)) {
+        return;
+    }
+
+    if (!lexer->diag) {
+        if (lexer_count_diag(lexer)) {
+            lexer_print_diag(lexer, message, offset);
+        }
+
+        return;
+    }
+
+    if (lexer->diags == lexer->diag_cap) {
+        lexer->diag_cap *= 2;
+        lexer->diag = realloc(lexer->diag, lexer->diag_cap * sizeof(LexerDiag));
+
+        if (!lexer->diag) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    char* text = strdup(message);
+
+    if (!text) {
+        exit(EXIT_FAILURE);
+    }
+
+    lexer->diag[lexer->diags++] = (LexerDiag){ text, offset };
+    lexer->errors += 1;
+}
+
+void lexer_replay_diag(Lexer* lexer, size_t from, size_t until, Lexer* to) {
+    /*
+    Prints the held back diagnostics from the from-th up to the until-th (excluded), counting
+    them against the limit of lexer to, and keeps them held back
+    */
+
+    for (size_t i = from; i < until; i++) {
+        // diagnostics past the kept ones were only counted
+        if (lexer_count_diag(to) && i < lexer->diags) {
+            lexer_print_diag(lexer, lexer->diag[i].message, lexer->diag[i].offset);
+        }
+    }
+}
+
+void lexer_flush_diag(Lexer* lexer, size_t from, Lexer* to) {
+    /*
+    Prints the held back diagnostics from the from-th on, counting them against the limit of
+    lexer to (the one printing right away), then empties the held back diagnostics
+    */
+
+    if (!lexer->diag) {
+        return;
+    }
+
+    lexer_replay_diag(lexer, from, lexer->errors, to);
+
+    for (size_t i = 0; i < lexer->diags; i++) {
+        free(lexer->diag[i].message);
+    }
+
+    lexer->diags = 0;
+    lexer->errors = 0;
+}
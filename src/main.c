@@ -1,6 +1,9 @@
 #include "codegen.h"
+#include "nexast.h"
+#include "io.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 void print_status(const char* message) {
@@ -8,23 +11,71 @@ void print_status(const char* message) {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
+    // usage: nex [--cache=DIR] file.nex
+    char* file = NULL;
+    char* cache_dir = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--cache=", 8) == 0) {
+            cache_dir = argv[i] + 8;
+        } else {
+            file = argv[i];
+        }
+    }
+
+    if (!file) {
         print_status("ERROR: NO INPUT FILE SPECIFIED");
         return 1;
     }
 
-    Parser* parser = parser_init((char*)argv[1]);
+    // with a cache directory, a file parsed before (and unchanged since) is loaded from its
+    // .nexast image there instead; the source is read once, hashed, then lexed from the same buffer
+    SourceBuffer src = io_load_file(file);
+    uint64_t hash = nexast_hash(src.data, src.size);
+    size_t size = src.size;
+
+    char* cache_path = (cache_dir) ? nexast_path(cache_dir, file) : NULL;
+    NexAst* cache = (cache_path) ? nexast_load(cache_path, hash, size) : NULL;
+    Parser* parser = NULL;
+    AST_Node* root;
+    ASTN_ExprPool* exprs;
+
+    if (cache) {
+        io_free_file(&src);
+        root = cache->root;
+        exprs = cache->exprs;
+    } else {
+        parser = parser_init_from_source(src);
+
+        parser_parse(parser);
+
+        if (parser->lexer->errors > 0) {
+            print_status("ERROR: SOURCE HAS ERRORS, NO PROGRAM GENERATED");
+            free(cache_path);
+            parser_free(parser);
+            return 1;
+        }
+
+        // (diagnostics are only reported while parsing, so only files without any get here)
+        if (cache_path && !nexast_write(cache_path, hash, size, parser->root, &parser->exprs, parser->tbl)) {
+            print_status("WARNING: COULDN'T WRITE THE .nexast CACHE");
+        }
+
+        root = parser->root;
+        exprs = &parser->exprs;
+    }
 
-    parser_parse(parser);
+    free(cache_path);
 
-    SAO(parser->root);
+    SAO(root);
 
-    GEN(parser->root);
+    GEN(root, exprs);
 
     char nasm_cmd[100];
     sprintf(nasm_cmd, "nasm -f elf64 %s.asm -o %s.o", "prog", "prog");
     if (system(nasm_cmd) != 0) {
         parser_free(parser);
+        nexast_free(cache);
         return 1;
     }
 
@@ -32,12 +83,14 @@ int main(int argc, char* argv[]) {
     sprintf(ld_cmd, "ld %s.o -o %s", "prog", "prog");
     if (system(ld_cmd) != 0) {
         parser_free(parser);
+        nexast_free(cache);
         return 1;
     }
 
     remove("prog.o");
 
     parser_free(parser);
+    nexast_free(cache);
 
     print_status("PROGRAM GENERATED SUCCESSFULLY");
 
@@ -0,0 +1,187 @@
+#include "memory.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define ARENA_HEADER ARENA_ROUND(sizeof(ArenaBlock))
+
+static ArenaBlock* arena_block_init(size_t size) {
+    /*
+    Allocates a block with provided # of usable bytes
+    return: pointer to the empty block
+    */
+
+    ArenaBlock* block = malloc(ARENA_HEADER + size);
+
+    if (!block) {
+        exit(EXIT_FAILURE);
+    }
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+void arena_init(Arena* arena) {
+    /*
+    Initializes an empty arena; blocks are only allocated on first use
+    */
+
+    arena->head = NULL;
+    arena->allocated = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    /*
+    Carves provided # of bytes (ARENA_ALIGN aligned) out of the arena
+    return: pointer valid until arena_free; never NULL
+    */
+
+    size = ARENA_ROUND((size > 0) ? size : 1);
+    arena->allocated += size;
+
+    ArenaBlock* head = arena->head;
+
+    if (head && head->size - head->used >= size) {
+        void* ptr = (char*)head + ARENA_HEADER + head->used;
+        head->used += size;
+
+        return ptr;
+    }
+
+    if (size > ARENA_BLOCK_SIZE / 4) {
+        // large allocations get a block of their own, kept behind the head so the rest of the
+        // current block is still used
+        ArenaBlock* block = arena_block_init(size);
+        block->used = size;
+
+        if (head) {
+            block->next = head->next;
+            head->next = block;
+        } else {
+            arena->head = block;
+        }
+
+        return (char*)block + ARENA_HEADER;
+    }
+
+    ArenaBlock* block = arena_block_init(ARENA_BLOCK_SIZE);
+    block->next = head;
+    block->used = size;
+    arena->head = block;
+
+    return (char*)block + ARENA_HEADER;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    /*
+    Carves a zeroed array of provided # of elements out of the arena
+    return: pointer valid until arena_free; never NULL
+    */
+
+    if (size > 0 && count > SIZE_MAX / size) {
+        exit(EXIT_FAILURE);
+    }
+
+    void* ptr = arena_alloc(arena, count * size);
+    memset(ptr, 0, count * size);
+
+    return ptr;
+}
+
+static size_t arena_capacity(size_t size) {
+    /*
+    Computes the # of bytes reserved for a growable array of provided size
+    return: size rounded up to a power of two (at least ARENA_ALIGN)
+    */
+
+    size_t capacity = ARENA_ALIGN;
+
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+void* arena_realloc(Arena* arena, void* ptr, size_t size, size_t new_size) {
+    /*
+    Grows an array from size to new_size bytes; ptr must be NULL or come from arena_realloc
+    with provided size. Arrays reserve power of two capacities, so growing one element at a
+    time only moves it log(n) times (the old copy stays in the arena until arena_free)
+    return: pointer to the grown array (ptr itself while it still has room)
+    */
+
+    if (ptr && arena_capacity(size) >= new_size) {
+        return ptr;
+    }
+
+    void* grown = arena_alloc(arena, arena_capacity(new_size));
+
+    if (ptr && size > 0) {
+        memcpy(grown, ptr, size);
+    }
+
+    return grown;
+}
+
+char* arena_strndup(Arena* arena, const char* str, size_t len) {
+    /*
+    Copies provided # of characters of str into the arena
+    return: '\0' terminated copy valid until arena_free
+    */
+
+    char* copy = arena_alloc(arena, len + 1);
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    return copy;
+}
+
+void arena_adopt(Arena* arena, Arena* from) {
+    /*
+    Moves every block of from into arena (keeping arena's head), leaving from empty; used to
+    keep allocations of a short lived arena alive as long as a longer lived one
+    */
+
+    if (!from->head) {
+        return;
+    }
+
+    ArenaBlock* tail = from->head;
+
+    while (tail->next) {
+        tail = tail->next;
+    }
+
+    if (arena->head) {
+        tail->next = arena->head->next;
+        arena->head->next = from->head;
+    } else {
+        arena->head = from->head;
+    }
+
+    arena->allocated += from->allocated;
+    arena_init(from);
+}
+
+void arena_free(Arena* arena) {
+    /*
+    Releases every block of the arena at once, leaving it empty (and reusable)
+    */
+
+    ArenaBlock* block = arena->head;
+
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena_init(arena);
+}
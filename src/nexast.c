@@ -0,0 +1,1051 @@
+#include "nexast.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define NEXAST_ALIGN 16 // alignment of every object of an image (enough for __int128)
+
+// image offset of what ptr points to within an object written at offset at
+#define NEXAST_AT(at, obj, ptr) ((at) + (uint64_t)((const char*)(ptr) - (const char*)(obj)))
+
+// image offset of provided field of an object written at offset at
+#define NEXAST_SLOT(at, obj, field) NEXAST_AT(at, obj, &(obj)->field)
+
+// renumbers the atom of provided ASTN_Iden field of an object written at offset at
+#define NEXAST_IDEN(w, at, obj, field) nexast_atom((w), NEXAST_SLOT(at, obj, field.atom))
+
+// writes the items of provided vector (part of an object written at offset at)
+#define NEXAST_PUT_VEC(w, at, obj, vec) \
+    nexast_put_vec((w), NEXAST_AT(at, obj, &(vec)), AST_VEC_ITEMS(vec), (vec).size, (vec).capacity, sizeof(*AST_VEC_ITEMS(vec)))
+
+typedef AST_VEC(void*) NexAstVec; // layout every vector shares (none holds items aligned past a pointer)
+
+typedef struct NexAstSeen {
+    const void* ptr;
+    uint64_t at;
+} NexAstSeen;
+
+typedef struct NexAstLater {
+    uint64_t slot;
+    const void* ptr;
+} NexAstLater;
+
+typedef struct NexAstWriter {
+    char* buf; // the image being written; pointers in it hold offsets until nexast_write is done
+    size_t size, capacity;
+
+    uint64_t* relocs; // offsets of every pointer of the image
+    size_t relocs_size, relocs_capacity;
+
+    NexAstSeen* seen; // address -> offset of every object written (open addressing)
+    size_t seen_size, seen_capacity;
+
+    NexAstLater* later; // pointers to objects that may only be written further on
+    size_t later_size, later_capacity;
+
+    uint32_t* atom_map; // image atom of each atom of the process; 0 until it's written
+    size_t atom_map_size;
+
+    uint32_t* atoms; // atom of the process of each image atom 1, 2, ... (at index - 1)
+    size_t atoms_size, atoms_capacity;
+
+    uint64_t* atom_slots; // offsets of every atom of the image
+    size_t atom_slots_size, atom_slots_capacity;
+} NexAstWriter;
+
+static uint32_t nexast_layout() {
+    return (uint32_t)((sizeof(void*) << 28) ^ (sizeof(AST_Node) << 18) ^ (sizeof(ASTN_ExprNode) << 14) ^
+        (sizeof(ASTN_Literal) << 7) ^ sizeof(Symbol));
+}
+
+static void* nexast_reserve(void* items, size_t* capacity, size_t count, size_t item_size) {
+    /*
+    Makes room for provided # of items in a writer array, doubling its capacity until they fit
+    return: pointer to the (possibly moved) array
+    */
+
+    if (count <= *capacity) {
+        return items;
+    }
+
+    size_t grown = (*capacity) ? *capacity : 64;
+
+    while (grown < count) {
+        grown *= 2;
+    }
+
+    items = realloc(items, grown * item_size);
+
+    if (!items) {
+        exit(EXIT_FAILURE);
+    }
+
+    *capacity = grown;
+
+    return items;
+}
+
+static uint64_t nexast_put(NexAstWriter* w, const void* data, size_t size) {
+    /*
+    Appends a copy of provided object to the image (zeroes when data is NULL)
+    return: its offset in the image
+    */
+
+    size_t at = (w->size + NEXAST_ALIGN - 1) & ~(size_t)(NEXAST_ALIGN - 1);
+
+    w->buf = nexast_reserve(w->buf, &w->capacity, at + size, 1);
+    memset(w->buf + w->size, 0, at - w->size);
+
+    if (data) {
+        memcpy(w->buf + at, data, size);
+    } else {
+        memset(w->buf + at, 0, size);
+    }
+
+    w->size = at + size;
+
+    return at;
+}
+
+static void nexast_link(NexAstWriter* w, uint64_t slot, uint64_t at) {
+    /*
+    Points the pointer at provided slot to the object written at offset at (NULL when 0)
+    */
+
+    memcpy(w->buf + slot, &at, sizeof(uint64_t));
+
+    if (at) {
+        w->relocs = nexast_reserve(w->relocs, &w->relocs_capacity, w->relocs_size + 1, sizeof(uint64_t));
+        w->relocs[w->relocs_size++] = slot;
+    }
+}
+
+static void nexast_atom(NexAstWriter* w, uint64_t slot) {
+    /*
+    Renumbers the atom at provided slot as the image's own: an image numbers the atoms it holds
+    1, 2, ... as they're first written, and carries their names for nexast_load to map them back
+    */
+
+    uint32_t atom;
+    memcpy(&atom, w->buf + slot, sizeof(uint32_t));
+
+    if (!atom) {
+        return;
+    }
+
+    if (atom >= w->atom_map_size) {
+        size_t size = (size_t)intern_count() + 1;
+
+        size = (size > (size_t)atom + 1) ? size : (size_t)atom + 1;
+        w->atom_map = realloc(w->atom_map, size * sizeof(uint32_t));
+
+        if (!w->atom_map) {
+            exit(EXIT_FAILURE);
+        }
+
+        memset(w->atom_map + w->atom_map_size, 0, (size - w->atom_map_size) * sizeof(uint32_t));
+        w->atom_map_size = size;
+    }
+
+    if (!w->atom_map[atom]) {
+        w->atoms = nexast_reserve(w->atoms, &w->atoms_capacity, w->atoms_size + 1, sizeof(uint32_t));
+        w->atoms[w->atoms_size++] = atom;
+        w->atom_map[atom] = (uint32_t)w->atoms_size;
+    }
+
+    memcpy(w->buf + slot, &w->atom_map[atom], sizeof(uint32_t));
+
+    w->atom_slots = nexast_reserve(w->atom_slots, &w->atom_slots_capacity, w->atom_slots_size + 1, sizeof(uint64_t));
+    w->atom_slots[w->atom_slots_size++] = slot;
+}
+
+static void nexast_idens(NexAstWriter* w, uint64_t items, size_t size, size_t item_size, size_t field) {
+    /*
+    Renumbers the atoms of an array of items (written at offset items), each holding an
+    ASTN_Iden at provided field offset
+    */
+
+    for (size_t i = 0; i < size; i++) {
+        nexast_atom(w, items + i * item_size + field + offsetof(ASTN_Iden, atom));
+    }
+}
+
+static size_t nexast_slot_of(NexAstWriter* w, const void* ptr) {
+    size_t mask = w->seen_capacity - 1;
+    size_t i = (size_t)(((uintptr_t)ptr >> 4) * 0x9E3779B97F4A7C15ULL) & mask;
+
+    while (w->seen[i].ptr && w->seen[i].ptr != ptr) {
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+
+static uint64_t nexast_seen(NexAstWriter* w, const void* ptr) {
+    /*
+    return: offset of the object written from provided address; 0 if it wasn't written
+    */
+
+    if (!ptr || !w->seen_size) {
+        return 0;
+    }
+
+    return w->seen[nexast_slot_of(w, ptr)].at;
+}
+
+static void nexast_see(NexAstWriter* w, const void* ptr, uint64_t at) {
+    if (2 * (w->seen_size + 1) > w->seen_capacity) {
+        NexAstSeen* old = w->seen;
+        size_t old_capacity = w->seen_capacity;
+
+        w->seen_capacity = (old_capacity) ? old_capacity * 2 : 256;
+        w->seen = calloc(w->seen_capacity, sizeof(NexAstSeen));
+
+        if (!w->seen) {
+            exit(EXIT_FAILURE);
+        }
+
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old[i].ptr) {
+                w->seen[nexast_slot_of(w, old[i].ptr)] = old[i];
+            }
+        }
+
+        free(old);
+    }
+
+    w->seen[nexast_slot_of(w, ptr)] = (NexAstSeen){ .ptr = ptr, .at = at };
+    w->seen_size++;
+}
+
+static void nexast_link_later(NexAstWriter* w, uint64_t slot, const void* ptr) {
+    /*
+    Points the pointer at provided slot to the object written from ptr, once every object is
+    written (NULL if it never is)
+    */
+
+    nexast_link(w, slot, 0);
+
+    if (ptr) {
+        w->later = nexast_reserve(w->later, &w->later_capacity, w->later_size + 1, sizeof(NexAstLater));
+        w->later[w->later_size++] = (NexAstLater){ .slot = slot, .ptr = ptr };
+    }
+}
+
+static uint64_t nexast_put_array(NexAstWriter* w, const void* items, size_t size, size_t item_size) {
+    return (items && size) ? nexast_put(w, items, size * item_size) : 0;
+}
+
+static uint64_t nexast_put_vec(NexAstWriter* w, uint64_t at, const void* items, size_t size, uint32_t capacity, size_t item_size) {
+    /*
+    Writes the items of a vector written at offset at: inline ones were written along with it,
+    spilled ones are copied after it (trimming its capacity in the image to their #, so growing
+    a loaded vector copies them out of the image first)
+    return: offset of its items
+    */
+
+    if (!capacity) {
+        return at + offsetof(NexAstVec, items);
+    }
+
+    uint32_t trimmed = (uint32_t)size;
+    uint64_t heap = nexast_put_array(w, items, size, item_size);
+
+    memcpy(w->buf + at + offsetof(NexAstVec, capacity), &trimmed, sizeof(uint32_t));
+    nexast_link(w, at + offsetof(NexAstVec, items), heap);
+
+    return heap;
+}
+
+static uint64_t nexast_put_string(NexAstWriter* w, const char* str) {
+    if (!str) {
+        return 0;
+    }
+
+    uint64_t at = nexast_seen(w, str);
+
+    if (!at) {
+        at = nexast_put(w, str, strlen(str) + 1);
+        nexast_see(w, str, at);
+    }
+
+    return at;
+}
+
+static uint64_t nexast_put_node(NexAstWriter* w, AST_Node* node);
+static uint64_t nexast_put_statements(NexAstWriter* w, ASTN_Statements* stms);
+
+static void nexast_put_nodes(NexAstWriter* w, uint64_t at, AST_Node** items, size_t size) {
+    /*
+    Writes the nodes an array of node pointers (written at offset at) points to and points it there
+    */
+
+    for (size_t i = 0; i < size; i++) {
+        nexast_link(w, at + i * sizeof(AST_Node*), nexast_put_node(w, items[i]));
+    }
+}
+
+static void nexast_put_branches(NexAstWriter* w, uint64_t at, const void* items, size_t size, size_t item_size, size_t field) {
+    /*
+    Writes the statements of an array of branches (written at offset at), each pointing to them
+    from provided field offset, and points them there
+    */
+
+    for (size_t i = 0; i < size; i++) {
+        ASTN_Statements* stms;
+        memcpy(&stms, (const char*)items + i * item_size + field, sizeof(ASTN_Statements*));
+
+        nexast_link(w, at + i * item_size + field, nexast_put_statements(w, stms));
+    }
+}
+
+static uint64_t nexast_put_statements(NexAstWriter* w, ASTN_Statements* stms) {
+    if (!stms) {
+        return 0;
+    }
+
+    uint64_t at = nexast_seen(w, stms);
+
+    if (at) {
+        return at;
+    }
+
+    at = nexast_put(w, stms, sizeof(ASTN_Statements));
+    nexast_see(w, stms, at);
+
+    nexast_put_nodes(w, NEXAST_PUT_VEC(w, at, stms, *stms), AST_VEC_ITEMS(*stms), stms->size);
+
+    return at;
+}
+
+static uint64_t nexast_put_parameters(NexAstWriter* w, ASTN_Parameters* params) {
+    if (!params) {
+        return 0;
+    }
+
+    uint64_t at = nexast_put(w, params, sizeof(ASTN_Parameters));
+    uint64_t items = NEXAST_PUT_VEC(w, at, params, *params);
+
+    for (size_t i = 0; i < params->size; i++) {
+        ASTN_Parameter* param = AST_VEC_ITEMS(*params)[i];
+        uint64_t param_at = 0;
+
+        if (param) {
+            param_at = nexast_put(w, param, sizeof(ASTN_Parameter));
+            nexast_link(w, NEXAST_SLOT(param_at, param, identifier), nexast_put_string(w, param->identifier));
+        }
+
+        nexast_link(w, items + i * sizeof(ASTN_Parameter*), param_at);
+    }
+
+    return at;
+}
+
+static uint64_t nexast_put_module(NexAstWriter* w, ASTN_Module* module) {
+    if (!module) {
+        return 0;
+    }
+
+    uint64_t at = nexast_seen(w, module);
+
+    if (at) {
+        return at;
+    }
+
+    at = nexast_put(w, module, sizeof(ASTN_Module));
+    nexast_see(w, module, at);
+
+    nexast_link(w, NEXAST_SLOT(at, module, module), nexast_put_string(w, module->module));
+    nexast_link(w, NEXAST_SLOT(at, module, head_module), nexast_put_module(w, module->head_module));
+
+    return at;
+}
+
+static uint64_t nexast_put_attributes(NexAstWriter* w, ASTN_AttributeList* list) {
+    if (!list) {
+        return 0;
+    }
+
+    uint64_t at = nexast_seen(w, list);
+
+    if (at) {
+        return at;
+    }
+
+    at = nexast_put(w, list, sizeof(ASTN_AttributeList));
+    nexast_see(w, list, at);
+
+    nexast_put_nodes(w, NEXAST_PUT_VEC(w, at, list, *list), AST_VEC_ITEMS(*list), list->size);
+
+    return at;
+}
+
+static void nexast_put_var_decl(NexAstWriter* w, uint64_t at, ASTN_VariableDecl* var) {
+    // (a single identifier shares its bytes with the items pointer and leaves size at 0)
+    if (var->iden.mult.size) {
+        uint64_t items = nexast_put_array(w, var->iden.mult.items, var->iden.mult.size, sizeof(*var->iden.mult.items));
+
+        nexast_link(w, NEXAST_SLOT(at, var, iden.mult.items), items);
+        nexast_idens(w, items, var->iden.mult.size, sizeof(ASTN_Iden), 0);
+    } else {
+        NEXAST_IDEN(w, at, var, iden.sg);
+    }
+}
+
+static uint64_t nexast_put_body(NexAstWriter* w, ASTN_Body* body) {
+    /*
+    Writes a skipped body, without the symbols it binds (only the parser that skipped it parses it)
+    return: its offset; 0 if there's none
+    */
+
+    uint64_t at = nexast_put_array(w, body, 1, sizeof(ASTN_Body));
+
+    if (at) {
+        nexast_link(w, NEXAST_SLOT(at, body, bound), 0);
+    }
+
+    return at;
+}
+
+static void nexast_put_fn_decl(NexAstWriter* w, uint64_t at, ASTN_FunctionDecl* fn) {
+    NEXAST_IDEN(w, at, fn, identifier);
+    nexast_link(w, NEXAST_SLOT(at, fn, parameters), nexast_put_parameters(w, fn->parameters));
+    nexast_link(w, NEXAST_SLOT(at, fn, statements), nexast_put_statements(w, fn->statements));
+    nexast_link(w, NEXAST_SLOT(at, fn, body), nexast_put_body(w, fn->body));
+}
+
+static uint64_t nexast_put_fn(NexAstWriter* w, ASTN_FunctionDecl* fn) {
+    if (!fn) {
+        return 0;
+    }
+
+    uint64_t at = nexast_seen(w, fn);
+
+    if (!at) {
+        at = nexast_put(w, fn, sizeof(ASTN_FunctionDecl));
+        nexast_see(w, fn, at);
+        nexast_put_fn_decl(w, at, fn);
+    }
+
+    return at;
+}
+
+static void nexast_put_stm(NexAstWriter* w, uint64_t at, ASTN_Statement* stm) {
+    /*
+    Writes what provided statement (written at offset at) points to and points it there
+    */
+
+    switch (stm->type) {
+        case STMT_ATTR_UNIT: {
+            ASTN_AttributeUnit* unit = &stm->data.attribute_unit;
+            nexast_link(w, NEXAST_SLOT(at, stm, data.attribute_unit.data.var), nexast_put_node(w, unit->data.var));
+            break;
+        }
+        case STMT_ATTR_DECL:
+            NEXAST_IDEN(w, at, stm, data.attribute_decl.identifier);
+            nexast_link(w, NEXAST_SLOT(at, stm, data.attribute_decl.list), nexast_put_attributes(w, stm->data.attribute_decl.list));
+            break;
+        case STMT_VARIABLE_DECL:
+            nexast_put_var_decl(w, NEXAST_SLOT(at, stm, data.variable_decl), &stm->data.variable_decl);
+            break;
+        case STMT_FUNCTION_DECL:
+            nexast_put_fn_decl(w, NEXAST_SLOT(at, stm, data.function_decl), &stm->data.function_decl);
+            break;
+        case STMT_CALL:
+            NEXAST_IDEN(w, at, stm, data.call.identifier);
+            break;
+        case STMT_STRUCT_DECL: {
+            ASTN_StructDecl* decl = &stm->data.struct_decl;
+            NEXAST_IDEN(w, at, stm, data.struct_decl.identifier);
+            nexast_idens(w, NEXAST_PUT_VEC(w, at, stm, decl->members), decl->members.size,
+                sizeof(ASTN_StructMemberDecl), offsetof(ASTN_StructMemberDecl, identifier));
+            break;
+        }
+        case STMT_CLASS_DECL: {
+            ASTN_ClassDecl* decl = &stm->data.class_decl;
+            NEXAST_IDEN(w, at, stm, data.class_decl.identifier);
+            nexast_link(w, NEXAST_SLOT(at, stm, data.class_decl.init), nexast_put_fn(w, decl->init));
+            nexast_link(w, NEXAST_SLOT(at, stm, data.class_decl.free), nexast_put_fn(w, decl->free));
+            nexast_link(w, NEXAST_SLOT(at, stm, data.class_decl.attributes), nexast_put_attributes(w, decl->attributes));
+            break;
+        }
+        case STMT_ERR_DECL: {
+            ASTN_ErrDecl* decl = &stm->data.err_decl;
+            NEXAST_IDEN(w, at, stm, data.err_decl.identifier);
+            nexast_idens(w, NEXAST_PUT_VEC(w, at, stm, decl->members), decl->members.size,
+                sizeof(ASTN_ErrMember), offsetof(ASTN_ErrMember, identifier));
+            break;
+        }
+        case STMT_ENUM_DECL: {
+            ASTN_EnumDecl* decl = &stm->data.enum_decl;
+            NEXAST_IDEN(w, at, stm, data.enum_decl.identifier);
+            nexast_idens(w, NEXAST_PUT_VEC(w, at, stm, decl->members), decl->members.size, sizeof(ASTN_Iden), 0);
+            break;
+        }
+        case STMT_IMPORT_DECL: {
+            ASTN_ImportDecl* decl = &stm->data.import_decl;
+            uint64_t items = NEXAST_PUT_VEC(w, at, stm, decl->modules);
+
+            for (size_t i = 0; i < decl->modules.size; i++) {
+                nexast_link(w, items + i * sizeof(ASTN_Module*), nexast_put_module(w, AST_VEC_ITEMS(decl->modules)[i]));
+            }
+            nexast_link(w, NEXAST_SLOT(at, stm, data.import_decl.source), nexast_put_module(w, decl->source));
+            nexast_link(w, NEXAST_SLOT(at, stm, data.import_decl.alias), nexast_put_string(w, decl->alias));
+            break;
+        }
+        case STMT_CONDITIONAL: {
+            ASTN_ConditionalStm* cond = &stm->data.conditional;
+            nexast_link(w, NEXAST_SLOT(at, stm, data.conditional.if_statements), nexast_put_statements(w, cond->if_statements));
+            nexast_put_branches(w, NEXAST_PUT_VEC(w, at, stm, cond->elif_branches), AST_VEC_ITEMS(cond->elif_branches),
+                cond->elif_branches.size, sizeof(ASTN_ElifBranch), offsetof(ASTN_ElifBranch, statements));
+            nexast_link(w, NEXAST_SLOT(at, stm, data.conditional.else_statements), nexast_put_statements(w, cond->else_statements));
+            break;
+        }
+        case STMT_FOR_LOOP:
+            nexast_put_var_decl(w, NEXAST_SLOT(at, stm, data.for_loop.var_decl), &stm->data.for_loop.var_decl);
+            nexast_link(w, NEXAST_SLOT(at, stm, data.for_loop.statements), nexast_put_statements(w, stm->data.for_loop.statements));
+            break;
+        case STMT_SWITCH: {
+            ASTN_SwitchStm* sw = &stm->data.switch_stm;
+            nexast_link(w, NEXAST_SLOT(at, stm, data.switch_stm.default_stms), nexast_put_statements(w, sw->default_stms));
+            nexast_put_branches(w, NEXAST_PUT_VEC(w, at, stm, sw->clauses), AST_VEC_ITEMS(sw->clauses),
+                sw->clauses.size, sizeof(ASTN_SwitchClause), offsetof(ASTN_SwitchClause, statements));
+            break;
+        }
+        case STMT_TRY: {
+            ASTN_TryStm* try_stm = &stm->data.try_stm;
+            uint64_t branches = NEXAST_PUT_VEC(w, at, stm, try_stm->except_branches);
+
+            nexast_link(w, NEXAST_SLOT(at, stm, data.try_stm.try_statements), nexast_put_statements(w, try_stm->try_statements));
+            nexast_idens(w, branches, try_stm->except_branches.size, sizeof(ASTN_ExceptBranch), offsetof(ASTN_ExceptBranch, error));
+            nexast_put_branches(w, branches, AST_VEC_ITEMS(try_stm->except_branches),
+                try_stm->except_branches.size, sizeof(ASTN_ExceptBranch), offsetof(ASTN_ExceptBranch, statements));
+            nexast_link(w, NEXAST_SLOT(at, stm, data.try_stm.finally_statements), nexast_put_statements(w, try_stm->finally_statements));
+            break;
+        }
+        case STMT_WHILE_LOOP:
+            nexast_link(w, NEXAST_SLOT(at, stm, data.while_loop.statements), nexast_put_statements(w, stm->data.while_loop.statements));
+            break;
+        case STMT_THROW:
+            NEXAST_IDEN(w, at, stm, data.throw_stm.iden);
+            break;
+        default:
+            // expressions and returns only hold indices into the expression pool
+            break;
+    }
+}
+
+static uint64_t nexast_put_node(NexAstWriter* w, AST_Node* node) {
+    /*
+    Writes provided node and everything it points to (once, however many times it's reached)
+    return: its offset in the image
+    */
+
+    if (!node) {
+        return 0;
+    }
+
+    uint64_t at = nexast_seen(w, node);
+
+    if (at) {
+        return at;
+    }
+
+    at = nexast_put(w, node, sizeof(AST_Node));
+    nexast_see(w, node, at);
+
+    switch (node->type) {
+        case ROOT:
+            nexast_put_nodes(w, NEXAST_PUT_VEC(w, at, node, node->data.root), AST_VEC_ITEMS(node->data.root), node->data.root.size);
+            break;
+        case MEP:
+            nexast_link(w, NEXAST_SLOT(at, node, data.mep.parameters), nexast_put_parameters(w, node->data.mep.parameters));
+            nexast_link(w, NEXAST_SLOT(at, node, data.mep.statements), nexast_put_statements(w, node->data.mep.statements));
+            nexast_link(w, NEXAST_SLOT(at, node, data.mep.body), nexast_put_body(w, node->data.mep.body));
+            break;
+        case STMT:
+            nexast_put_stm(w, NEXAST_SLOT(at, node, data.stm), &node->data.stm);
+            break;
+    }
+
+    nexast_link_later(w, NEXAST_SLOT(at, node, parent), node->parent);
+    nexast_link(w, NEXAST_SLOT(at, node, right), nexast_put_node(w, node->right));
+    nexast_link(w, NEXAST_SLOT(at, node, left), nexast_put_node(w, node->left));
+
+    return at;
+}
+
+static uint64_t nexast_put_pool(NexAstWriter* w, ASTN_ExprPool* exprs) {
+    /*
+    Writes the used part of an expression pool (a loaded pool is never grown)
+    return: its offset in the image
+    */
+
+    uint64_t at = nexast_put(w, exprs, sizeof(ASTN_ExprPool));
+    uint64_t nodes = nexast_put_array(w, exprs->nodes, exprs->size, sizeof(ASTN_ExprNode));
+    uint64_t calls = nexast_put_array(w, exprs->calls, exprs->calls_size, sizeof(ASTN_Call));
+    uint64_t literals = nexast_put_array(w, exprs->literals, exprs->literals_size, sizeof(ASTN_Literal));
+
+    for (size_t i = 0; i < exprs->size; i++) {
+        if (exprs->nodes[i].type == EXPR_IDENTIFIER) {
+            nexast_atom(w, NEXAST_SLOT(nodes + i * sizeof(ASTN_ExprNode), &exprs->nodes[i], data.identifier.atom));
+        }
+    }
+
+    nexast_idens(w, calls, exprs->calls_size, sizeof(ASTN_Call), offsetof(ASTN_Call, identifier));
+
+    for (size_t i = 0; i < exprs->literals_size; i++) {
+        ASTN_Literal* lit = &exprs->literals[i];
+
+        if (lit->type == TOK_L_STRING) {
+            nexast_link(w, NEXAST_SLOT(literals + i * sizeof(ASTN_Literal), lit, value.string), nexast_put_string(w, lit->value.string));
+        }
+    }
+
+    nexast_link(w, NEXAST_SLOT(at, exprs, nodes), nodes);
+    nexast_link(w, NEXAST_SLOT(at, exprs, literals), literals);
+    nexast_link(w, NEXAST_SLOT(at, exprs, calls), calls);
+    nexast_link(w, NEXAST_SLOT(at, exprs, args), nexast_put_array(w, exprs->args, exprs->args_size, sizeof(ASTN_ExprRef)));
+    nexast_link(w, NEXAST_SLOT(at, exprs, scratch), 0);
+    nexast_link(w, NEXAST_SLOT(at, exprs, hashes), nexast_put_array(w, exprs->hashes, exprs->size, sizeof(uint64_t)));
+    nexast_link(w, NEXAST_SLOT(at, exprs, shared), 0);
+
+    ASTN_ExprPool* pool = (ASTN_ExprPool*)(w->buf + at);
+    pool->capacity = pool->size;
+    pool->literals_capacity = pool->literals_size;
+    pool->calls_capacity = pool->calls_size;
+    pool->args_capacity = pool->args_size;
+    pool->scratch_size = 0;
+    pool->scratch_capacity = 0;
+
+    // (the hashes stay for passes over the loaded tree, the table sharing new nodes doesn't)
+    pool->cons = false;
+    pool->hashes_capacity = (pool->hashes) ? pool->size : 0;
+    pool->shared_size = 0;
+    pool->shared_capacity = 0;
+
+    return at;
+}
+
+static uint64_t nexast_put_symbols(NexAstWriter* w, Symbol* first) {
+    /*
+    Writes the symbols of a table's list, in order
+    return: offset of the first one
+    */
+
+    uint64_t head = 0, prev_at = 0;
+    Symbol* prev = NULL;
+
+    for (Symbol* symb = first; symb != NULL; symb = symb->next) {
+        uint64_t at = nexast_put(w, symb, sizeof(Symbol));
+        nexast_see(w, symb, at);
+        nexast_atom(w, NEXAST_SLOT(at, symb, data.atom));
+
+        nexast_link_later(w, NEXAST_SLOT(at, symb, data.data), symb->data.data);
+
+        size_t borrowers = symb->data.life.borrower_size;
+        uint64_t list = (borrowers) ? nexast_put(w, NULL, borrowers * sizeof(Symbol*)) : 0;
+
+        for (size_t i = 0; i < borrowers; i++) {
+            nexast_link_later(w, list + i * sizeof(Symbol*), symb->data.life.borrower_list[i]);
+        }
+
+        nexast_link(w, NEXAST_SLOT(at, symb, data.life.borrower_list), list);
+        nexast_link(w, NEXAST_SLOT(at, symb, next), 0);
+        nexast_link(w, NEXAST_SLOT(at, symb, shadow), 0);
+
+        if (prev) {
+            nexast_link(w, NEXAST_SLOT(prev_at, prev, next), at);
+        } else {
+            head = at;
+        }
+
+        prev = symb;
+        prev_at = at;
+    }
+
+    return head;
+}
+
+static uint64_t nexast_put_atoms(NexAstWriter* w, uint64_t* size) {
+    /*
+    Writes the name of every atom of the image, in the image's order, each '\0' terminated
+    return: offset of the first name; # of names in provided pointer
+    */
+
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < w->atoms_size; i++) {
+        bytes += intern_len(w->atoms[i]) + 1;
+    }
+
+    uint64_t at = nexast_put(w, NULL, bytes);
+    char* name = w->buf + at;
+
+    for (size_t i = 0; i < w->atoms_size; i++) {
+        memcpy(name, intern_name(w->atoms[i]), intern_len(w->atoms[i]) + 1);
+        name += intern_len(w->atoms[i]) + 1;
+    }
+
+    *size = w->atoms_size;
+
+    return at;
+}
+
+char* nexast_path(char* dir, char* filename) {
+    /*
+    Names the cache of provided source file in a cache directory after its name and a hash of
+    its full path (resolved, so any spelling of one path gives the same image): "src/x.nex" is
+    cached in dir + "/x-" + 16 hex digits + ".nexast", anything else in dir + "/" + its name +
+    "-" + 16 hex digits + ".nexast"; sources of one name in different directories get images of
+    their own
+    return: heap allocated path (released with free)
+    */
+
+#if !defined(_WIN32)
+    char* full = realpath(filename, NULL);
+#else
+    char* full = _fullpath(NULL, filename, 0);
+#endif
+
+    // (a path that doesn't resolve, e.g. of a file not written yet, is hashed as given)
+    const char* key = (full) ? full : filename;
+    uint64_t hash = nexast_hash(key, strlen(key));
+
+    free(full);
+
+    const char* name = strrchr(filename, '/');
+    name = (name) ? name + 1 : filename;
+
+    size_t dir_len = strlen(dir);
+    size_t len = strlen(name);
+
+    if (len >= 4 && strcmp(name + len - 4, ".nex") == 0) {
+        len -= 4;
+    }
+
+    char* path = malloc(dir_len + 1 + len + sizeof("-0123456789abcdef.nexast"));
+
+    if (!path) {
+        exit(EXIT_FAILURE);
+    }
+
+    sprintf(path, "%s/%.*s-%016" PRIx64 ".nexast", dir, (int)len, name, hash);
+
+    return path;
+}
+
+uint64_t nexast_hash(const char* data, size_t size) {
+    /*
+    Hashes a source file 8 bytes at a time (FNV-1a over words, folded); tells edits apart, it
+    isn't meant to withstand crafted collisions
+    return: 64-bit hash of the contents
+    */
+
+    uint64_t hash = 0xCBF29CE484222325ULL ^ size;
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 32;
+    }
+
+    for (; i < size; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+bool nexast_write(char* path, uint64_t hash, size_t source_size, AST_Node* root, ASTN_ExprPool* exprs, SymTable* tbl) {
+    /*
+    Writes provided tree, expression pool and symbol table to a .nexast image at path (through a
+    temporary file, so a reader never sees half of one)
+    return: whether the image was written
+    */
+
+    NexAstWriter w = {0};
+    NexAstHeader head = {0};
+
+    nexast_put(&w, NULL, sizeof(NexAstHeader)); // (so no object is at offset 0, NULL)
+
+    head.root = nexast_put_node(&w, root);
+    head.exprs = nexast_put_pool(&w, exprs);
+    head.symbols = nexast_put_symbols(&w, (tbl) ? tbl->symbol : NULL);
+    head.atoms = nexast_put_atoms(&w, &head.atoms_size);
+
+    for (size_t i = 0; i < w.later_size; i++) {
+        nexast_link(&w, w.later[i].slot, nexast_seen(&w, w.later[i].ptr));
+    }
+
+    size_t relocs_size = w.relocs_size;
+    head.relocs = nexast_put_array(&w, w.relocs, relocs_size, sizeof(uint64_t));
+    head.relocs_size = relocs_size;
+    head.atom_slots = nexast_put_array(&w, w.atom_slots, w.atom_slots_size, sizeof(uint64_t));
+    head.atom_slots_size = w.atom_slots_size;
+
+    memcpy(head.magic, "NEXAST\0", 8);
+    head.version = NEXAST_VERSION;
+    head.layout = nexast_layout();
+    head.source_hash = hash;
+    head.source_size = source_size;
+    head.size = w.size;
+
+    bool written = w.size < ((uint64_t)1 << 32);
+
+    memcpy(w.buf, &head, sizeof(NexAstHeader));
+
+    char* tmp = malloc(strlen(path) + sizeof(".tmp"));
+
+    if (!tmp) {
+        exit(EXIT_FAILURE);
+    }
+
+    strcpy(tmp, path);
+    strcat(tmp, ".tmp");
+
+    FILE* f = (written) ? fopen(tmp, "wb") : NULL;
+
+    if (f) {
+        written = fwrite(w.buf, 1, w.size, f) == w.size;
+        written = (fclose(f) == 0) && written;
+        written = written && rename(tmp, path) == 0;
+
+        if (!written) {
+            remove(tmp);
+        }
+    } else {
+        written = false;
+    }
+
+    free(tmp);
+    free(w.buf);
+    free(w.relocs);
+    free(w.seen);
+    free(w.later);
+    free(w.atom_map);
+    free(w.atoms);
+    free(w.atom_slots);
+
+    return written;
+}
+
+static bool nexast_valid(NexAstHeader* head, size_t file_size, uint64_t hash, size_t source_size) {
+    return memcmp(head->magic, "NEXAST\0", 8) == 0 && head->version == NEXAST_VERSION &&
+        head->layout == nexast_layout() && head->source_hash == hash && head->source_size == source_size &&
+        head->size == file_size && head->size >= sizeof(NexAstHeader) &&
+        head->relocs <= head->size && head->relocs_size <= (head->size - head->relocs) / sizeof(uint64_t) &&
+        head->root < head->size && head->exprs < head->size && head->symbols < head->size &&
+        head->atoms <= head->size && head->atoms_size < ((uint64_t)1 << 32) &&
+        head->atom_slots <= head->size && head->atom_slots_size <= (head->size - head->atom_slots) / sizeof(uint64_t);
+}
+
+static bool nexast_atoms(char* image, NexAstHeader* head) {
+    /*
+    Interns the names of an image's atoms and renumbers every atom it holds as this process
+    numbers them (whatever else it interned before)
+    return: false if a name or an atom falls outside of the image
+    */
+
+    uint32_t* atoms = malloc((head->atoms_size + 1) * sizeof(uint32_t));
+
+    if (!atoms) {
+        exit(EXIT_FAILURE);
+    }
+
+    const char* name = image + head->atoms;
+    const char* end = image + head->size;
+    bool valid = true;
+
+    for (uint64_t atom = 1; valid && atom <= head->atoms_size; atom++) {
+        const char* stop = memchr(name, '\0', (size_t)(end - name));
+
+        if (stop) {
+            atoms[atom] = intern_atom(name, (size_t)(stop - name));
+            name = stop + 1;
+        } else {
+            valid = false;
+        }
+    }
+
+    uint64_t* slots = (uint64_t*)(image + head->atom_slots);
+
+    for (uint64_t i = 0; valid && i < head->atom_slots_size; i++) {
+        uint64_t slot = slots[i];
+        uint32_t atom;
+
+        if (slot % sizeof(uint32_t) || slot < sizeof(NexAstHeader) || slot + sizeof(uint32_t) > head->atoms) {
+            valid = false;
+            break;
+        }
+
+        memcpy(&atom, image + slot, sizeof(atom));
+
+        if (!atom || atom > head->atoms_size) {
+            valid = false;
+            break;
+        }
+
+        memcpy(image + slot, &atoms[atom], sizeof(atom));
+    }
+
+    free(atoms);
+
+    return valid;
+}
+
+static bool nexast_relocate(char* image, NexAstHeader* head) {
+    /*
+    Turns every pointer of a mapped image from its offset into the address it has there
+    return: false if a pointer (or its target) falls outside of the image
+    */
+
+    uint64_t* relocs = (uint64_t*)(image + head->relocs);
+
+    for (uint64_t i = 0; i < head->relocs_size; i++) {
+        uint64_t slot = relocs[i];
+        uint64_t ptr;
+
+        if (slot % sizeof(uint64_t) || slot < sizeof(NexAstHeader) || slot + sizeof(uint64_t) > head->relocs) {
+            return false;
+        }
+
+        memcpy(&ptr, image + slot, sizeof(ptr));
+
+        if (ptr >= head->size) {
+            return false;
+        }
+
+        ptr += (uint64_t)(uintptr_t)image;
+        memcpy(image + slot, &ptr, sizeof(ptr));
+    }
+
+    return true;
+}
+
+NexAst* nexast_load(char* path, uint64_t hash, size_t source_size) {
+    /*
+    Maps the .nexast image at path, if it was written for a source with provided hash and size
+    by this version of the compiler, and relocates it to where it was mapped; its atoms are
+    renumbered as this process numbers their names
+    return: pointer to the loaded tree (released with nexast_free); NULL if there's no usable image
+    */
+
+    NexAstHeader head;
+    char* image = NULL;
+    size_t map_size = 0;
+
+#if !defined(_WIN32)
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || pread(fd, &head, sizeof(head), 0) != (ssize_t)sizeof(head) ||
+        !nexast_valid(&head, (size_t)st.st_size, hash, source_size)) {
+        close(fd);
+        return NULL;
+    }
+
+    // private pages: relocating (or writing to a loaded tree) never reaches the file
+    void* map = mmap(NULL, head.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    image = map;
+    map_size = head.size;
+#else
+    FILE* f = fopen(path, "rb");
+
+    if (!f) {
+        return NULL;
+    }
+
+    if (fread(&head, sizeof(head), 1, f) != 1 || fseek(f, 0, SEEK_END) != 0 ||
+        !nexast_valid(&head, (size_t)ftell(f), hash, source_size)) {
+        fclose(f);
+        return NULL;
+    }
+
+    image = malloc(head.size);
+
+    if (!image) {
+        exit(EXIT_FAILURE);
+    }
+
+    rewind(f);
+
+    if (fread(image, 1, head.size, f) != head.size) {
+        fclose(f);
+        free(image);
+        return NULL;
+    }
+
+    fclose(f);
+#endif
+
+    if (!nexast_relocate(image, &head) || !nexast_atoms(image, &head)) {
+#if !defined(_WIN32)
+        munmap(image, map_size);
+#else
+        free(image);
+#endif
+        return NULL;
+    }
+
+    NexAst* ast = calloc(1, sizeof(NexAst));
+
+    if (!ast) {
+        exit(EXIT_FAILURE);
+    }
+
+    ast->image = (NexAstHeader*)image;
+    ast->map_size = map_size;
+    ast->root = (head.root) ? (AST_Node*)(image + head.root) : NULL;
+    ast->exprs = (ASTN_ExprPool*)(image + head.exprs);
+    ast->tbl.symbol = (head.symbols) ? (Symbol*)(image + head.symbols) : NULL;
+    symtbl_index(&ast->tbl);
+
+    return ast;
+}
+
+void nexast_free(NexAst* ast) {
+    /*
+    Unmaps a tree loaded by nexast_load
+    */
+
+    if (!ast) {
+        return;
+    }
+
+#if !defined(_WIN32)
+    if (ast->map_size) {
+        munmap(ast->image, ast->map_size);
+    } else {
+        free(ast->image);
+    }
+#else
+    free(ast->image);
+#endif
+
+    symtbl_release(&ast->tbl);
+    free(ast);
+}
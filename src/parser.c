@@ -3,15 +3,33 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 Parser* parser_init(char* filename) {
+    return parser_init_from_source(io_load_file(filename));
+}
+
+Parser* parser_init_from_source(SourceBuffer src) {
+    /*
+    Initializes a parser over a loaded source file, which its lexer takes over (so a caller
+    that already read the file, e.g. to hash it, doesn't read it again)
+    return: pointer to the parser
+    */
+
     Parser* parser = calloc(1, sizeof(Parser));
 
-    parser->lexer = lexer_init(filename);
-    parser->cur = lexer_next_token(parser->lexer);
+    parser->lexer = lexer_init_from_source(src);
+    parser->tokens = lexer_tokenize_parallel(parser->lexer, 0);
+    parser->pos = 0;
     parser->tbl = symtbl_init();
-    parser->tree = ast_init(ROOT);
-    parser->root = parser->tree;
+    parser->scopes = scope_init();
+    arena_init(&parser->arena);
+    ast_pool_init(&parser->exprs);
+    parser->root = ast_init(&parser->arena, ROOT);
 
     parser->highest_scope = 0;
     parser->scope = 0;
@@ -29,30 +47,37 @@ void parser_free(Parser* parser) {
         return;
     }
 
+    token_stream_free(parser->tokens);
     lexer_free(parser->lexer);
-    token_free(parser->cur);
 
-    // PRINT_AST_NODE(parser->root, 0);
+    // PRINT_AST_NODE(&parser->exprs, parser->root, 0);
 
-    ast_free(parser->tree);
-    ast_free(parser->root);
+    // the whole tree (nodes, expressions and child arrays) lives in the arena
+    arena_free(&parser->arena);
+    ast_pool_free(&parser->exprs);
 
     // Symbol* cur = parser->tbl->symbol;
     // PRINT_SYMB_TBL(cur);
 
     symtbl_free(parser->tbl);
-    parser = NULL;
+    scope_free(parser->scopes);
+    free(parser->spans);
+    free(parser->ranks);
+    free(parser);
 }
 
 bool parser_expectsq(Parser* parser, ...) {
+    /*
+    Expects and consumes provided sequence of token types, terminated by TOK_ERROR
+    return: false at the first mismatching token (tokens before it stay consumed)
+    */
+
     va_list args;
     va_start(args, parser);
 
-    Token *cur_token;
-    while ((cur_token = va_arg(args, Token *)) != NULL) {
-        parser_consume(parser);
-
-        if (parser->cur != cur_token) {
+    int expected;
+    while ((expected = va_arg(args, int)) != TOK_ERROR) {
+        if (!parser_expect(parser, (uint8_t)expected)) {
             va_end(args);
             return false;
         }
@@ -64,7 +89,7 @@ bool parser_expectsq(Parser* parser, ...) {
 
 
 bool parser_expect(Parser* parser, uint8_t expected) {
-    if (parser->cur->type != expected) {
+    if (PCT(parser) != expected) {
         return false;            
     }
 
@@ -73,7 +98,10 @@ bool parser_expect(Parser* parser, uint8_t expected) {
 }
 
 bool parser_expect_spec_value(Parser* parser, uint8_t expected_t, char* expected_c) {
-    if ((parser->cur->type != expected_t) || strcmp(parser->cur->value, expected_c) != 0) {
+    TokenStream* tokens = parser->tokens;
+
+    if ((PCT(parser) != expected_t) || tokens->len[parser->pos] != strlen(expected_c) ||
+        strncmp(tokens->buf + tokens->offset[parser->pos], expected_c, tokens->len[parser->pos]) != 0) {
         return false;            
     }
 
@@ -81,71 +109,1141 @@ bool parser_expect_spec_value(Parser* parser, uint8_t expected_t, char* expected
     return true;
 }
 
+static void parser_seek(Parser* parser, size_t pos) {
+    /*
+    Makes the token at provided index the current one
+    */
+
+    parser->pos = pos;
+
+    // keep the lexer positioned right after the current token, as if it had just been lexed,
+    // so diagnostics refer to it (symbol declarations use the token's own position, PCL/PCC)
+    Lexer* lexer = parser->lexer;
+    TokenStream* tokens = parser->tokens;
+
+    lexer->i = tokens->offset[parser->pos] + tokens->len[parser->pos];
+    lexer->c = (lexer->i < lexer->buf_size) ? lexer->buf[lexer->i] : '\0';
+}
+
 void parser_consume(Parser* parser) {
-    if (parser->cur->type == TOK_EOF) {
-        exit(0);
+    if (PCT(parser) == TOK_EOF) {
+        if (parser->bail) {
+            longjmp(*parser->bail, 1);
+        }
+
+        REPORT_ERROR(parser->lexer, "E_UNEXPECTED_EOF");
+        exit(EXIT_FAILURE);
     }
 
+    parser_seek(parser, parser->pos + 1);
+}
 
-    parser->cur = lexer_next_token(parser->lexer);
+uint8_t parser_peek(Parser* parser, size_t offset) {
+    /*
+    Looks provided # of tokens ahead of the current one without consuming anything
+    return: type of that token; TOK_EOF past the end of the stream
+    */
+
+    if (offset >= parser->tokens->size - parser->pos) {
+        return TOK_EOF;
+    }
+
+    return parser->tokens->type[parser->pos + offset];
 }
 
-void parser_parse(Parser* parser) {
-    while (parser->cur->type != TOK_EOF) {
-        switch (parser->cur->type) {
-            case TOK_IMPORT:
-                parser->tree->right = parser_parse_import(parser);
-                break;
-            case TOK_COLON:
-                parser->tree->right = parser_parse_mep_decl(parser);
-                break;
-            case TOK_FN:
-                parser->tree->right = parser_parse_function_decl(parser);
-                break;
-            case TOK_IDEN:  
-                parser->tree->right = parser_parse_expr(parser, 0);
-                break;
-            case TOK_ATTR:
-                parser->tree->right = parser_parse_attr_decl(parser);                
-                break;
-            case TOK_CLASS:                
-                parser->tree->right = parser_parse_class_decl(parser);
-                break;
-            case TOK_ERR: 
-                parser->tree->right = parser_parse_err_decl(parser);
-                break;
-            case TOK_ENUM:
-                parser->tree->right = parser_parse_enum_decl(parser);
-                break;
-            case TOK_STRUCT:
-                parser->tree->right = parser_parse_struct_decl(parser);;
+char* parser_value(Parser* parser, size_t index) {
+    /*
+    Resolves the text of the token at provided index into the parser's arena; the token stream
+    itself is only read, so parsers on several threads can share it
+    return: '\0' terminated value (the same pointer for repeated calls on the same token)
+    */
+
+    TokenStream* tokens = parser->tokens;
+
+    if (tokens->value[index]) {
+        return tokens->value[index];
+    }
+
+    if (!parser->value || parser->value_pos != index) {
+        parser->value = arena_strndup(&parser->arena, tokens->buf + tokens->offset[index], tokens->len[index]);
+        parser->value_pos = index;
+    }
+
+    return parser->value;
+}
+
+uint32_t parser_atom(Parser* parser, size_t index) {
+    /*
+    Resolves the interned name of the token at provided index; identifiers were interned by the
+    lexer, any other token standing where a name is expected is interned on the spot
+    return: atom of the token's text
+    */
+
+    uint32_t atom = parser->tokens->atom[index];
+
+    if (!atom) {
+        char* value = parser_value(parser, index);
+        atom = intern_atom(value, strlen(value));
+    }
+
+    return atom;
+}
+
+Symbol* parser_find(Parser* parser, uint32_t atom) {
+    /*
+    Looks provided name up at the top level (scope 0) as parsing the declarations one after
+    another would see it: declared by a declaration before the current one, or earlier in the
+    current one, whatever order the declarations were actually parsed in (functions are
+    declared up front, and the other declarations parsed before any function)
+    return: pointer to the symbol; NULL if none is declared there by then
+    */
+
+    Symbol* symb = symtbl_find(parser->tbl, atom, 0);
+
+    if (!symb || !parser->ranks || !parser->owner || !symb->data.owner) {
+        return symb;
+    }
+
+    if (symb->data.owner == parser->owner) {
+        return (symb != parser->hidden) ? symb : NULL;
+    }
+
+    return (parser->ranks[symb->data.owner] < parser->ranks[parser->owner]) ? symb : NULL;
+}
+
+// top-level declaration found by parser_scan_decls
+typedef struct ParserDecl {
+    size_t start, end; // [start, end) token range
+    ScopeId scope; // its own scope, first id of the run its scopes are numbered from
+    uint32_t owner; // stamp of the symbols it declares
+    Symbol* symb; // symbol of a function declaration, declared before any declaration is parsed
+    AST_Node* node; // parsed declaration; NULL if it failed
+    bool eof; // parsing it ran into the end of the token stream
+    bool stop; // nothing after it is parsed: it failed or didn't end at its last token
+    size_t bytes; // bytes of nodes, expressions and scopes parsing it took
+
+    Symbol* symbols; // symbols declared while parsing a function declaration, in source order
+    Symbol* last; // (once merged, the run of every symbol it declared, as ParserSpan.symbols)
+    Symbol* mark; // last symbol of the parser's table once it was declared or parsed
+
+    // diagnostics raised while declaring it and while parsing it, held back until every
+    // declaration is parsed so they print in source order
+    size_t head_from, head_until;
+    Lexer* lexer;
+    size_t diag_from, diag_until;
+} ParserDecl;
+
+typedef struct ParserWorker {
+    Parser parser; // parses into its own arena, expression pool and symbol table (sharing the parent's index)
+    Parser* parent; // parser the results are merged into
+
+    ParserDecl* decls; // run of declarations, only the function declarations among them are parsed
+    size_t size;
+} ParserWorker;
+
+static size_t parser_scan_decl(TokenStream* tokens, size_t i) {
+    /*
+    Finds the end of the top-level declaration starting at provided token by matching braces:
+    it ends at a ';' outside of braces or at the '}' closing its outermost brace
+    return: index of the token right after it (the TOK_EOF one if the stream runs out first)
+    */
+
+    for (size_t depth = 0; tokens->type[i] != TOK_EOF; i++) {
+        uint8_t type = tokens->type[i];
+
+        if (type == TOK_LBRACE) {
+            depth++;
+        } else if (type == TOK_RBRACE) {
+            if (depth <= 1) {
+                return i + 1;
+            }
+
+            depth--;
+        } else if (type == TOK_SC && depth == 0) {
+            return i + 1;
+        }
+    }
+
+    return i;
+}
+
+static ParserDecl* parser_scan_decls(Parser* parser, size_t* size) {
+    /*
+    Splits the tokens from the current one on into top-level declarations (parser_scan_decl)
+    return: declarations in source order (released with free)
+    */
+
+    TokenStream* tokens = parser->tokens;
+    size_t capacity = 64, n = 0;
+    ParserDecl* decls = malloc(capacity * sizeof(ParserDecl));
+
+    if (!decls) {
+        exit(EXIT_FAILURE);
+    }
+
+    size_t i = parser->pos;
+
+    while (tokens->type[i] != TOK_EOF) {
+        size_t start = i;
+        i = parser_scan_decl(tokens, i);
+
+        if (n == capacity) {
+            capacity *= 2;
+            decls = realloc(decls, capacity * sizeof(ParserDecl));
+
+            if (!decls) {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        decls[n++] = (ParserDecl){ .start = start, .end = i };
+    }
+
+    *size = n;
+
+    return decls;
+}
+
+static size_t parser_count_scopes(TokenStream* tokens, size_t start, size_t end) {
+    /*
+    Counts the tokens of provided range that may open a scope (PES only ever follows the
+    keyword of the declaration or statement it's for, once per keyword)
+    return: # of scopes the range opens at most
+    */
+
+    size_t count = 0;
+
+    for (size_t i = start; i < end; i++) {
+        switch (tokens->type[i]) {
+            case TOK_ATTR: case TOK_FN: case TOK_CLASS: case TOK_ERR:
+            case TOK_IF: case TOK_ELIF: case TOK_ELSE: case TOK_FOR: case TOK_WHILE:
+            case TOK_SWITCH: case TOK_TRY: case TOK_EXCEPT: case TOK_FINALLY:
+                count++;
                 break;
             default:
                 break;
         }
-        
+    }
+
+    return count;
+}
+
+static ScopeId parser_reserve_scopes(Parser* parser, ParserDecl* decl) {
+    /*
+    Reserves the run of scope ids of provided declaration: its own and one per scope it may open
+    return: first id of the run
+    */
+
+    size_t count = parser_count_scopes(parser->tokens, decl->start, decl->end) + 1;
+
+    decl->bytes += count * sizeof(Scope);
+
+    return scope_reserve(parser->scopes, count);
+}
+
+static size_t parser_bytes(Parser* parser) {
+    /*
+    return: # of bytes the parser's nodes and expressions take (scopes are counted as they're
+    reserved, as workers share them)
+    */
+
+    return parser->arena.allocated + parser->exprs.size * sizeof(ASTN_ExprNode);
+}
+
+static AST_Node* parser_parse_toplevel(Parser* parser) {
+    /*
+    Parses the top-level declaration starting at the current token
+    return: pointer to its node; NULL if it failed or isn't a declaration
+    */
+
+    switch (PCT(parser)) {
+        case TOK_IMPORT:
+            return parser_parse_import(parser);
+        case TOK_COLON:
+            return parser_parse_mep_decl(parser);
+        case TOK_FN:
+            return parser_parse_function_decl(parser);
+        case TOK_IDEN:
+            return parser_parse_expr(parser);
+        case TOK_ATTR:
+            return parser_parse_attr_decl(parser);
+        case TOK_CLASS:
+            return parser_parse_class_decl(parser);
+        case TOK_ERR:
+            return parser_parse_err_decl(parser);
+        case TOK_ENUM:
+            return parser_parse_enum_decl(parser);
+        case TOK_STRUCT:
+            return parser_parse_struct_decl(parser);
+        default:
+            return NULL;
+    }
+}
+
+static void parser_parse_decl(Parser* parser, ParserDecl* decl) {
+    /*
+    Parses a top-level declaration on its own: its scopes take the ids of its run, from
+    decl->scope (parser_reserve_scopes) up, so it is parsed the same way whichever parser,
+    thread and order it is parsed by; it binds its symbols in its own scope, left (with any it
+    didn't leave) once it's parsed
+    */
+
+    jmp_buf bail;
+    size_t depth = symtbl_depth(parser->tbl);
+    size_t bytes = parser_bytes(parser);
+
+    parser_seek(parser, decl->start);
+    parser->scope = decl->scope;
+    parser->highest_scope = decl->scope;
+    parser->nest = 0;
+    parser->symb = decl->symb;
+    scope_open(parser->scopes, decl->scope, 0, SCOPE_DECL);
+    parser->owner = decl->owner;
+
+    decl->lexer = parser->lexer;
+    decl->diag_from = parser->lexer->errors;
+
+    parser->bail = &bail;
+    symtbl_enter(parser->tbl);
+
+    if (setjmp(bail) == 0) {
+        decl->node = parser_parse_toplevel(parser);
+    } else {
+        REPORT_ERROR(parser->lexer, "E_UNEXPECTED_EOF");
+        decl->node = NULL;
+        decl->eof = true;
+        parser->exprs.scratch_size = 0;
+    }
+
+    symtbl_leave(parser->tbl, depth);
+    parser->bail = NULL;
+    parser->symb = NULL;
+    parser->hidden = NULL;
+    decl->bytes += parser_bytes(parser) - bytes;
+
+    decl->stop = !decl->node || parser->pos != decl->end;
+    decl->diag_until = parser->lexer->errors;
+}
+
+static Symbol* parser_declare_fn(Parser* parser, ParserDecl* decl) {
+    /*
+    Declares the function of a declaration before any declaration is parsed, so every one of
+    them (parsed in any order) sees every function
+    return: pointer to its symbol; NULL if the declaration has no name (reported when parsed)
+    */
+
+    TokenStream* tokens = parser->tokens;
+
+    if (decl->end - decl->start < 4 || tokens->type[decl->start + 1] != TOK_IDEN ||
+        tokens->type[decl->start + 2] != TOK_FN_ARROW) {
+        return NULL;
+    }
+
+    parser_seek(parser, decl->start + 3);
+    parser->owner = decl->owner;
+
+    Symbol* symb = symbol_init(parser_atom(parser, decl->start + 1), SYMBOL_FUNCTION, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
+    symtbl_insert(parser, symb);
+
+    return symb;
+}
+
+static void* parser_worker_parse(void* arg) {
+    /*
+    Parses the function declarations of a worker's run, gathering the symbols of each one apart
+    (declarations never see each other's locals); they go straight to the parent's index, along
+    with those of every other worker
+    */
+
+    ParserWorker* worker = (ParserWorker*)arg;
+    Parser* parser = &worker->parser;
+
+    parser->lexer = lexer_view(worker->parent->lexer, 0);
+    parser->tokens = worker->parent->tokens;
+    parser->lazy = worker->parent->lazy;
+    parser->tbl = symtbl_init_shared(worker->parent->tbl);
+    parser->scopes = worker->parent->scopes;
+    parser->ranks = worker->parent->ranks;
+    arena_init(&parser->arena);
+    ast_pool_init(&parser->exprs);
+
+    if (worker->parent->exprs.cons) {
+        ast_pool_cons(&parser->exprs);
+    }
+
+    for (size_t i = 0; i < worker->size; i++) {
+        ParserDecl* decl = &worker->decls[i];
+
+        if (parser->tokens->type[decl->start] != TOK_FN) {
+            continue;
+        }
+
+        parser_parse_decl(parser, decl);
+
+        decl->symbols = symtbl_detach(parser->tbl, &decl->last);
+    }
+
+    return NULL;
+}
+
+static void parser_worker_merge(Parser* parser, ParserWorker* worker) {
+    /*
+    Moves the nodes and expressions a worker parsed into the parser (the symbols are moved
+    declaration by declaration once the last parsed one is known)
+    */
+
+    Parser* from = &worker->parser;
+
+    arena_adopt(&parser->arena, &from->arena);
+
+    ASTN_PoolBase base = ast_pool_append(&parser->exprs, &from->exprs);
+
+    for (size_t i = 0; i < worker->size; i++) {
+        if (parser->tokens->type[worker->decls[i].start] == TOK_FN) {
+            ast_rebase(worker->decls[i].node, base);
+        }
+    }
+
+    ast_pool_free(&from->exprs);
+    symtbl_free(from->tbl);
+}
+
+static void parser_free_symbols(Symbol* symb) {
+    while (symb != NULL) {
+        Symbol* next = symb->next;
+        free(symb);
+        symb = next;
+    }
+}
+
+static void parser_drop_symbols(Parser* parser, Symbol* symb) {
+    /*
+    Takes symbols unlinked from the table (linked through next) out of its index and frees them
+    */
+
+    for (Symbol* s = symb; s != NULL; s = s->next) {
+        symtbl_remove(parser->tbl, s);
+    }
+
+    parser_free_symbols(symb);
+}
+
+void parser_parse(Parser* parser) {
+    /*
+    Parses the whole token stream, spreading function declarations over every online cpu
+    */
+
+    parser_parse_parallel(parser, 0);
+}
+
+void parser_parse_parallel(Parser* parser, unsigned int threads) {
+    /*
+    Parses the whole token stream into the declarations of parser->root, up to the first one
+    that fails or ends short of its last token (where parsing them one after another would stop
+    too). Declarations other than functions are parsed on the calling thread first (functions
+    are declared up front), then the function declarations are parsed on provided # of threads
+    (0 uses every online cpu) and kept in source order; the tree, the symbols and the
+    diagnostics are the same for any # of threads
+    */
+
+    if (threads == 0) {
+#if !defined(_WIN32)
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (unsigned int)online : 1;
+#else
+        threads = 1;
+#endif
+    }
+
+    size_t size;
+    ParserDecl* decls = parser_scan_decls(parser, &size);
+    TokenStream* tokens = parser->tokens;
+
+    free(parser->ranks);
+    parser->ranks = malloc((size + 1) * sizeof(uint32_t));
+
+    if (!parser->ranks) {
+        exit(EXIT_FAILURE);
+    }
+
+    parser->ranks[0] = 0;
+
+    // (in source order, before any worker opens one)
+    for (size_t i = 0; i < size; i++) {
+        decls[i].scope = parser_reserve_scopes(parser, &decls[i]);
+        decls[i].owner = (uint32_t)(i + 1);
+        parser->ranks[decls[i].owner] = (uint32_t)i;
+    }
+
+    parser->owners = (uint32_t)size;
+
+    // every other declaration (and every function's symbol) goes first, in source order
+    Lexer* lexer = parser->lexer;
+    Lexer* held = lexer_view(lexer, lexer->i);
+    Symbol* last = parser->tbl->last;
+    size_t fn_tokens = 0;
+
+    parser->lexer = held;
+
+    for (size_t i = 0; i < size; i++) {
+        ParserDecl* decl = &decls[i];
+
+        if (tokens->type[decl->start] == TOK_FN) {
+            decl->head_from = held->errors;
+            decl->symb = parser_declare_fn(parser, decl);
+            decl->head_until = held->errors;
+
+            fn_tokens += decl->end - decl->start;
+        } else {
+            parser_parse_decl(parser, decl);
+        }
+
+        decl->mark = parser->tbl->last;
+
+        if (decl->stop && tokens->type[decl->start] != TOK_FN) {
+            size = i + 1;
+        }
+    }
+
+    parser->lexer = lexer;
+
+    // function declarations, in runs of close to equal # of tokens
+    if (threads > PARSER_MAX_THREADS) {
+        threads = PARSER_MAX_THREADS;
+    }
+
+    if (threads > fn_tokens / PARSER_PARALLEL_MIN_TOKENS) {
+        threads = (unsigned int)(fn_tokens / PARSER_PARALLEL_MIN_TOKENS);
+    }
+
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    ParserWorker workers[PARSER_MAX_THREADS] = {0};
+    pthread_t handles[PARSER_MAX_THREADS];
+    bool spawned[PARSER_MAX_THREADS] = {0};
+    unsigned int n = 0;
+    size_t done = 0, first = 0;
+
+    for (size_t i = 0; i < size && n < threads; i++) {
+        if (tokens->type[decls[i].start] == TOK_FN) {
+            done += decls[i].end - decls[i].start;
+        }
+
+        if (i + 1 == size || done * threads >= fn_tokens * (n + 1)) {
+            workers[n].parent = parser;
+            workers[n].decls = &decls[first];
+            workers[n].size = i + 1 - first;
+            first = i + 1;
+            n++;
+        }
+    }
+
+    for (unsigned int k = 1; k < n; k++) {
+        spawned[k] = pthread_create(&handles[k], NULL, parser_worker_parse, &workers[k]) == 0;
+    }
+
+    if (n > 0) {
+        parser_worker_parse(&workers[0]);
+    }
+
+    for (unsigned int k = 1; k < n; k++) {
+        if (spawned[k]) {
+            pthread_join(handles[k], NULL);
+        } else {
+            parser_worker_parse(&workers[k]);
+        }
+    }
+
+    // merge
+    for (unsigned int k = 0; k < n; k++) {
+        parser_worker_merge(parser, &workers[k]);
+    }
+
+    ASTN_Root* root = &parser->root->data.root;
+    size_t parsed = size;
+
+    for (size_t i = 0; i < size; i++) {
+        ParserDecl* decl = &decls[i];
+
+        lexer_replay_diag(held, decl->head_from, decl->head_until, lexer);
 
-        if (!(parser->tree && parser->tree->right)) {
+        if (decl->lexer) {
+            lexer_replay_diag(decl->lexer, decl->diag_from, decl->diag_until, lexer);
+        }
+
+        if (decl->node) {
+            AST_VEC_PUSH(&parser->arena, *root, decl->node);
+        }
+
+        if (decl->stop) {
+            parsed = i + 1;
+            break;
+        }
+    }
+
+    // symbols of the parsed declarations, in source order with each one's in a run of its own
+    // (so parser_reparse takes them out as one): the ones declared on this thread (between the
+    // marks), then a function's from its worker; they're all indexed already
+    Symbol* mark = last;
+    Symbol* next = (last) ? last->next : parser->tbl->symbol;
+
+    if (last) {
+        last->next = NULL;
+    } else {
+        parser->tbl->symbol = NULL;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        ParserDecl* decl = &decls[i];
+        Symbol* own = NULL;
+        Symbol* own_last = NULL;
+
+        if (decl->mark != mark) {
+            own = next;
+            own_last = decl->mark;
+            next = own_last->next;
+            own_last->next = decl->symbols;
+            mark = decl->mark;
+        }
+
+        Symbol* first = (own) ? own : decl->symbols;
+        Symbol* run_last = (decl->symbols) ? decl->last : own_last;
+
+        decl->symbols = first;
+        decl->last = run_last;
+
+        if (!first) {
+            continue;
+        }
+
+        run_last->next = NULL;
+
+        if (i >= parsed) {
+            parser_drop_symbols(parser, first);
+            decl->symbols = decl->last = NULL;
+        } else {
+            if (last) {
+                last->next = first;
+            } else {
+                parser->tbl->symbol = first;
+            }
+
+            last = run_last;
+        }
+    }
+
+    parser->tbl->last = last;
+
+    // token ranges of the declarations kept, for parser_reparse
+    free(parser->spans);
+    parser->spans = malloc((parsed + 1) * sizeof(ParserSpan));
+    parser->spans_size = 0;
+
+    if (!parser->spans) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < parsed; i++) {
+        if (decls[i].node) {
+            parser->spans[parser->spans_size++] = (ParserSpan){
+                decls[i].start, decls[i].end, decls[i].owner, decls[i].bytes, decls[i].symbols, decls[i].last
+            };
+        }
+    }
+
+    for (unsigned int k = 0; k < n; k++) {
+        lexer_view_free(workers[k].parser.lexer);
+    }
+
+    lexer_view_free(held);
+    free(decls);
+
+    parser_seek(parser, tokens->size - 1);
+}
+
+// incremental reparsing: the symbols of each declaration are one run of the table's list
+// (ParserSpan.symbols), so the ones of the declarations parsed again are taken out of the table
+// and its index by themselves; the ones of the declarations after them stay, as Parser.ranks
+// keeps them from being seen (as on a whole parse, where they aren't declared yet)
+
+static int parser_export_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t* parser_exports(Symbol* symb, size_t* size) {
+    /*
+    Gathers the names provided symbols (linked through next) declare at the top level (scope 0);
+    those are the only ones other declarations can see
+    return: their ids and types, sorted (released with free)
+    */
+
+    size_t n = 0, capacity = 16;
+    uint64_t* keys = malloc(capacity * sizeof(uint64_t));
+
+    if (!keys) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (; symb != NULL; symb = symb->next) {
+        // (a MEP is declared in its declaration's own scope, never the top level)
+        if (symb->data.scope != 0 || symb->data.type == SYMBOL_MEP) {
+            continue;
+        }
+
+        if (n == capacity) {
+            capacity *= 2;
+            keys = realloc(keys, capacity * sizeof(uint64_t));
+
+            if (!keys) {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        keys[n++] = ((uint64_t)symb->data.atom << 8) | (uint8_t)symb->data.type;
+    }
+
+    qsort(keys, n, sizeof(uint64_t), parser_export_cmp);
+    *size = n;
+
+    return keys;
+}
+
+static void parser_shift_body(ASTN_Body* body, ParserSpan* span, ptrdiff_t shift) {
+    if (body && body->start >= span->start && body->start < span->end) {
+        body->start = (size_t)((ptrdiff_t)body->start + shift);
+        body->end = (size_t)((ptrdiff_t)body->end + shift);
+    }
+}
+
+static void parser_shift_bodies(AST_Node* node, ParserSpan* span, ptrdiff_t shift) {
+    /*
+    Moves the token ranges of the skipped bodies of a declaration by provided # of tokens; only
+    the ones within its own (old) range, as attribute lists share the nodes of the declarations
+    they extend
+    */
+
+    if (node->type == MEP) {
+        parser_shift_body(node->data.mep.body, span, shift);
+        return;
+    }
+
+    ASTN_AttributeList* list = NULL;
+
+    if (node->type != STMT) {
+        return;
+    } else if (node->data.stm.type == STMT_FUNCTION_DECL) {
+        parser_shift_body(node->data.stm.data.function_decl.body, span, shift);
+    } else if (node->data.stm.type == STMT_CLASS_DECL) {
+        list = node->data.stm.data.class_decl.attributes;
+    } else if (node->data.stm.type == STMT_ATTR_DECL) {
+        list = node->data.stm.data.attribute_decl.list;
+    }
+
+    for (size_t i = 0; list && i < list->size; i++) {
+        ASTN_AttributeUnit* unit = &AST_VEC_ITEMS(*list)[i]->data.stm.data.attribute_unit;
+
+        if (unit->type == ATTR_FUNCTION && unit->data.fn) {
+            parser_shift_body(unit->data.fn->data.stm.data.function_decl.body, span, shift);
+        }
+    }
+}
+
+static bool parser_is_extended(AST_Node* node) {
+    /*
+    Checks whether provided declaration may be extended by others (sharing its nodes)
+    return: true for attr and class declarations
+    */
+
+    return node->type == STMT && (node->data.stm.type == STMT_ATTR_DECL || node->data.stm.type == STMT_CLASS_DECL);
+}
+
+static void parser_reset(Parser* parser) {
+    /*
+    Drops the tree and the symbols, leaving the parser as parser_init does (the tokens stay)
+    */
+
+    bool cons = parser->exprs.cons;
+
+    arena_free(&parser->arena);
+    ast_pool_free(&parser->exprs);
+    ast_pool_init(&parser->exprs);
+    symtbl_free(parser->tbl);
+    scope_free(parser->scopes);
+
+    if (cons) {
+        ast_pool_cons(&parser->exprs);
+    }
+
+    parser->tbl = symtbl_init();
+    parser->scopes = scope_init();
+    parser->root = ast_init(&parser->arena, ROOT);
+    parser->value = NULL;
+
+    free(parser->spans);
+    parser->spans = NULL;
+    parser->spans_size = 0;
+    free(parser->ranks);
+    parser->ranks = NULL;
+    parser->garbage = 0;
+
+    parser->highest_scope = 0;
+    parser->scope = 0;
+    parser->nest = 0;
+
+    parser_seek(parser, 0);
+}
+
+static bool parser_reparse_decls(Parser* parser, size_t d, size_t e, ParserDecl* decls, size_t size, ptrdiff_t shift) {
+    /*
+    Parses provided declarations in place of the ones of parser->spans from d up to e (the tokens
+    were lexed again, the ones after them moved by shift), the way parser_parse_parallel would:
+    every other declaration first, in order, seeing only what's declared before it, then the
+    functions, seeing everything; diagnostics are held back until the result is known
+    return: false (leaving the table without the old declarations' symbols) if parsing stopped
+    in one of them, they don't declare the same top-level names as the old ones or one of those
+    is held by a declaration after them (which a whole parse would report instead)
+    */
+
+    ParserSpan* spans = parser->spans;
+    SymTable* tbl = parser->tbl;
+
+    for (size_t i = 0; i < size; i++) {
+        decls[i].owner = parser->owners + 1 + (uint32_t)i;
+    }
+
+    // positions the declarations will have once the new ones are spliced in (only the ones
+    // after them move, when the new ones aren't as many as the old)
+    parser->ranks = realloc(parser->ranks, (parser->owners + size + 1) * sizeof(uint32_t));
+
+    if (!parser->ranks) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t k = e; k < parser->spans_size && size != e - d; k++) {
+        parser->ranks[spans[k].owner] = (uint32_t)(k - (e - d) + size);
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        parser->ranks[decls[i].owner] = (uint32_t)(d + i);
+    }
+
+    // the old declarations' symbols: from the first run of theirs up to the last, which link
+    // follows (right after the run of the last declaration before them that has one)
+    Symbol** link = &tbl->symbol;
+    Symbol* before = NULL;
+    Symbol* old_last = NULL;
+
+    for (size_t k = d; k-- > 0;) {
+        if (spans[k].last) {
+            before = spans[k].last;
+            link = &before->next;
             break;
         }
+    }
+
+    for (size_t k = d; k < e; k++) {
+        old_last = (spans[k].last) ? spans[k].last : old_last;
+    }
+
+    Symbol* old = (old_last) ? *link : NULL;
+    Symbol* after = (old_last) ? old_last->next : *link;
+
+    if (old_last) {
+        *link = after;
+        old_last->next = NULL;
+        tbl->last = (tbl->last == old_last) ? before : tbl->last;
+    }
+
+    for (Symbol* symb = old; symb != NULL; symb = symb->next) {
+        symtbl_remove(tbl, symb);
+    }
+
+    Symbol* mark = tbl->last;
+    Lexer* lexer = parser->lexer;
+    Lexer* held = lexer_view(lexer, lexer->i);
+
+    parser->lexer = held;
+    parser->displaced = false;
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < size; i++) {
+            ParserDecl* decl = &decls[i];
+            bool fn = parser->tokens->type[decl->start] == TOK_FN;
+
+            if (pass == 0 && fn) {
+                decl->head_from = held->errors;
+                decl->symb = parser_declare_fn(parser, decl);
+                decl->head_until = held->errors;
+                continue;
+            }
+
+            if ((pass == 0) == fn) {
+                continue;
+            }
+
+            decl->scope = parser_reserve_scopes(parser, decl);
+
+            parser_parse_decl(parser, decl);
+        }
+    }
+
+    parser->lexer = lexer;
+
+    // the new declarations' symbols (linked at the end of the table), moved where the old ones
+    // were, each declaration's in a run of its own
+    Symbol* symb = (mark) ? mark->next : tbl->symbol;
+
+    if (mark) {
+        mark->next = NULL;
+    } else {
+        tbl->symbol = NULL;
+    }
+
+    tbl->last = mark;
+
+    size_t old_size, new_size;
+    uint64_t* old_names = parser_exports(old, &old_size);
+    uint64_t* new_names = parser_exports(symb, &new_size);
 
-        AST_Node* tmp = parser->tree->right; 
+    while (symb != NULL) {
+        Symbol* next = symb->next;
+        ParserDecl* decl = &decls[symb->data.owner - parser->owners - 1];
 
-        parser->tree = tmp;
+        symb->next = NULL;
+
+        if (decl->last) {
+            decl->last->next = symb;
+        } else {
+            decl->symbols = symb;
+        }
+
+        decl->last = symb;
+        symb = next;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        if (decls[i].symbols) {
+            *link = decls[i].symbols;
+            link = &decls[i].last->next;
+            tbl->last = (after) ? tbl->last : decls[i].last;
+        }
     }
 
+    *link = after;
 
-    return;
+    bool same = !parser->displaced;
+
+    for (size_t i = 0; i < size; i++) {
+        same = same && !decls[i].stop && !decls[i].eof;
+    }
+
+    same = same && old_size == new_size && memcmp(old_names, new_names, old_size * sizeof(uint64_t)) == 0;
+
+    free(old_names);
+    free(new_names);
+    parser_free_symbols(old);
+
+    if (!same) {
+        lexer_view_free(held);
+        return false;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        lexer_replay_diag(held, decls[i].head_from, decls[i].head_until, lexer);
+        lexer_replay_diag(held, decls[i].diag_from, decls[i].diag_until, lexer);
+    }
+
+    lexer_view_free(held);
+
+    // splice the new declarations in, moving the ones after them along with their tokens (in
+    // place when they're as many as the old ones)
+    ASTN_Root* root = &parser->root->data.root;
+    size_t count = root->size - (e - d) + size;
+
+    for (size_t k = d; k < e; k++) {
+        parser->garbage += spans[k].bytes;
+    }
+
+    for (size_t k = e; k < root->size && shift != 0; k++) {
+        parser_shift_bodies(AST_VEC_ITEMS(*root)[k], &spans[k], shift);
+
+        spans[k].start = (size_t)((ptrdiff_t)spans[k].start + shift);
+        spans[k].end = (size_t)((ptrdiff_t)spans[k].end + shift);
+    }
+
+    if (size != e - d) {
+        ASTN_Root spliced = {0};
+        ParserSpan* moved = malloc((count + 1) * sizeof(ParserSpan));
+
+        if (!moved) {
+            exit(EXIT_FAILURE);
+        }
+
+        AST_VEC_RESERVE(&parser->arena, spliced, count);
+
+        AST_Node** kept = AST_VEC_ITEMS(*root);
+
+        memcpy(AST_VEC_ITEMS(spliced), kept, d * sizeof(AST_Node*));
+        memcpy(AST_VEC_ITEMS(spliced) + d + size, kept + e, (root->size - e) * sizeof(AST_Node*));
+        memcpy(moved, spans, d * sizeof(ParserSpan));
+        memcpy(moved + d + size, spans + e, (root->size - e) * sizeof(ParserSpan));
+
+        // (the old array stays allocated in the arena, as the replaced declarations do)
+        parser->garbage += root->capacity * sizeof(AST_Node*);
+
+        spliced.size = (uint32_t)count;
+        *root = spliced;
+
+        free(parser->spans);
+        parser->spans = spans = moved;
+        parser->spans_size = count;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        AST_VEC_ITEMS(*root)[d + i] = decls[i].node;
+        spans[d + i] = (ParserSpan){
+            decls[i].start, decls[i].end, decls[i].owner, decls[i].bytes, decls[i].symbols, decls[i].last
+        };
+    }
+
+    parser->owners += (uint32_t)size;
+
+    return true;
 }
 
+bool parser_reparse(Parser* parser, size_t offset, size_t removed, const char* text, size_t inserted) {
+    /*
+    Replaces provided # of bytes of the source at offset with inserted bytes of text and brings
+    the tree up to date: tokens are lexed again only around the edit, and only the top-level
+    declarations holding them are parsed again, their nodes and symbols replacing the old ones
+    (every other node and symbol is kept). The whole file is parsed again instead when the edit
+    could change how other declarations parse: when the top-level names it declares change, when
+    it touches an attr or class declaration (others share their nodes) or when parsing stops in
+    it; and once the declarations replaced so far take half of the parser's memory, as they stay
+    allocated until then (so edits cost as much memory as they'd parse, amortized)
+    return: true if the tree was updated in place; false if the whole file was parsed again or
+    the range lies past the end of the source (nothing changed)
+    */
+
+    Lexer* lexer = parser->lexer;
+    TokenStream* tokens = parser->tokens;
+    ParserSpan* spans = parser->spans;
+
+    if (offset > lexer->buf_size || removed > lexer->buf_size - offset) {
+        return false;
+    }
+
+    // first token that may change: the last one starting before the edit (or one more, for
+    // tokens decided by looking past their end)
+    size_t lo = 0, hi = tokens->size;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (tokens->offset[mid] < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    size_t first = (lo > 1) ? lo - 2 : 0;
+
+    // declaration holding it: the last one starting at or before it
+    size_t d = 0;
+
+    for (size_t lo = 1, hi = parser->spans_size; lo < hi;) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (spans[mid].start <= first) {
+            d = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    bool incremental = parser->spans_size > 0 && spans[0].start <= first && first < spans[parser->spans_size - 1].end;
+
+    incremental = incremental && !parser_is_extended(AST_VEC_ITEMS(parser->root->data.root)[d]);
+    incremental = incremental && parser->garbage * 2 <= parser_bytes(parser) + parser->scopes->size * sizeof(Scope);
+
+    lexer_edit(lexer, offset, removed, text, inserted);
+
+    size_t lexed;
+    size_t replaced = lexer_retokenize(lexer, tokens, first, offset + inserted, (ptrdiff_t)inserted - (ptrdiff_t)removed, &lexed);
+    ptrdiff_t shift = (ptrdiff_t)lexed - (ptrdiff_t)replaced;
+
+    parser->value = NULL;
+
+    // declarations from d's start on up to the first one that starts right where an old one did
+    // (past the tokens lexed again); they replace the old ones from d up to that one
+    size_t e = parser->spans_size, size = 0, capacity = 4;
+    ParserDecl* decls = malloc(capacity * sizeof(ParserDecl));
+
+    if (!decls) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = (incremental) ? spans[d].start : 0, k = d + 1; incremental && tokens->type[i] != TOK_EOF;) {
+        size_t end = parser_scan_decl(tokens, i);
+
+        if (size == capacity) {
+            capacity *= 2;
+            decls = realloc(decls, capacity * sizeof(ParserDecl));
+
+            if (!decls) {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        decls[size++] = (ParserDecl){ .start = i, .end = end };
+        incremental = incremental && tokens->type[i] != TOK_ATTR && tokens->type[i] != TOK_CLASS;
+        i = end;
+
+        if (i < first + lexed) {
+            continue;
+        }
+
+        while (k < parser->spans_size && (ptrdiff_t)spans[k].start + shift < (ptrdiff_t)i) {
+            incremental = incremental && !parser_is_extended(AST_VEC_ITEMS(parser->root->data.root)[k]);
+            k++;
+        }
+
+        if (k < parser->spans_size && (ptrdiff_t)spans[k].start + shift == (ptrdiff_t)i) {
+            e = k;
+            break;
+        }
+    }
+
+    if (incremental) {
+        incremental = parser_reparse_decls(parser, d, e, decls, size, shift);
+    }
+
+    free(decls);
+
+    if (!incremental) {
+        parser_reset(parser);
+        parser_parse(parser);
+
+        return false;
+    }
+
+    parser_seek(parser, tokens->size - 1);
+
+    return true;
+}
 
 /* int parse_stospec(Parser* parser, bool expect_further) {
-    if (!(parser->cur->type == TOK_VAR || parser->cur->type == TOK_MUT || parser->cur->type == TOK_CONST)) {
+    if (!(PCT(parser) == TOK_VAR || PCT(parser) == TOK_MUT || PCT(parser) == TOK_CONST)) {
         return NULL;
     }
 
     if (!expect_further) {
-        return parser->cur->type;
+        return PCT(parser);
     }
 
     if (parser_expect(parser, TOK_COLON)) {
@@ -163,61 +1261,54 @@ ASTN_Literal parser_parse_literal(Parser* parser) {
     ASTN_Literal lit;
     char *endptr;
 
-    if (!IS_LITERAL(parser->cur->type)) {
+    if (!IS_LITERAL(PCT(parser))) {
         lit.type = -1;
         return lit;
     }
 
-    lit.type = parser->cur->type;
-
+    lit.type = PCT(parser);
+
+    if (IS_INT_LITERAL(lit.type)) {
+        // the lexer already parsed the value; every width is filled so narrow literals read
+        // back correctly through wider fields
+        __uint128_t num = token_stream_number(parser->tokens, parser->pos);
+
+        if (lit.type <= TOK_L_LLINT) {
+            lit.value.int_.bit8 = (int8_t)num;
+            lit.value.int_.bit16 = (int16_t)num;
+            lit.value.int_.bit32 = (int32_t)num;
+            lit.value.int_.bit64 = (int64_t)num;
+            lit.value.int_.bit128 = (__int128_t)num;
+        } else {
+            lit.value.uint.bit8 = (uint8_t)num;
+            lit.value.uint.bit16 = (uint16_t)num;
+            lit.value.uint.bit32 = (uint32_t)num;
+            lit.value.uint.bit64 = (uint64_t)num;
+            lit.value.uint.bit128 = num;
+        }
+
+        parser_consume(parser);
+        return lit;
+    }
+
     switch (lit.type) {
-        case TOK_L_SSINT:
-            lit.value.int_.bit8 = (int8_t)strtol(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_SINT:
-            lit.value.int_.bit16 = (int16_t)strtol(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_INT:
-            lit.value.int_.bit32 = (int32_t)strtol(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_LINT:
-            lit.value.int_.bit64 = (int64_t)strtol(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_LLINT:
-            lit.value.int_.bit128 = (__int128_t)strtoll(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_SSUINT:
-            lit.value.uint.bit8 = (uint8_t)strtoul(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_SUINT:
-            lit.value.uint.bit16 = (uint16_t)strtoul(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_UINT:
-            lit.value.uint.bit32 = (uint32_t)strtoul(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_LUINT:
-            lit.value.uint.bit64 = (uint64_t)strtoull(parser->cur->value, &endptr, 10);
-            break;
-        case TOK_L_LLUINT:
-            lit.value.uint.bit128 = (__uint128_t)strtoull(parser->cur->value, &endptr, 10);
-            break;
         case TOK_L_FLOAT:
-            lit.value.float_.bit32 = strtof(parser->cur->value, &endptr);
+            lit.value.float_.bit32 = strtof(PCV(parser), &endptr);
             break;
         case TOK_L_DOUBLE:
-            lit.value.float_.bit64 = strtod(parser->cur->value, &endptr);
+            lit.value.float_.bit64 = strtod(PCV(parser), &endptr);
             break;
         case TOK_L_CHAR:
-            lit.value.character = (parser->cur->value[0] != '\0') ? parser->cur->value[0] : '\0';
+            lit.value.character = (PCV(parser)[0] != '\0') ? PCV(parser)[0] : '\0';
             break;
         case TOK_L_STRING:
-            lit.value.string = parser->cur->value;
+            lit.value.string = PCV(parser);
             break;
         case TOK_L_BOOL:
-            lit.value.boolean = strtol(parser->cur->value, &endptr, 10) != 0;
+            lit.value.boolean = strtol(PCV(parser), &endptr, 10) != 0;
             break;
         case TOK_L_SIZE:
-            lit.value.size = (size_t)strtoull(parser->cur->value, &endptr, 10);
+            lit.value.size = (size_t)strtoull(PCV(parser), &endptr, 10);
             break;
         default: lit.type = -1; return lit; break;
     }
@@ -286,7 +1377,7 @@ ASTN_DataTypeSpecifier parser_parse_dt_spec(Parser* parser, bool expect_further)
         if (parser_expect(parser, TOK_RBRACK)) {
             dts.is_arr = true; return dts;
         }
-        REPORT_ERROR(parser->lexer, "E_CLOSE_BRACK", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_CLOSE_BRACK", PCV(parser));
         dts.data.prim = 0;
         return dts;
     }
@@ -298,136 +1389,102 @@ ASTN_DataTypeSpecifier parser_parse_dt_spec(Parser* parser, bool expect_further)
     return dts;
 }
 
-ASTN_Call parser_parse_call(Parser* parser, uint8_t scopeOS) {
+ASTN_Call parser_parse_call(Parser* parser) {
     ASTN_Call call;
+    call.type = CALL_FN;
+    call.args = 0;
+    call.size = 0;
     
-    Symbol* symb = symtbl_lookup(parser->tbl, parser->cur->value, 0, 0);
+    Symbol* symb = parser_find(parser, PCA(parser));
 
     if (symb == NULL || symb->data.type != SYMBOL_FUNCTION) {
-        call.identifier = 0;
+        call.identifier = (ASTN_Iden){ 0, 0 };
         return call;
     }
 
     parser_consume(parser);
 
     if (!(parser_expect(parser, TOK_LPAREN))) {
-        call.identifier = 0;
+        call.identifier = (ASTN_Iden){ 0, 0 };
         return call;
     } 
 
-    call.identifier = symb->data.id;
+    call.identifier = SYMBOL_IDEN(symb);
 
-    ASTN_CallParams* params = calloc(1, sizeof(ASTN_CallParams));
+    // arguments wait in the pool's scratch until the closing paren (arguments of nested calls
+    // stack above them), then move to args in one contiguous run
+    ASTN_ExprPool* exprs = &parser->exprs;
+    size_t scratch = exprs->scratch_size;
 
-    params->size = 0;
-    params->item_size = sizeof(AST_Node*);
-    params->parameter = calloc(1, sizeof(AST_Node*));
+    while (PCT(parser) != TOK_RPAREN) {
+        ast_scratch_push(exprs, parser_parse_expression(parser));
 
-
-    while (parser->cur->type != TOK_RPAREN) {
-        params->parameter[params->size] = parser_parse_expr(parser, scopeOS);
-
-        if (!(parser_expect(parser, TOK_COMMA)) && (parser->cur->type != TOK_RPAREN)) {
-            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", parser->cur->value);
-            call.identifier = 0;
+        if (!(parser_expect(parser, TOK_COMMA)) && (PCT(parser) != TOK_RPAREN)) {
+            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", PCV(parser));
+            exprs->scratch_size = scratch;
+            call.identifier = (ASTN_Iden){ 0, 0 };
             return call;
         }         
-
-        params->parameter = realloc(params->parameter, (params->size + 1) * sizeof(AST_Node));
-        params->size++;
     }
 
-    call.params = params;
-    call.type = CALL_FN;
+    call.size = (uint32_t)(exprs->scratch_size - scratch);
+    call.args = ast_scratch_pop(exprs, scratch);
 
     parser_expect(parser, TOK_RPAREN);
 
-    // printf("[STACK CALL]: %i\n", call.identifier);
-
-    // if (call.params && call.params->parameter) {
-    //     for (size_t i = 0; i < call.params->size; i++) {
-    //         printf("arg [%zu]: %i\n", i, call.params->parameter[i]->data.expr.data.primary.data.literal.type);
-    //     }
-    // }
-
     return call;
 }
 
 
-ASTN_PrimaryExpr parser_parse_prim_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_PrimaryExpr expr;
-    expr.type = -1;
+ASTN_ExprRef parser_parse_prim_expr(Parser* parser) {
+    ASTN_ExprPool* exprs = &parser->exprs;
+    ASTN_ExprRef expr = 0;
 
     ASTN_Literal lit = parser_parse_literal(parser);
     if (lit.type != -1) {
-        expr.type = PRIMARY_LITERAL;
-        expr.data.literal = lit;
-        return expr;
-    }
-
-
-    if (parser->cur->type == TOK_IDEN) {
-        Symbol* symb = symtbl_lookup(parser->tbl, parser->cur->value, 0, 0);
-        if (symb) {
-            if (symb->data.type == SYMBOL_FUNCTION || symb->data.type == SYMBOL_CLASS ||
-                symb->data.type == SYMBOL_STRUCT) {
-                expr.type = PRIMARY_CALL;
-                expr.data.call = parser_parse_call(parser, scopeOS);
-            } else if (symb->data.type == SYMBOL_MODULE) {
-                expr.type = PRIMARY_IDENTIFIER;
-                expr.data.identifier = symb->data.id;
-                parser_consume(parser);
-            }
-        } else {
-            Symbol* symb2 = symtbl_lookup(parser->tbl, parser->cur->value, parser->scope, scopeOS);
-            if (symb2) {
-                expr.type = PRIMARY_IDENTIFIER;
-                expr.data.identifier = symb2->data.id;
-                parser_consume(parser);
-            } else {
-                REPORT_ERROR(parser->lexer, "U_USOF_UNDEFV");
-                expr.type = PRIMARY_IDENTIFIER;
-                expr.data.identifier = 0;
-            }
-        }
-    }
-
-    return expr;
-}
+        uint32_t literal = ast_literal_push(exprs, &lit);
 
+        expr = ast_expr_init(exprs, EXPR_LITERAL, 0);
+        AST_EXPR(exprs, expr)->data.literal = literal;
+        return ast_expr_cons(exprs, expr);
+    }
 
-ASTN_FactorExpr parser_parse_factor_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_FactorExpr expr;
-    expr.type = -1;
 
+    if (PCT(parser) == TOK_IDEN) {
+        // (a name bound in an open scope hides the top-level one)
+        Symbol* symb = symtbl_lookup(parser->tbl, PCA(parser));
 
-    if (parser->cur->type == TOK_MINUS_MINUS || parser->cur->type == TOK_ADD_ADD ||
-        parser->cur->type == TOK_MINUS || parser->cur->type == TOK_BANG) {
-        expr.type = FACTOR_UNARY_OP;
-        expr.data.unary_op.op = parser->cur->type;
-        parser_consume(parser);
-        expr.data.unary_op.expr = parser_parse_expression(parser, scopeOS);
-        if (!expr.data.unary_op.expr) {
-            return expr;
+        if (!symb) {
+            symb = parser_find(parser, PCA(parser));
         }
-    } else {
-        expr.data.primary = parser_parse_prim_expr(parser, scopeOS);
 
-        if (expr.data.primary.type == -1) {
-            REPORT_ERROR(parser->lexer, "E_PROP_EXP", parser->cur->value);
-            return expr;
-        }
-        expr.type = FACTOR_PRIMARY;
-        if (parser->cur->type == TOK_MINUS_MINUS || parser->cur->type == TOK_ADD_ADD) {
-            ASTN_FactorExpr post_expr;
-            post_expr.type = FACTOR_UNARY_OP;
-            post_expr.data.unary_op.op = parser->cur->type;
+        if (!symb) {
+            expr = ast_expr_init(exprs, EXPR_IDENTIFIER, 0);
+            REPORT_ERROR(parser->lexer, "U_USOF_UNDEFV");
             parser_consume(parser);
-            post_expr.data.unary_op.expr = parser_parse_expression(parser, scopeOS);
-            if (!post_expr.data.unary_op.expr) {
-                return expr;
+
+            // (a call to a function not declared yet: its arguments are skipped with it)
+            if (PCT(parser) == TOK_LPAREN) {
+                size_t depth = 0;
+
+                do {
+                    depth += (PCT(parser) == TOK_LPAREN);
+                    depth -= (PCT(parser) == TOK_RPAREN);
+                    parser_consume(parser);
+                } while (depth > 0);
             }
-            return post_expr;
+        } else if (symb->data.type == SYMBOL_FUNCTION || symb->data.type == SYMBOL_CLASS ||
+            symb->data.type == SYMBOL_STRUCT) {
+            ASTN_Call call = parser_parse_call(parser);
+            uint32_t index = ast_call_push(exprs, &call);
+
+            expr = ast_expr_init(exprs, EXPR_FUNCTION_CALL, 0);
+            AST_EXPR(exprs, expr)->data.call = index;
+        } else if (symb->data.type == SYMBOL_MODULE || symb->data.type == SYMBOL_VARIABLE) {
+            expr = ast_expr_init(exprs, EXPR_IDENTIFIER, 0);
+            AST_EXPR(exprs, expr)->data.identifier = SYMBOL_IDEN(symb);
+            expr = ast_expr_cons(exprs, expr);
+            parser_consume(parser);
         }
     }
 
@@ -435,402 +1492,178 @@ ASTN_FactorExpr parser_parse_factor_expr(Parser* parser, uint8_t scopeOS) {
 }
 
 
-ASTN_TermExpr parser_parse_term_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_TermExpr expr;
-    expr.type = -1;
-
-    expr.data.factor = parser_parse_factor_expr(parser, scopeOS);
-
-
-    if (expr.data.factor.type == -1) {
-        return expr;
-    }
-    expr.type = TERM_FACTOR;
-
-    while (parser->cur->type == TOK_ASTK_ASTK) {
-        ASTN_TermExpr new_expr;
-        new_expr.type = TERM_BINARY_OP;
-
-        parser_consume(parser);
-
-        new_expr.data.binary_op.left = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.left) {
-            return expr;
-        }
-        
-        if (expr.type != -1) {
-            new_expr.data.binary_op.left->type = EXPR_ADDITION;
-            new_expr.data.binary_op.left->data.factor = expr.data.factor;
-        } else {
-            new_expr.data.binary_op.left = parser_parse_expression(parser, scopeOS);
-        }
+ASTN_ExprRef parser_parse_factor_expr(Parser* parser) {
+    /*
+    Parses an operand of a binary expression: a prefix operator applied to an operand, a
+    parenthesized expression or a primary with an optional postfix operator
+    return: reference to the operand; 0 (reported) if none could be parsed
+    */
 
-        new_expr.data.binary_op.op = TOK_ASTK_ASTK;
+    ASTN_ExprPool* exprs = &parser->exprs;
+    ASTN_ExprRef expr;
 
+    if (PCT(parser) == TOK_MINUS_MINUS || PCT(parser) == TOK_ADD_ADD ||
+        PCT(parser) == TOK_MINUS || PCT(parser) == TOK_BANG) {
+        uint8_t op = PCT(parser);
         parser_consume(parser);
 
-        new_expr.data.binary_op.right = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            return expr;
-        }
-
-        new_expr.data.binary_op.right = parser_parse_expression(parser, scopeOS); 
-        
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            free(new_expr.data.binary_op.right);
-            return expr;
+        ASTN_ExprRef operand = parser_parse_factor_expr(parser);
+        if (!operand) {
+            return 0;
         }
 
-        expr.type = TERM_BINARY_OP;
-        expr.data = new_expr.data;
-    }
-
-    return expr;
-}
-
-ASTN_MultiplicationExpr parser_parse_mult_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_MultiplicationExpr expr;
-    expr.type = -1;
+        expr = ast_expr_init(exprs, EXPR_FACTOR, op);
+        AST_EXPR(exprs, expr)->data.unary_op.expr = operand;
 
-    expr.data.term = parser_parse_term_expr(parser, scopeOS);
-
-    if (expr.data.term.type == -1) {
-        return expr;
+        // (-- and ++ change their operand, so they're never shared)
+        return (op == TOK_MINUS || op == TOK_BANG) ? ast_expr_cons(exprs, expr) : expr;
     }
 
-    expr.type = MULTIPLICATION_TERM;
-
-    while (parser->cur->type == TOK_ASTK || parser->cur->type == TOK_SLASH || parser->cur->type == TOK_PERC) {
-        ASTN_MultiplicationExpr new_expr;
-        new_expr.type = MULTIPLICATION_BINARY_OP;
-
-        new_expr.data.binary_op.left = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.left) {
-            return expr;
-        }
-        
-        if (expr.type != -1) {
-            new_expr.data.binary_op.left->type = EXPR_ADDITION;
-            new_expr.data.binary_op.left->data.term = expr.data.term;
-        } else {
-            new_expr.data.binary_op.left = parser_parse_expression(parser, scopeOS);
-        }
-
+    if (PCT(parser) == TOK_LPAREN) {
         parser_consume(parser);
 
-        new_expr.data.binary_op.right = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            return expr;
-        }
-        
-        new_expr.data.binary_op.right = parser_parse_expression(parser, scopeOS);
-        
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            free(new_expr.data.binary_op.right);
-            return expr;
+        ASTN_ExprRef inner = parser_parse_binary_expr(parser, 0);
+        if (!inner) {
+            return 0;
         }
 
-        expr = new_expr;
+        if (PCT(parser) == TOK_RPAREN) parser_consume(parser);
 
+        expr = ast_expr_init(exprs, EXPR_NEST, 0);
+        AST_EXPR(exprs, expr)->data.unary_op.expr = inner;
+        return ast_expr_cons(exprs, expr);
     }
 
-    return expr;
-}
-
-ASTN_AdditionExpr parser_parse_add_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_AdditionExpr expr;
-    expr.type = -1;
+    expr = parser_parse_prim_expr(parser);
 
-    expr.data.multiplication = parser_parse_mult_expr(parser, scopeOS);
-
-    if (expr.data.multiplication.type == -1) {
-        return expr;
+    if (!expr) {
+        REPORT_ERROR(parser->lexer, "E_PROP_EXP", PCV(parser));
+        return 0;
     }
 
-    expr.type = ADDITION_MULTIPLICATION;
-
-    while (parser->cur->type == TOK_ADD || parser->cur->type == TOK_MINUS) {
-        ASTN_AdditionExpr new_expr;
-        new_expr.type = ADDITION_BINARY_OP;
-
-        new_expr.data.binary_op.left = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.left) {
-            return expr;
-        }
-        
-        if (expr.type != -1) {
-            new_expr.data.binary_op.left->type = EXPR_ADDITION;
-            new_expr.data.binary_op.left->data.multiplication = expr.data.multiplication;
-        } else {
-            new_expr.data.binary_op.left = parser_parse_expression(parser, scopeOS);
-        }
-
-        new_expr.data.binary_op.op = parser->cur->type;
+    if (PCT(parser) == TOK_MINUS_MINUS || PCT(parser) == TOK_ADD_ADD) {
+        ASTN_ExprRef operand = expr;
 
+        expr = ast_expr_init(exprs, EXPR_POSTFIX, PCT(parser));
+        AST_EXPR(exprs, expr)->data.unary_op.expr = operand;
         parser_consume(parser);
-
-        new_expr.data.binary_op.right = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            return expr;
-        }
-        
-        new_expr.data.binary_op.right = parser_parse_expression(parser, scopeOS);
-        
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            free(new_expr.data.binary_op.right);
-            return expr;
-        }
-
-        expr = new_expr;
     }
 
     return expr;
 }
 
-ASTN_BitwiseExpr parser_parse_bitw_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_BitwiseExpr expr;
-    expr.type = -1;
-
-    expr.data.addition = parser_parse_add_expr(parser, scopeOS);
-
-    if (expr.data.addition.type == -1) {
-        return expr;
-    }
-
-    expr.type = BITWISE_ADDITION;
-
-    while (parser->cur->type == TOK_AMPER || parser->cur->type == TOK_PIPE || parser->cur->type == TOK_GT_GT || parser->cur->type == TOK_LT_LT) {
-        ASTN_BitwiseExpr new_expr;
-        new_expr.type = BITWISE_BINARY_OP;
-
-        new_expr.data.binary_op.left = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.left) {
-            return expr;
-        }
-
-        if (expr.type != -1) {
-            new_expr.data.binary_op.left->type = EXPR_ADDITION;
-            new_expr.data.binary_op.left->data.addition = expr.data.addition;
-        } else {
-            new_expr.data.binary_op.left = parser_parse_expression(parser, scopeOS);
-        }
 
-        new_expr.data.binary_op.op = parser->cur->type;
+// binding power and node type of every binary operator, indexed by its token type (tokens
+// missing from the table have no binding power and end an expression)
+static const struct {
+    uint8_t prec;
+    uint8_t type;
+} parser_binary_ops[TOK_L_SIZE + 1] = {
+    [TOK_LT_EQ] = {1, EXPR_COMPARISON},
+    [TOK_GT_EQ] = {1, EXPR_COMPARISON},
+    [TOK_BANG_EQ] = {1, EXPR_COMPARISON},
+    [TOK_EQ_EQ] = {1, EXPR_COMPARISON},
+    [TOK_LT] = {1, EXPR_COMPARISON},
+    [TOK_GT] = {1, EXPR_COMPARISON},
 
-        parser_consume(parser);
+    [TOK_AMPER] = {2, EXPR_BITWISE},
+    [TOK_PIPE] = {2, EXPR_BITWISE},
+    [TOK_GT_GT] = {2, EXPR_BITWISE},
+    [TOK_LT_LT] = {2, EXPR_BITWISE},
 
-        new_expr.data.binary_op.right = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            return expr;
-        }
-        
-        new_expr.data.binary_op.right = parser_parse_expression(parser, scopeOS);
-        
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            free(new_expr.data.binary_op.right);
-            return expr;
-        }
+    [TOK_ADD] = {3, EXPR_ADDITION},
+    [TOK_MINUS] = {3, EXPR_ADDITION},
 
-        expr = new_expr;
-    }
+    [TOK_ASTK] = {4, EXPR_MULTIPLICATION},
+    [TOK_SLASH] = {4, EXPR_MULTIPLICATION},
+    [TOK_PERC] = {4, EXPR_MULTIPLICATION},
 
-    return expr;
-}
+    [TOK_ASTK_ASTK] = {5, EXPR_TERM} // right associative
+};
 
-ASTN_ComparisonExpr parser_parse_comp_expr(Parser* parser, uint8_t scopeOS) {
-    ASTN_ComparisonExpr expr;
-    expr.type = -1;
+ASTN_ExprRef parser_parse_binary_expr(Parser* parser, uint8_t min_prec) {
+    /*
+    Parses operands joined by binary operators binding tighter than min_prec (precedence
+    climbing), building every binary node in place in the pool
+    return: reference to the expression; 0 if its first operand couldn't be parsed
+    */
 
-    expr.data.bitwise = parser_parse_bitw_expr(parser, scopeOS);
+    ASTN_ExprPool* exprs = &parser->exprs;
+    ASTN_ExprRef left = parser_parse_factor_expr(parser);
 
-    if (expr.data.bitwise.type == -1) {
-        return expr;
+    if (!left) {
+        return 0;
     }
 
-    expr.type = COMPARISON_BITWISE;
-
-    while (parser->cur->type == TOK_LT_EQ || parser->cur->type == TOK_GT_EQ || parser->cur->type == TOK_BANG_EQ || parser->cur->type == TOK_EQ_EQ || parser->cur->type == TOK_LT || parser->cur->type == TOK_GT) {
-        ASTN_ComparisonExpr new_expr;
-        new_expr.type = COMPARISON_BINARY_OP;
-
-        new_expr.data.binary_op.left = malloc(sizeof(ASTN_Expression));
-        if (!new_expr.data.binary_op.left)  {
-            return expr;
-        }
+    while (true) {
+        uint8_t op = PCT(parser);
+        uint8_t prec = parser_binary_ops[op].prec;
 
-        if (expr.type != -1) {
-            new_expr.data.binary_op.left->type = EXPR_BITWISE;
-            new_expr.data.binary_op.left->data.bitwise = expr.data.bitwise;
-        } else {
-            new_expr.data.binary_op.left = parser_parse_expression(parser, scopeOS);
+        if (prec <= min_prec) {
+            return left;
         }
 
-        new_expr.data.binary_op.op = parser->cur->type;
-
         parser_consume(parser);
 
-        new_expr.data.binary_op.right = malloc(sizeof(ASTN_Expression));
-        
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            return expr;
-        }
-        
-        new_expr.data.binary_op.right = parser_parse_expression(parser, scopeOS);
-        
-        if (!new_expr.data.binary_op.right) {
-            free(new_expr.data.binary_op.left);
-            free(new_expr.data.binary_op.right);
-            return expr;
-        }
-
-        expr = new_expr;
-    }
-
-    return expr;
-}
+        // ** binds its right operand at its own level, every other operator above it
+        ASTN_ExprRef right = parser_parse_binary_expr(parser, (op == TOK_ASTK_ASTK) ? prec - 1 : prec);
 
+        if (!right) {
+            return left;
+        }
 
+        ASTN_ExprRef expr = ast_expr_init(exprs, parser_binary_ops[op].type, op);
+        AST_EXPR(exprs, expr)->data.binary_op.left = left;
+        AST_EXPR(exprs, expr)->data.binary_op.right = right;
 
-ASTN_Expression* parser_parse_expression(Parser* parser, uint8_t scopeOS) {
-    ASTN_Expression* expr = malloc(sizeof(ASTN_Expression));
-    if (expr == NULL) {
-        return NULL;
+        left = ast_expr_cons(exprs, expr);
     }
+}
 
-    expr->type = -1;
-    bool expect_db_close;
-
-    if (parser->cur->type == TOK_LPAREN) {
-        parser_consume(parser);
-        ASTN_Expression* nested_expr = parser_parse_expression(parser, scopeOS);
-        nested_expr->type = EXPR_NEST;
-        if (nested_expr == NULL) {
-            free(expr);
-            return NULL;
-        }
-
-        if (parser->cur->type == TOK_RPAREN) parser_consume(parser);
-
-        while (parser->cur->type == TOK_ASTK_ASTK || parser->cur->type == TOK_ASTK || parser->cur->type == TOK_SLASH || parser->cur->type == TOK_PERC
-        || parser->cur->type == TOK_ADD || parser->cur->type == TOK_MINUS || parser->cur->type == TOK_AMPER || parser->cur->type == TOK_PIPE
-        || parser->cur->type == TOK_GT_GT || parser->cur->type == TOK_LT_LT || parser->cur->type == TOK_LT || parser->cur->type == TOK_GT
-        || parser->cur->type == TOK_ADD || parser->cur->type == TOK_MINUS || parser->cur->type == TOK_LT_EQ || parser->cur->type == TOK_GT_EQ
-        || parser->cur->type == TOK_BANG_EQ || parser->cur->type == TOK_EQ_EQ
-        ) {
-            expect_db_close = true;
-            int op_type = parser->cur->type;
-            parser_consume(parser); 
 
-            ASTN_Expression* right_expr = parser_parse_expression(parser, scopeOS);
-            if (right_expr == NULL) {
-                free(expr);
-                free(nested_expr);
-                return NULL;
-            }
+ASTN_ExprRef parser_parse_expression(Parser* parser) {
+    ASTN_ExprRef expr = parser_parse_binary_expr(parser, 0);
 
-            ASTN_Expression* compound_expr = malloc(sizeof(ASTN_Expression));
-            if (compound_expr == NULL) {
-                free(expr);
-                free(nested_expr);
-                free(right_expr);
-                return NULL;
-            }
-            compound_expr->type = op_type;
-            compound_expr->data.nest.data.binary_op.left = nested_expr;
-            compound_expr->data.nest.data.binary_op.right = right_expr;
-
-            nested_expr = compound_expr;
-        }
-
-        if (parser->cur->type == TOK_RPAREN && expect_db_close) parser_consume(parser);
-
-        *expr = *nested_expr;
-        return expr;
-    }
-
-    ASTN_ComparisonExpr x = parser_parse_comp_expr(parser, scopeOS);
-
-    if (x.type == COMPARISON_BINARY_OP) {
-        expr->type = EXPR_COMPARISON;
-        expr->data.comparison = x;
-    } else if (x.data.bitwise.type == BITWISE_BINARY_OP) {
-        expr->type = EXPR_BITWISE;
-        expr->data.bitwise = x.data.bitwise;
-    } else if (x.data.bitwise.data.addition.type == ADDITION_BINARY_OP) {
-        expr->type = EXPR_ADDITION;
-        expr->data.addition = x.data.bitwise.data.addition;
-    } else if (x.data.bitwise.data.addition.data.multiplication.type == MULTIPLICATION_BINARY_OP) {
-        expr->type = EXPR_MULTIPLICATION;
-        expr->data.multiplication = x.data.bitwise.data.addition.data.multiplication;
-    } else if (x.data.bitwise.data.addition.data.multiplication.data.term.type == TERM_BINARY_OP) {
-        expr->type = EXPR_TERM;
-        expr->data.term = x.data.bitwise.data.addition.data.multiplication.data.term;
-    } else if (x.data.bitwise.data.addition.data.multiplication.data.term.data.factor.type == FACTOR_UNARY_OP) {
-        expr->type = EXPR_FACTOR;
-        expr->data.factor = x.data.bitwise.data.addition.data.multiplication.data.term.data.factor;
-    } else if (x.data.bitwise.data.addition.data.multiplication.data.term.data.factor.type == FACTOR_PRIMARY) {
-        switch (x.data.bitwise.data.addition.data.multiplication.data.term.data.factor.data.primary.type) {
-            case PRIMARY_IDENTIFIER:
-                expr->type = EXPR_IDENTIFIER;
-                expr->data.identifier = x.data.bitwise.data.addition.data.multiplication.data.term.data.factor.data.primary.data.identifier;
-                break;
-            case PRIMARY_LITERAL:
-                expr->type = EXPR_LITERAL;
-                expr->data.literal = x.data.bitwise.data.addition.data.multiplication.data.term.data.factor.data.primary.data.literal;
-                break;
-            case PRIMARY_CALL:
-                expr->type = EXPR_FUNCTION_CALL;
-                expr->data.function_call = x.data.bitwise.data.addition.data.multiplication.data.term.data.factor.data.primary.data.call;
-                break;
-        }
-    } else {
+    if (!expr) {
         REPORT_ERROR(parser->lexer, "UNA_PARSE_EXPR");
         while (!(parser_expect(parser, TOK_SC))) {
             parser_consume(parser);
         }
         parser_consume(parser);
-        return NULL;
+        return 0;
     }
 
     return expr;
 }
 
 
-AST_Node* parser_parse_expr(Parser* parser, uint8_t scopeOS) {
-    AST_Node* node = ast_init(EXPR);    
-    node->data.expr = *parser_parse_expression(parser, scopeOS);
+AST_Node* parser_parse_expr(Parser* parser) {
+    AST_Node* node = ast_init(&parser->arena, STMT);
+    node->data.stm.type = STMT_EXPRESSION;
+    node->data.stm.data.expression = parser_parse_expression(parser);
 
     return node;
 }
 
 
 ASTN_Parameter* parser_parse_parameter(Parser* parser) {
-    ASTN_Parameter* param = calloc(1, sizeof(ASTN_Parameter));
+    ASTN_Parameter* param = arena_calloc(&parser->arena, 1, sizeof(ASTN_Parameter));
     param->data_type_specifier = parser_parse_dt_spec(parser, false);
 
     if (param->data_type_specifier.data.prim == 0) {
-        REPORT_ERROR(parser->lexer, "E_DTS_FN_PARAM", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_DTS_FN_PARAM", PCV(parser));
         return  NULL;
     }
 
     if (!(parser_expect(parser, TOK_COLON))) {
-        REPORT_ERROR(parser->lexer, "E_PARAM_COLON", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_PARAM_COLON", PCV(parser));
         return NULL;
     }   
 
-    param->identifier = parser->cur->value;
+    param->identifier = PCV(parser);
 
     if (!(parser_expect(parser, TOK_IDEN))) {
-        REPORT_ERROR(parser->lexer, "E_PARAM_IDEN", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_PARAM_IDEN", PCV(parser));
         return NULL;
     }
 
@@ -839,34 +1672,29 @@ ASTN_Parameter* parser_parse_parameter(Parser* parser) {
 
 ASTN_Parameters* parser_parse_parameters(Parser* parser) {
     if (!(parser_expect(parser, TOK_LPAREN))) {
-        REPORT_ERROR(parser->lexer, "E_FN_PARAMETERS", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_FN_PARAMETERS", PCV(parser));
         return NULL;
     }
 
-    ASTN_Parameters* params = calloc(1, sizeof(ASTN_Parameters));
-    params->size = 0;
-    params->item_size = sizeof(ASTN_Parameter*);
-
-    params->parameter = calloc(1, sizeof(ASTN_Parameter*));
-
-    while (parser->cur->type != TOK_RPAREN) {
-        params->parameter[params->size] = parser_parse_parameter(parser);
+    ASTN_Parameters* params = arena_calloc(&parser->arena, 1, sizeof(ASTN_Parameters));
 
+    while (PCT(parser) != TOK_RPAREN) {
+        ASTN_Parameter* param = parser_parse_parameter(parser);
+        AST_VEC_PUSH(&parser->arena, *params, param);
 
+        // (the parameter's name is the token it just consumed)
         symtbl_insert(parser, symbol_init(
-            (char*)params->parameter[params->size]->identifier, SYMBOL_VARIABLE, parser->scope, parser->nest, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc
+            parser_atom(parser, parser->pos - 1), SYMBOL_VARIABLE, parser->scope, parser->nest, 0, 0, 0, 0, PCL(parser), PCC(parser)
         ));
 
-        if (!(parser_expect(parser, TOK_COMMA)) && (parser->cur->type != TOK_RPAREN)) {
-            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", parser->cur->value);
+        if (!(parser_expect(parser, TOK_COMMA)) && (PCT(parser) != TOK_RPAREN)) {
+            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", PCV(parser));
             return NULL;
-        }         
-        
-        params->size++;
+        }
     }
 
     if (!(parser_expect(parser, TOK_RPAREN))) {
-        REPORT_ERROR(parser->lexer, "E_PARAM_PAREN", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_PARAM_PAREN", PCV(parser));
         return NULL;
     }
     
@@ -874,39 +1702,20 @@ ASTN_Parameters* parser_parse_parameters(Parser* parser) {
 }
 
 ASTN_Module* parser_parse_module(Parser* parser) {
-    ASTN_Module* mod = malloc(sizeof(ASTN_Module));
-    if (!mod) {
-        return NULL;
-    }
+    ASTN_Module* mod = arena_alloc(&parser->arena, sizeof(ASTN_Module));
     mod->module = NULL;
     mod->head_module = NULL;
 
     ASTN_Module* current_module = mod;
 
-    while (parser->cur->type == TOK_IDEN || parser->cur->type == TOK_PERIOD) {
-        if (parser->cur->type == TOK_PERIOD) {
+    while (PCT(parser) == TOK_IDEN || PCT(parser) == TOK_PERIOD) {
+        if (PCT(parser) == TOK_PERIOD) {
             parser_consume(parser);
             continue;
         }
 
-        char* token = parser->cur->value;
-        if (!token) {
-            free(mod);
-            return NULL;
-        }
-        
-        ASTN_Module* new_module = malloc(sizeof(ASTN_Module));
-        if (!new_module) {
-            free(mod);
-            return NULL;
-        }
-        
-        new_module->module = strdup(token);
-        if (!new_module->module) {
-            free(mod);
-            free(new_module);
-            return NULL;
-        }
+        ASTN_Module* new_module = arena_alloc(&parser->arena, sizeof(ASTN_Module));
+        new_module->module = PCV(parser); // lives as long as the token stream
         
         new_module->head_module = current_module;
         current_module = new_module;
@@ -915,7 +1724,7 @@ ASTN_Module* parser_parse_module(Parser* parser) {
     }
     
     symtbl_insert(parser, symbol_init(
-        current_module->module, SYMBOL_MODULE, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc 
+        intern_atom(current_module->module, strlen(current_module->module)), SYMBOL_MODULE, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser) 
     ));
 
     return current_module;
@@ -925,29 +1734,24 @@ ASTN_Module* parser_parse_module(Parser* parser) {
 AST_Node* parser_parse_import(Parser* parser) {
     parser_consume(parser);
 
-    AST_Node* statement = ast_init(STMT);
+    AST_Node* statement = ast_init(&parser->arena, STMT);
     if (!statement) {
         return NULL;
     }
 
-    ASTN_ImportDecl import;
-
-    import.modules.items = NULL;
-    import.modules.size = 0;
-    import.modules.item_size = sizeof(ASTN_Module*);
+    ASTN_ImportDecl import = {0};
 
     import.alias = NULL;
     import.source = NULL;
 
-    while (parser->cur->type == TOK_IDEN || parser->cur->type == TOK_COMMA) {
-        if (parser->cur->type == TOK_IDEN) {
+    while (PCT(parser) == TOK_IDEN || PCT(parser) == TOK_COMMA) {
+        if (PCT(parser) == TOK_IDEN) {
             ASTN_Module* module = parser_parse_module(parser);
 
-            import.modules.items = realloc(import.modules.items, (import.modules.size + 1) * sizeof(ASTN_Module*));
-            import.modules.items[import.modules.size++] = module;
-        } else if (parser->cur->type == TOK_COMMA) {
+            AST_VEC_PUSH(&parser->arena, import.modules, module);
+        } else if (PCT(parser) == TOK_COMMA) {
             if (import.modules.size < 1) {
-                REPORT_ERROR(parser->lexer, "E_MODULE_BEF_COMMA", parser->cur->value);
+                REPORT_ERROR(parser->lexer, "E_MODULE_BEF_COMMA", PCV(parser));
                 return NULL;
             }
             parser_consume(parser);
@@ -959,23 +1763,23 @@ AST_Node* parser_parse_import(Parser* parser) {
     if (parser_expect(parser, TOK_FROM)) {
         import.source = parser_parse_module(parser);
         for (size_t i = 0; i < import.modules.size; i++) {
-            import.modules.items[i]->head_module = import.source;
+            AST_VEC_ITEMS(import.modules)[i]->head_module = import.source;
         }
     }
 
     if (parser_expect(parser, TOK_FROM)) {
         if (import.source) {
-            REPORT_ERROR(parser->lexer, "U_DB_SOURCE_DECL", import.source->module, parser->cur->value);
+            REPORT_ERROR(parser->lexer, "U_DB_SOURCE_DECL", import.source->module, PCV(parser));
             return NULL;
         }
     }
 
     if (parser_expect(parser, TOK_AS)) {
         if (import.modules.size > 1) {
-            REPORT_ERROR(parser->lexer, "U_MODULE_MULT_ALIAS", import.modules.size, parser->cur->value);
+            REPORT_ERROR(parser->lexer, "U_MODULE_MULT_ALIAS", import.modules.size, PCV(parser));
             return NULL;
         }
-        import.alias = parser->cur->value;
+        import.alias = PCV(parser);
         parser_consume(parser);
     }
 
@@ -985,26 +1789,23 @@ AST_Node* parser_parse_import(Parser* parser) {
 }
 
 AST_Node* parser_parse_attr_decl(Parser* parser) {
-    ASTN_AttributeDecl attr;
+    ASTN_AttributeDecl attr = {0};
     attr.list = NULL;
 
     parser_consume(parser);
 
-    if (parser->cur->type != TOK_IDEN) {
-        REPORT_ERROR(parser->lexer, "E_FN_NAME", parser->cur->value);
+    if (PCT(parser) != TOK_IDEN) {
+        REPORT_ERROR(parser->lexer, "E_FN_NAME", PCV(parser));
         return NULL;
     }
 
-    Symbol* symb = symbol_init((char*)parser->cur->value, SYMBOL_ATTR, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+    Symbol* symb = symbol_init(PCA(parser), SYMBOL_ATTR, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
     parser_consume(parser);
 
-    PES(parser);
+    PES(parser, SCOPE_ATTR);
 
     if (parser_expect(parser, TOK_EXT)) {
-        ASTN_AttributeList* ext_list = calloc(1, sizeof(ASTN_AttributeList));
-        ext_list->size = 0;
-        ext_list->item_size = sizeof(AST_Node*);
-        ext_list->items = calloc(1, sizeof(AST_Node*));
+        ASTN_AttributeList* ext_list = arena_calloc(&parser->arena, 1, sizeof(ASTN_AttributeList));
 
         if (!parser_parse_extend_attr(parser, ext_list)) {
             return NULL;
@@ -1025,23 +1826,19 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
 
     ASTN_AttributeList* list;
     if (attr.list == NULL) {
-        list = calloc(1, sizeof(ASTN_AttributeList));
-        list->size = 0;
-        list->item_size = sizeof(AST_Node*);
-        list->items = calloc(1, list->item_size);
+        list = arena_calloc(&parser->arena, 1, sizeof(ASTN_AttributeList));
         attr.list = list;
     } else {
         extendedn = attr.list->size;
         list = attr.list;
-        list->items = realloc(list->items, (list->size + 1) * list->item_size);
     }
 
-    while (parser->cur->type != TOK_RBRACE) {
+    while (PCT(parser) != TOK_RBRACE) {
         AST_Node* node = NULL;
         AST_Node* tmpnode = NULL;
-        switch (parser->cur->type) {
+        switch (PCT(parser)) {
             case TOK_FN:
-                node = ast_init(STMT);
+                node = ast_init(&parser->arena, STMT);
                 node->data.stm.type = STMT_ATTR_UNIT;
                 node->data.stm.data.attribute_unit.type = ATTR_FUNCTION;
                 node->data.stm.data.attribute_unit.data.fn = parser_parse_function_decl(parser);
@@ -1049,15 +1846,16 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
 
                 if (extendedn > -1) {
                     for (size_t i = 0; i < extendedn; i++) {
-                        if (list->items[i]->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier == node->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier) {
-                            list->items[i]->data.stm.data.attribute_unit.data.fn = node->data.stm.data.attribute_unit.data.fn;
+                        AST_Node* unit = AST_VEC_ITEMS(*list)[i];
+
+                        if (AST_IDEN_EQ(unit->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier, node->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier)) {
+                            unit->data.stm.data.attribute_unit.data.fn = node->data.stm.data.attribute_unit.data.fn;
                             break;
                         }
                     }
                 }
 
-                list->items = realloc(list->items, (list->size + 1) * list->item_size);
-                list->items[list->size++] = node;
+                AST_VEC_PUSH(&parser->arena, *list, node);
 
                 
 
@@ -1065,9 +1863,9 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
             case TOK_VAR:
             case TOK_MUT:
             case TOK_CONST:
-                tmpnode = ast_init(STMT);
+                tmpnode = ast_init(&parser->arena, STMT);
                 tmpnode->data.stm.type = STMT_VARIABLE_DECL;
-                tmpnode->data.stm.data.variable_decl = parser_parse_var_decl(parser, 0);
+                tmpnode->data.stm.data.variable_decl = parser_parse_var_decl(parser);
 
                 if (!parser_expect(parser, TOK_SC)) {
                     REPORT_ERROR(parser->lexer, "E_SC");
@@ -1075,19 +1873,20 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
                 }
 
 
-                node = ast_init(STMT);
+                node = ast_init(&parser->arena, STMT);
                 node->data.stm.type = STMT_ATTR_UNIT;
                 node->data.stm.data.attribute_unit.type = ATTR_VARIABLE;
                 node->data.stm.data.attribute_unit.data.var = tmpnode;
                 node->data.stm.data.attribute_unit.scope = parser->scope;
 
-                list->items = realloc(list->items, (list->size + 1) * list->item_size);
-                list->items[list->size++] = node;
+                AST_VEC_PUSH(&parser->arena, *list, node);
 
                 break;
             case TOK_IDEN:
                 for (size_t i = 0; i < extendedn; i++) {
-                    if (list->items[i]->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.iden.sg == symtbl_hash(parser->cur->value, list->items[i]->data.stm.data.attribute_unit.scope)) {
+                    AST_Node* unit = AST_VEC_ITEMS(*list)[i];
+
+                    if (AST_IDEN_EQ(unit->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.iden.sg, ((ASTN_Iden){ PCA(parser), (uint32_t)unit->data.stm.data.attribute_unit.scope }))) {
                         parser_consume(parser);
 
                         if (!parser_expect(parser, TOK_EQ)) {
@@ -1095,7 +1894,7 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
                             return NULL;
                         }
 
-                        list->items[i]->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.expr = parser_parse_expr(parser, 0);
+                        unit->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.expr = parser_parse_expression(parser);
 
                         if (!parser_expect(parser, TOK_SC)) {
                             REPORT_ERROR(parser->lexer, "E_SC");
@@ -1109,18 +1908,17 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
 
                 break;
             default:
-                REPORT_ERROR(parser->lexer, "E_UNEXPECTED_TOKEN", parser->cur->value);
-                free(list->items);
-                free(list);
+                REPORT_ERROR(parser->lexer, "E_UNEXPECTED_TOKEN", PCV(parser));
                 return NULL;
         }
     }
 
+    PLS(parser);
     parser_consume(parser);
 
     attr.list = list;
 
-    AST_Node* node = ast_init(STMT);
+    AST_Node* node = ast_init(&parser->arena, STMT);
     node->data.stm.type = STMT_ATTR_DECL;
     node->data.stm.data.attribute_decl = attr;
 
@@ -1131,22 +1929,23 @@ AST_Node* parser_parse_attr_decl(Parser* parser) {
     return node;
 }
 
-ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
-    ASTN_VariableDecl var;
+ASTN_VariableDecl parser_parse_var_decl(Parser* parser) {
+    ASTN_VariableDecl var = {0};
     var.storage = -1;
+    var.expr = 0;
 
 
-    if (!(parser->cur->type == TOK_VAR || parser->cur->type == TOK_CONST || parser->cur->type == TOK_MUT)) {
+    if (!(PCT(parser) == TOK_VAR || PCT(parser) == TOK_CONST || PCT(parser) == TOK_MUT)) {
         REPORT_ERROR(parser->lexer, "E_ACCSPEC_VAR_DECL");
         return var;
     }
 
-    var.storage = parser->cur->type;
+    var.storage = PCT(parser);
     parser_consume(parser);
 
     bool has_dts = false, has_acc = false;
 
-    while (parser->cur->type != TOK_COLON && (!(has_dts && has_acc))) {
+    while (PCT(parser) != TOK_COLON && (!(has_dts && has_acc))) {
         if (!has_dts) {
             ASTN_DataTypeSpecifier dts = parser_parse_dt_spec(parser, false);
             if (dts.data.prim != 0) {
@@ -1156,8 +1955,8 @@ ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
             }
         }
         
-        if (!has_acc && (parser->cur->type == TOK_PUB || parser->cur->type == TOK_PRIV || parser->cur->type == TOK_GLOB)) {
-            var.access = parser->cur->type;
+        if (!has_acc && (PCT(parser) == TOK_PUB || PCT(parser) == TOK_PRIV || PCT(parser) == TOK_GLOB)) {
+            var.access = PCT(parser);
             has_acc = true;
             parser_consume(parser);
             continue;
@@ -1173,21 +1972,21 @@ ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
     }
 
 
-    int* identifiers = calloc(1, sizeof(int));
+    ASTN_Iden* identifiers = NULL;
     size_t size = 0;
 
-    while (parser->cur->type == TOK_IDEN) {
-        identifiers = realloc(identifiers, (size + 1) * sizeof(int));
+    while (PCT(parser) == TOK_IDEN) {
+        identifiers = arena_realloc(&parser->arena, identifiers, size * sizeof(ASTN_Iden), (size + 1) * sizeof(ASTN_Iden));
 
 
-        Symbol* symb = symbol_init((char*)parser->cur->value, SYMBOL_VARIABLE, parser->scope, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+        Symbol* symb = symbol_init(PCA(parser), SYMBOL_VARIABLE, parser->scope, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
         symtbl_insert(parser, symb);
 
         parser_consume(parser);
 
-        identifiers[size++] = symb->data.id;
+        identifiers[size++] = SYMBOL_IDEN(symb);
         
-        if (parser->cur->type == TOK_COMMA) {
+        if (PCT(parser) == TOK_COMMA) {
             parser_consume(parser);
         } else {
             break;
@@ -1196,7 +1995,6 @@ ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
 
     if (size == 0) {
         REPORT_ERROR(parser->lexer, "E_IDENTIFIER_VAR_DECL");
-        free(identifiers);
         var.storage = -1;
         return var;
     }
@@ -1204,19 +2002,18 @@ ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
     if (size == 1) {
         var.iden.mult.size = 0;
         var.iden.sg = identifiers[0];
-        free(identifiers);
     } else {
         var.iden.mult.items = identifiers;
         var.iden.mult.size = size;
     }
 
 
-    if (parser->cur->value == TOK_SC) {
+    if (PCT(parser) == TOK_SC) {
         return var;
     } 
 
 
-    if (parser->cur->type == TOK_EQ) {
+    if (PCT(parser) == TOK_EQ) {
         parser_consume(parser);
 
 
@@ -1226,9 +2023,9 @@ ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
             return var;
         }
         
-        var.expr = parser_parse_expr(parser, scopeOS);
+        var.expr = parser_parse_expression(parser);
     
-        if (var.expr->data.expr.type == -1) {
+        if (!var.expr) {
             var.storage = -1;
             return var;
         }
@@ -1239,31 +2036,80 @@ ASTN_VariableDecl parser_parse_var_decl(Parser* parser, uint8_t scopeOS) {
 
 
 
+static ASTN_Body* parser_skip_body(Parser* parser) {
+    /*
+    Skips the statements of a body by matching braces, from the token after its '{' up to the
+    '}' closing it (or the end of the stream), passing over the scope ids they may take
+    return: pointer to the skipped body, for parser_parse_body
+    */
+
+    TokenStream* tokens = parser->tokens;
+    ASTN_Body* body = arena_alloc(&parser->arena, sizeof(ASTN_Body));
+
+    body->start = parser->pos;
+    body->scope = parser->scope;
+    body->nest = parser->nest;
+    body->owner = parser->owner;
+
+    body->bound_size = symtbl_bound(parser->tbl, NULL);
+    body->bound = arena_alloc(&parser->arena, body->bound_size * sizeof(Symbol*));
+    symtbl_bound(parser->tbl, body->bound);
+
+    size_t i = parser->pos;
+
+    for (size_t depth = 0; tokens->type[i] != TOK_EOF; i++) {
+        if (tokens->type[i] == TOK_LBRACE) {
+            depth++;
+        } else if (tokens->type[i] == TOK_RBRACE) {
+            if (depth == 0) {
+                break;
+            }
+
+            depth--;
+        }
+    }
+
+    body->end = i;
+    parser->highest_scope += (ScopeId)parser_count_scopes(tokens, body->start, body->end);
+    parser_seek(parser, i);
+
+    return body;
+}
+
 AST_Node* parser_parse_function_decl(Parser* parser) {        
     if (!(parser_expect(parser, TOK_FN))) {
         return NULL;
     }
 
-    Token* name_tok = parser->cur;
-    if (name_tok->type != TOK_IDEN) {
-        REPORT_ERROR(parser->lexer, "E_FN_NAME", parser->cur->value);
+    size_t name_pos = parser->pos;
+    if (PCT(parser) != TOK_IDEN) {
+        REPORT_ERROR(parser->lexer, "E_FN_NAME", PCV(parser));
         return NULL;
     }
 
     parser_consume(parser);
 
     if (!(parser_expect(parser, TOK_FN_ARROW))) {
-        REPORT_ERROR(parser->lexer, "E_FN_ARROW", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_FN_ARROW", PCV(parser));
         return NULL;
     }
 
-    Symbol* symb = symbol_init((char*)name_tok->value, SYMBOL_FUNCTION, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+    // top-level functions are declared up front by parser_parse (but only seen by the
+    // declarations after them); others, e.g. of an attr or a class, in the scope around them
+    Symbol* symb = parser->symb;
+    bool declared = symb != NULL;
+    parser->symb = NULL;
+    parser->hidden = symb;
+
+    if (!declared) {
+        symb = symbol_init(parser_atom(parser, name_pos), SYMBOL_FUNCTION, parser->scope, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
+    }
 
 
-    PES(parser);
+    PES(parser, SCOPE_FUNCTION);
     PRN(parser);
 
-    AST_Node* node = ast_init(STMT);
+    AST_Node* node = ast_init(&parser->arena, STMT);
     node->data.stm.type = STMT_FUNCTION_DECL;
     node->data.stm.data.function_decl.parameters = parser_parse_parameters(parser);
     if (node->data.stm.data.function_decl.parameters == NULL) {
@@ -1271,35 +2117,45 @@ AST_Node* parser_parse_function_decl(Parser* parser) {
     }
 
 
-    if (parser->cur->type == TOK_SC) {
+    if (PCT(parser) == TOK_SC) {
+        PLS(parser);
         parser_consume(parser);
         node->data.stm.data.function_decl.statements = NULL;
         
-        node->data.stm.data.function_decl.identifier = symb->data.id;
+        node->data.stm.data.function_decl.identifier = SYMBOL_IDEN(symb);
         symb->data.data = node;
 
-        symtbl_insert(parser, symb);
+        if (!declared) {
+            symtbl_insert(parser, symb);
+        }
         
         return node;
     }
 
     parser_expect(parser, TOK_LBRACE);
 
-
-    node->data.stm.data.function_decl.statements = parser_parse_statements(parser, 0);
-    if (node->data.stm.data.function_decl.statements == NULL) {
-        return NULL;
+    if (parser->lazy) {
+        node->data.stm.data.function_decl.body = parser_skip_body(parser);
+    } else {
+        node->data.stm.data.function_decl.statements = parser_parse_statements(parser);
+        if (node->data.stm.data.function_decl.statements == NULL) {
+            return NULL;
+        }
     }
 
+    PLS(parser);
+
     if (!parser_expect(parser, TOK_RBRACE)) {
         REPORT_ERROR(parser->lexer, "E_RBRACE");
         return NULL;
     }
 
-    node->data.stm.data.function_decl.identifier = symb->data.id;
+    node->data.stm.data.function_decl.identifier = SYMBOL_IDEN(symb);
     symb->data.data = node;
     
-    symtbl_insert(parser, symb);
+    if (!declared) {
+        symtbl_insert(parser, symb);
+    }
 
 
     return node;
@@ -1310,12 +2166,12 @@ ASTN_StructMemberDecl parser_parse_struct_mem(Parser* parser) {
     stm.storage = -1;
 
 
-    if (!(parser->cur->type == TOK_VAR || parser->cur->type == TOK_CONST || parser->cur->type == TOK_MUT)) {
+    if (!(PCT(parser) == TOK_VAR || PCT(parser) == TOK_CONST || PCT(parser) == TOK_MUT)) {
         REPORT_ERROR(parser->lexer, "E_ACCSPEC_VAR_DECL");
         return stm;
     }
 
-    stm.storage = parser->cur->type;
+    stm.storage = PCT(parser);
     parser_consume(parser);
 
     ASTN_DataTypeSpecifier dts = parser_parse_dt_spec(parser, false);
@@ -1329,17 +2185,17 @@ ASTN_StructMemberDecl parser_parse_struct_mem(Parser* parser) {
         return stm;
     }
 
-    if (parser->cur->type != TOK_IDEN) {
+    if (PCT(parser) != TOK_IDEN) {
         REPORT_ERROR(parser->lexer, "E_IDEN_DECL");
         stm.storage = -1;
         return stm;
     }
 
-    Symbol* symb = symbol_init(parser->cur->value, SYMBOL_VARIABLE, parser->scope, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+    Symbol* symb = symbol_init(PCA(parser), SYMBOL_VARIABLE, parser->scope, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
     symtbl_insert(parser, symb);
     parser_consume(parser);
     
-    stm.identifier = symb->data.id;
+    stm.identifier = SYMBOL_IDEN(symb);
 
     if (!parser_expect(parser, TOK_SC)) {
         REPORT_ERROR(parser->lexer, "E_SC");
@@ -1351,22 +2207,22 @@ ASTN_StructMemberDecl parser_parse_struct_mem(Parser* parser) {
 }
 
 AST_Node* parser_parse_struct_decl(Parser* parser) {
-    ASTN_StructDecl stm;
+    ASTN_StructDecl stm = {0};
 
     parser_consume(parser);
 
-    if (parser->cur->type != TOK_IDEN) {
+    if (PCT(parser) != TOK_IDEN) {
         REPORT_ERROR(parser->lexer, "E_IDEN_DECL");
         return NULL;
     }
 
-    AST_Node* node = ast_init(STMT);
+    AST_Node* node = ast_init(&parser->arena, STMT);
     node->data.stm.type = STMT_STRUCT_DECL;
 
-    Symbol* symb = symbol_init(parser->cur->value, SYMBOL_STRUCT, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+    Symbol* symb = symbol_init(PCA(parser), SYMBOL_STRUCT, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
     parser_consume(parser);
 
-    stm.identifier = symb->data.id;
+    stm.identifier = SYMBOL_IDEN(symb);
 
     if (parser_expect(parser, TOK_SC)) {
         node->data.stm.data.struct_decl = stm;
@@ -1381,18 +2237,13 @@ AST_Node* parser_parse_struct_decl(Parser* parser) {
         return NULL;
     }
 
-    stm.members.size = 0;
-    stm.members.item_size = sizeof(ASTN_StructMemberDecl);
-    stm.members.items = calloc(1, sizeof(ASTN_StructMemberDecl));
-
-    while (parser->cur->type != TOK_RBRACE) {
+    while (PCT(parser) != TOK_RBRACE) {
         ASTN_StructMemberDecl mem = parser_parse_struct_mem(parser);
         if (mem.storage == -1) {
             return NULL;
         }
 
-        stm.members.items = realloc(stm.members.items, (stm.members.size + 1) * stm.members.item_size);
-        stm.members.items[stm.members.size++] = mem;
+        AST_VEC_PUSH(&parser->arena, stm.members, mem);
     }
 
     parser_consume(parser);
@@ -1409,22 +2260,22 @@ AST_Node* parser_parse_struct_decl(Parser* parser) {
 
 
 bool parser_parse_extend_attr(Parser* parser, ASTN_AttributeList* list) {
-    while (parser->cur->type != TOK_FN_ARROW && parser->cur->type != TOK_SC) {
+    while (PCT(parser) != TOK_FN_ARROW && PCT(parser) != TOK_SC) {
         char* iden = "\0";
         bool is_class = false;
-        __uint128_t scope;
+        ScopeId scope;
         Symbol* symb;
 
-        if (parser->cur->type != TOK_ATTR && parser->cur->type != TOK_IDEN) {
-            REPORT_ERROR(parser->lexer, "E_ATTRS_AF_EXT", parser->cur->value);
+        if (PCT(parser) != TOK_ATTR && PCT(parser) != TOK_IDEN) {
+            REPORT_ERROR(parser->lexer, "E_ATTRS_AF_EXT", PCV(parser));
             return false;
         }
 
-        if (parser->cur->type == TOK_IDEN) {
-            symb = symtbl_lookup(parser->tbl, parser->cur->value, 0, 0);
+        if (PCT(parser) == TOK_IDEN) {
+            symb = parser_find(parser, PCA(parser));
 
             if (!symb) {
-                REPORT_ERROR(parser->lexer, "E_VALID_ATTR", parser->cur->value);
+                REPORT_ERROR(parser->lexer, "E_VALID_ATTR", PCV(parser));
                 return false;
             }
 
@@ -1432,18 +2283,18 @@ bool parser_parse_extend_attr(Parser* parser, ASTN_AttributeList* list) {
                 scope = symb->data.scope + 1;
                 is_class = true;
             } else if (symb->data.type != SYMBOL_ATTR) {
-                REPORT_ERROR(parser->lexer, "E_VALID_ATTR", parser->cur->value);
+                REPORT_ERROR(parser->lexer, "E_VALID_ATTR", PCV(parser));
                 return false;
             }
         }
 
-        if (parser->cur->type != TOK_IDEN) {
+        if (PCT(parser) != TOK_IDEN) {
             parser_consume(parser);
             parser_consume(parser);
         }
 
         while (true) {
-            if (parser->cur->type == TOK_IDEN) {
+            if (PCT(parser) == TOK_IDEN) {
                 break;
             }
 
@@ -1456,42 +2307,38 @@ bool parser_parse_extend_attr(Parser* parser, ASTN_AttributeList* list) {
 
 
 
-        iden = parser->cur->value;
+        iden = PCV(parser);
 
-        symb = symtbl_lookup(parser->tbl, parser->cur->value, 0, 0);
+        symb = parser_find(parser, PCA(parser));
 
         parser_consume(parser);
 
         if (!symb) {
-            REPORT_ERROR(parser->lexer, "U_REF_UDEV", parser->cur->value);
+            REPORT_ERROR(parser->lexer, "U_REF_UDEV", PCV(parser));
             return false;
         }
 
 
         if (is_class) {
             for (size_t i = 0; i < symb->data.data->data.stm.data.class_decl.attributes->size; i++) {
-                list->items = realloc(list->items, (list->size + 1) * sizeof(AST_Node*));
-                AST_Node* itm = symb->data.data->data.stm.data.class_decl.attributes->items[i];
+                AST_Node* itm = AST_VEC_ITEMS(*symb->data.data->data.stm.data.class_decl.attributes)[i];
                 itm->data.stm.data.attribute_unit.re_scope = parser->scope;
-                list->items[list->size] = itm;
-                list->size++;
+                AST_VEC_PUSH(&parser->arena, *list, itm);
             }
         } else if (symb->data.type == SYMBOL_ATTR) {
             for (size_t i = 0; i < symb->data.data->data.stm.data.attribute_decl.list->size; i++) {
-                list->items = realloc(list->items, (list->size + 1) * sizeof(AST_Node*));
-                AST_Node* itm = symb->data.data->data.stm.data.attribute_decl.list->items[i];
+                AST_Node* itm = AST_VEC_ITEMS(*symb->data.data->data.stm.data.attribute_decl.list)[i];
                 itm->data.stm.data.attribute_unit.re_scope = parser->scope;
-                list->items[list->size] = itm;
-                list->size++;
+                AST_VEC_PUSH(&parser->arena, *list, itm);
             }
         }
 
         if (parser_expect(parser, TOK_COMMA)) {
             continue;
-        } else if (parser->cur->type == TOK_FN_ARROW || parser->cur->type == TOK_SC) {
+        } else if (PCT(parser) == TOK_FN_ARROW || PCT(parser) == TOK_SC) {
             break;
         } else {
-            REPORT_ERROR(parser->lexer, "E_UNEXPECTED_TOKEN", parser->cur->value);
+            REPORT_ERROR(parser->lexer, "E_UNEXPECTED_TOKEN", PCV(parser));
             return false;
         }
     }
@@ -1501,27 +2348,24 @@ bool parser_parse_extend_attr(Parser* parser, ASTN_AttributeList* list) {
 
 
 AST_Node* parser_parse_class_decl(Parser* parser) {
-    ASTN_ClassDecl stm;
+    ASTN_ClassDecl stm = {0};
     stm.attributes = NULL;
 
     parser_consume(parser);    
 
-    if (parser->cur->type != TOK_IDEN) {
-        REPORT_ERROR(parser->lexer, "E_CLASS_NAME", parser->cur->value);
+    if (PCT(parser) != TOK_IDEN) {
+        REPORT_ERROR(parser->lexer, "E_CLASS_NAME", PCV(parser));
         return NULL;
     }
 
-    char* iden = parser->cur->value;
+    uint32_t iden = PCA(parser);
 
     parser_consume(parser);
 
-    PES(parser);
+    PES(parser, SCOPE_CLASS);
 
     if (parser_expect(parser, TOK_EXT)) {
-        ASTN_AttributeList* ext_list = calloc(1, sizeof(ASTN_AttributeList));
-        ext_list->size = 0;
-        ext_list->item_size = sizeof(AST_Node*);
-        ext_list->items = calloc(1, sizeof(AST_Node*));
+        ASTN_AttributeList* ext_list = arena_calloc(&parser->arena, 1, sizeof(ASTN_AttributeList));
 
 
 
@@ -1532,16 +2376,17 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
         stm.attributes = ext_list;
     }
 
-    Symbol* symb = symbol_init(iden, SYMBOL_CLASS, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
-    stm.identifier = symb->data.id;
+    Symbol* symb = symbol_init(iden, SYMBOL_CLASS, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
+    stm.identifier = SYMBOL_IDEN(symb);
 
-    AST_Node* node = ast_init(STMT);
+    AST_Node* node = ast_init(&parser->arena, STMT);
     node->data.stm.type = STMT_CLASS_DECL;
 
-    if (parser->cur->type == TOK_SC) {
+    if (PCT(parser) == TOK_SC) {
         node->data.stm.data.class_decl = stm;
         symb->data.data = node;
 
+        PLS(parser);
         symtbl_insert(parser, symb);
         parser_consume(parser);
 
@@ -1562,23 +2407,19 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
 
     ASTN_AttributeList* list;
     if (stm.attributes == NULL) {
-        list = calloc(1, sizeof(ASTN_AttributeList));
-        list->size = 0;
-        list->item_size = sizeof(AST_Node*);
-        list->items = calloc(1, list->item_size);
+        list = arena_calloc(&parser->arena, 1, sizeof(ASTN_AttributeList));
         stm.attributes = list;
     } else {
         extendedn = stm.attributes->size;
         list = stm.attributes;
-        list->items = realloc(list->items, (list->size + 1) * list->item_size);
     }
 
-    while (parser->cur->type != TOK_RBRACE) {
+    while (PCT(parser) != TOK_RBRACE) {
         AST_Node* node = NULL;
         AST_Node* tmpnode = NULL;
-        switch (parser->cur->type) {
+        switch (PCT(parser)) {
             case TOK_FN:
-                node = ast_init(STMT);
+                node = ast_init(&parser->arena, STMT);
                 node->data.stm.type = STMT_ATTR_UNIT;
                 node->data.stm.data.attribute_unit.type = ATTR_FUNCTION;
                 node->data.stm.data.attribute_unit.data.fn = parser_parse_function_decl(parser);
@@ -1586,15 +2427,16 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
 
                 if (extendedn > -1) {
                     for (size_t i = 0; i < extendedn; i++) {
-                        if (list->items[i]->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier == node->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier) {
-                            list->items[i]->data.stm.data.attribute_unit.data.fn = node->data.stm.data.attribute_unit.data.fn;
+                        AST_Node* unit = AST_VEC_ITEMS(*list)[i];
+
+                        if (AST_IDEN_EQ(unit->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier, node->data.stm.data.attribute_unit.data.fn->data.stm.data.function_decl.identifier)) {
+                            unit->data.stm.data.attribute_unit.data.fn = node->data.stm.data.attribute_unit.data.fn;
                             break;
                         }
                     }
                 }
 
-                list->items = realloc(list->items, (list->size + 1) * list->item_size);
-                list->items[list->size++] = node;
+                AST_VEC_PUSH(&parser->arena, *list, node);
 
                 
 
@@ -1602,28 +2444,29 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
             case TOK_VAR:
             case TOK_MUT:
             case TOK_CONST:
-                tmpnode = ast_init(STMT);
+                tmpnode = ast_init(&parser->arena, STMT);
                 tmpnode->data.stm.type = STMT_VARIABLE_DECL;
-                tmpnode->data.stm.data.variable_decl = parser_parse_var_decl(parser, 0);
+                tmpnode->data.stm.data.variable_decl = parser_parse_var_decl(parser);
                 
                 if (!parser_expect(parser, TOK_SC)) {
                     REPORT_ERROR(parser->lexer, "E_SC");
                     return NULL;
                 }
 
-                node = ast_init(STMT);
+                node = ast_init(&parser->arena, STMT);
                 node->data.stm.type = STMT_ATTR_UNIT;
                 node->data.stm.data.attribute_unit.type = ATTR_VARIABLE;
                 node->data.stm.data.attribute_unit.data.var = tmpnode;
                 node->data.stm.data.attribute_unit.scope = parser->scope;
 
-                list->items = realloc(list->items, (list->size + 1) * list->item_size);
-                list->items[list->size++] = node;
+                AST_VEC_PUSH(&parser->arena, *list, node);
 
                 break;
             case TOK_IDEN:
                 for (size_t i = 0; i < extendedn; i++) {
-                    if (list->items[i]->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.iden.sg == symtbl_hash(parser->cur->value, list->items[i]->data.stm.data.attribute_unit.scope)) {
+                    AST_Node* unit = AST_VEC_ITEMS(*list)[i];
+
+                    if (AST_IDEN_EQ(unit->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.iden.sg, ((ASTN_Iden){ PCA(parser), (uint32_t)unit->data.stm.data.attribute_unit.scope }))) {
                         parser_consume(parser);
 
                         if (!parser_expect(parser, TOK_EQ)) {
@@ -1631,7 +2474,7 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
                             return NULL;
                         }
 
-                        list->items[i]->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.expr = parser_parse_expr(parser, 0);
+                        unit->data.stm.data.attribute_unit.data.var->data.stm.data.variable_decl.expr = parser_parse_expression(parser);
 
                         if (!parser_expect(parser, TOK_SC)) {
                             REPORT_ERROR(parser->lexer, "E_SC");
@@ -1645,14 +2488,13 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
 
                 break;
             default:
-                REPORT_ERROR(parser->lexer, "E_UNEXPECTED_TOKEN", parser->cur->value);
-                free(list->items);
-                free(list);
+                REPORT_ERROR(parser->lexer, "E_UNEXPECTED_TOKEN", PCV(parser));
                 return NULL;
         }
     }
 
 
+    PLS(parser);
     parser_consume(parser);
 
     stm.attributes = list;
@@ -1665,22 +2507,22 @@ AST_Node* parser_parse_class_decl(Parser* parser) {
 }
 
 AST_Node* parser_parse_err_decl(Parser* parser) {
-    ASTN_ErrDecl stm;
+    ASTN_ErrDecl stm = {0};
 
     parser_consume(parser);
 
-    if (parser->cur->type != TOK_IDEN) {
+    if (PCT(parser) != TOK_IDEN) {
         REPORT_ERROR(parser->lexer, "E_IDEN_DECL");
         return NULL;
     }
 
-    AST_Node* node = ast_init(STMT);
+    AST_Node* node = ast_init(&parser->arena, STMT);
     node->data.stm.type = STMT_ERR_DECL;
 
-    Symbol* symb = symbol_init(parser->cur->value, SYMBOL_ERR, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+    Symbol* symb = symbol_init(PCA(parser), SYMBOL_ERR, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
     parser_consume(parser);
 
-    stm.identifier = symb->data.id;
+    stm.identifier = SYMBOL_IDEN(symb);
 
     if (parser_expect(parser, TOK_SC)) {
         node->data.stm.data.err_decl = stm;
@@ -1695,13 +2537,9 @@ AST_Node* parser_parse_err_decl(Parser* parser) {
         return NULL;
     }
 
-    PES(parser);
+    PES(parser, SCOPE_ERR);
 
-    stm.members.size = 0;
-    stm.members.dtss = calloc(1, sizeof(ASTN_DataTypeSpecifier));
-    stm.members.identifiers = calloc(1, sizeof(uint32_t));
-
-    while (parser->cur->type != TOK_RBRACE) {
+    while (PCT(parser) != TOK_RBRACE) {
         ASTN_DataTypeSpecifier dts = parser_parse_dt_spec(parser, false);
         
         if (!parser_expect(parser, TOK_COLON)) {
@@ -1709,29 +2547,25 @@ AST_Node* parser_parse_err_decl(Parser* parser) {
             return NULL;
         }
 
-        if (parser->cur->type != TOK_IDEN) {
+        if (PCT(parser) != TOK_IDEN) {
             REPORT_ERROR(parser->lexer, "E_IDEN_DECL");
             return NULL;
         }
 
-        Symbol* symb = symbol_init(parser->cur->value, SYMBOL_VARIABLE, parser->scope, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+        Symbol* symb = symbol_init(PCA(parser), SYMBOL_VARIABLE, parser->scope, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
         symtbl_insert(parser, symb);
 
         parser_consume(parser);
 
-        stm.members.identifiers = realloc(stm.members.identifiers, (stm.members.size + 1) * sizeof(uint8_t));
-        stm.members.identifiers[stm.members.size] = symb->data.id; 
-
-        stm.members.dtss = realloc(stm.members.dtss, (stm.members.size + 1) * sizeof(ASTN_DataTypeSpecifier));
-        stm.members.dtss[stm.members.size] = dts;
-
-        stm.members.size++;
+        ASTN_ErrMember member = { .dts = dts, .identifier = SYMBOL_IDEN(symb) };
+        AST_VEC_PUSH(&parser->arena, stm.members, member);
 
         if (!parser_expect(parser, TOK_COMMA)) {
             break;
         }
     }
 
+    PLS(parser);
     parser_consume(parser);
     node->data.stm.data.err_decl = stm;
     symb->data.data = node;
@@ -1743,45 +2577,43 @@ AST_Node* parser_parse_err_decl(Parser* parser) {
 
 
 AST_Node* parser_parse_enum_decl(Parser* parser) {
-    ASTN_EnumDecl stm;
+    ASTN_EnumDecl stm = {0};
     parser_consume(parser);
 
-    if (parser->cur->type != TOK_IDEN) {
+    if (PCT(parser) != TOK_IDEN) {
         REPORT_ERROR(parser->lexer, "E_IDEN_DECL");
         return NULL;
     }
 
-    AST_Node* node = ast_init(STMT);
+    AST_Node* node = ast_init(&parser->arena, STMT);
     node->data.stm.type = STMT_ENUM_DECL;
 
-    Symbol* symb = symbol_init(parser->cur->value, SYMBOL_ENUM, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
+    Symbol* symb = symbol_init(PCA(parser), SYMBOL_ENUM, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
     parser_consume(parser);
 
-    stm.identifier = symb->data.id;
+    stm.identifier = SYMBOL_IDEN(symb);
 
     if (!parser_expect(parser, TOK_LBRACE)) {
         REPORT_ERROR(parser->lexer, "E_LBRACE");
         return NULL;
     }
     
-    stm.members.size = 0;
-    stm.members.items = calloc(1, sizeof(uint32_t));
-
-    while (parser->cur->type != TOK_RBRACE) {
-        stm.members.items = realloc(stm.members.items, (stm.members.size + 1) * sizeof(uint32_t));
+    while (PCT(parser) != TOK_RBRACE) {
+        ASTN_Iden member = { 0, 0 };
 
-        if (parser->cur->type == TOK_IDEN) {
-            Symbol* symb2 = symbol_init(parser->cur->value, SYMBOL_VARIABLE, 0, 0, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc);
-            stm.members.items[stm.members.size] = symb2->data.id;
+        if (PCT(parser) == TOK_IDEN) {
+            Symbol* symb2 = symbol_init(PCA(parser), SYMBOL_VARIABLE, 0, 0, 0, 0, 0, 0, PCL(parser), PCC(parser));
+            member = SYMBOL_IDEN(symb2);
             symtbl_insert(parser, symb2);
             parser_consume(parser);
         }
         
-        if (!(parser_expect(parser, TOK_COMMA)) && (parser->cur->type != TOK_RBRACE)) {
-            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", parser->cur->value);
+        if (!(parser_expect(parser, TOK_COMMA)) && (PCT(parser) != TOK_RBRACE)) {
+            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", PCV(parser));
             return NULL;
         }
-        stm.members.size++;     
+
+        AST_VEC_PUSH(&parser->arena, stm.members, member);
     }
 
     parser_consume(parser);
@@ -1795,18 +2627,16 @@ AST_Node* parser_parse_enum_decl(Parser* parser) {
 }
 
 
-ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
-    ASTN_ConditionalStm stm;
+ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser) {
+    ASTN_ConditionalStm stm = {0};
     parser_consume(parser);
 
-    __uint128_t temp = parser->scope;
-
     if (!parser_expect(parser, TOK_LPAREN)) {
         REPORT_ERROR(parser->lexer, "E_LPAREN");
         return stm;
     }
 
-    stm.if_condition = parser_parse_expr(parser, scopeOS);
+    stm.if_condition = parser_parse_expression(parser);
 
     if (!parser_expect(parser, TOK_RPAREN)) {
         REPORT_ERROR(parser->lexer, "E_RPAREN");
@@ -1818,27 +2648,29 @@ ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
         return stm;
     }
 
-    PES(parser);
-    scopeOS += 1;
+    PES(parser, SCOPE_BRANCH);
 
-    stm.if_statements = parser_parse_statements(parser, scopeOS);
+    stm.if_statements = parser_parse_statements(parser);
+
+    PLS(parser);
 
     if (!parser_expect(parser, TOK_RBRACE)) {
         REPORT_ERROR(parser->lexer, "E_RBRACE");
         return stm;
     }
 
-    if (parser->cur->type == TOK_ELSE) {
+    if (PCT(parser) == TOK_ELSE) {
         parser_consume(parser);
         if (!parser_expect(parser, TOK_LBRACE)) {
             REPORT_ERROR(parser->lexer, "E_LBRACE");
             return stm;
         }
 
-        PES(parser);
-        scopeOS += 1;
+        PES(parser, SCOPE_BRANCH);
+
+        stm.else_statements = parser_parse_statements(parser);
 
-        stm.else_statements = parser_parse_statements(parser, scopeOS);
+        PLS(parser);
 
         if (!parser_expect(parser, TOK_RBRACE)) {
             REPORT_ERROR(parser->lexer, "E_RBRACE");
@@ -1846,12 +2678,9 @@ ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
         }
     }
 
-    stm.elif_branches.conditions = calloc(1, sizeof(AST_Node));
-    stm.elif_branches.statements = calloc(1, sizeof(ASTN_Statements));
-    stm.elif_branches.size = 0;
 
 
-    while (parser->cur->type == TOK_ELIF) {
+    while (PCT(parser) == TOK_ELIF) {
         parser_consume(parser);
         
         if (!parser_expect(parser, TOK_LPAREN)) {
@@ -1859,7 +2688,7 @@ ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
             return stm;
         }
 
-        AST_Node* elif_condition = parser_parse_expr(parser, scopeOS);
+        ASTN_ExprRef elif_condition = parser_parse_expression(parser);
 
 
         if (!parser_expect(parser, TOK_RPAREN)) {
@@ -1872,26 +2701,23 @@ ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
             return stm;
         }
         
-        PES(parser);
-        scopeOS += 1;
+        PES(parser, SCOPE_BRANCH);
 
-        ASTN_Statements* elif_statements = parser_parse_statements(parser, scopeOS);
+        ASTN_Statements* elif_statements = parser_parse_statements(parser);
+
+        PLS(parser);
 
         if (!parser_expect(parser, TOK_RBRACE)) {
             REPORT_ERROR(parser->lexer, "E_RBRACE");
             return stm;
         }
 
-        stm.elif_branches.conditions = realloc(stm.elif_branches.conditions, (stm.elif_branches.size + 1) * sizeof(AST_Node*));
-        stm.elif_branches.statements = realloc(stm.elif_branches.statements, (stm.elif_branches.size + 1) * sizeof(ASTN_Statements*));
-        
-        stm.elif_branches.conditions[stm.elif_branches.size] = elif_condition;
-        stm.elif_branches.statements[stm.elif_branches.size] = elif_statements;
-        stm.elif_branches.size++;
+        ASTN_ElifBranch branch = { .condition = elif_condition, .statements = elif_statements };
+        AST_VEC_PUSH(&parser->arena, stm.elif_branches, branch);
     }
 
 
-    if (parser->cur->type == TOK_ELSE) {
+    if (PCT(parser) == TOK_ELSE) {
         parser_consume(parser);
 
         if (!parser_expect(parser, TOK_LBRACE)) {
@@ -1899,10 +2725,11 @@ ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
             return stm;
         }
 
-        PES(parser);
-        scopeOS += 1;
+        PES(parser, SCOPE_BRANCH);
 
-        stm.else_statements = parser_parse_statements(parser, scopeOS);
+        stm.else_statements = parser_parse_statements(parser);
+
+        PLS(parser);
 
         if (!parser_expect(parser, TOK_RBRACE)) {
             REPORT_ERROR(parser->lexer, "E_RBRACE");
@@ -1911,13 +2738,11 @@ ASTN_ConditionalStm parser_parse_cond_stm(Parser* parser, uint8_t scopeOS) {
 
     }
 
-    parser->scope = temp;
-
     return stm;
 }
 
-ASTN_ForStm parser_parse_for_stm(Parser* parser, uint8_t scopeOS) {
-    ASTN_ForStm stm;
+ASTN_ForStm parser_parse_for_stm(Parser* parser) {
+    ASTN_ForStm stm = {0};
     parser_consume(parser);
 
     if (!parser_expect(parser, TOK_LPAREN)) {
@@ -1925,21 +2750,21 @@ ASTN_ForStm parser_parse_for_stm(Parser* parser, uint8_t scopeOS) {
         return stm;
     }
 
-    stm.var_decl = parser_parse_var_decl(parser, scopeOS);
+    stm.var_decl = parser_parse_var_decl(parser);
 
     if (!parser_expect(parser, TOK_SC)) {
         REPORT_ERROR(parser->lexer, "E_SC");
         return stm;
     }
 
-    stm.condition_expr = parser_parse_expr(parser, scopeOS);
+    stm.condition_expr = parser_parse_expression(parser);
 
     if (!parser_expect(parser, TOK_SC)) {
         REPORT_ERROR(parser->lexer, "E_SC");
         return stm;
     }
 
-    stm.next_expr = parser_parse_expr(parser, scopeOS);
+    stm.next_expr = parser_parse_expression(parser);
 
     if (!parser_expect(parser, TOK_RPAREN)) {
         REPORT_ERROR(parser->lexer, "E_RPAREN");
@@ -1951,10 +2776,11 @@ ASTN_ForStm parser_parse_for_stm(Parser* parser, uint8_t scopeOS) {
         return stm;
     }
 
-    PES(parser);
-    scopeOS += 1;
+    PES(parser, SCOPE_LOOP);
 
-    stm.statements = parser_parse_statements(parser, scopeOS);
+    stm.statements = parser_parse_statements(parser);
+
+    PLS(parser);
 
     if (!parser_expect(parser, TOK_RBRACE)) {
         REPORT_ERROR(parser->lexer, "E_RBRACE");
@@ -1964,20 +2790,33 @@ ASTN_ForStm parser_parse_for_stm(Parser* parser, uint8_t scopeOS) {
     return stm;
 }
 
-ASTN_SwitchStm parser_parse_switch_stm(Parser* parser, uint8_t scopeOS) {
-    ASTN_SwitchStm stm;
-    parser_consume(parser);
+static bool parser_is_switchable(Parser* parser, ASTN_ExprRef expr) {
+    /*
+    Checks whether provided expression may be switched on or used as a case value
+    return: true for identifiers, literals and calls
+    */
+
+    if (!expr) {
+        return false;
+    }
 
-    __uint128_t temp = parser->scope;
+    uint8_t type = AST_EXPR(&parser->exprs, expr)->type;
+
+    return type == EXPR_IDENTIFIER || type == EXPR_LITERAL || type == EXPR_FUNCTION_CALL;
+}
+
+ASTN_SwitchStm parser_parse_switch_stm(Parser* parser) {
+    ASTN_SwitchStm stm = {0};
+    parser_consume(parser);
 
     if (!parser_expect(parser, TOK_LPAREN)) {
         REPORT_ERROR(parser->lexer, "E_LPAREN");
         return stm;
     }
 
-    AST_Node* expr = parser_parse_expr(parser, scopeOS);
+    ASTN_ExprRef expr = parser_parse_expression(parser);
 
-    if (expr->data.expr.type != EXPR_IDENTIFIER && expr->data.expr.type != EXPR_LITERAL && expr->data.expr.type != EXPR_FUNCTION_CALL) {
+    if (!parser_is_switchable(parser, expr)) {
         REPORT_ERROR(parser->lexer, "E_SWABLSTM");
         return stm;
     }
@@ -1994,22 +2833,18 @@ ASTN_SwitchStm parser_parse_switch_stm(Parser* parser, uint8_t scopeOS) {
         return stm;
     }
 
-    PES(parser);
-    scopeOS += 1;
+    PES(parser, SCOPE_SWITCH);
 
-    stm.clauses.value = calloc(1, sizeof(AST_Node*));
-    stm.clauses.statements = calloc(1, sizeof(ASTN_Statements*));
-    stm.clauses.size = 0;
 
     bool default_case_found = false;
 
-    while (parser->cur->type != TOK_RBRACE) {
-        if (parser->cur->type == TOK_CASE) {
+    while (PCT(parser) != TOK_RBRACE) {
+        if (PCT(parser) == TOK_CASE) {
             parser_consume(parser);
 
-            AST_Node* expr = parser_parse_expr(parser, scopeOS);
+            ASTN_ExprRef expr = parser_parse_expression(parser);
 
-            if (expr->data.expr.type != EXPR_IDENTIFIER && expr->data.expr.type != EXPR_LITERAL && expr->data.expr.type != EXPR_FUNCTION_CALL) {
+            if (!parser_is_switchable(parser, expr)) {
                 REPORT_ERROR(parser->lexer, "E_SWABLSTM");
                 return stm;
             }
@@ -2019,15 +2854,11 @@ ASTN_SwitchStm parser_parse_switch_stm(Parser* parser, uint8_t scopeOS) {
                 return stm;
             }
             
-            ASTN_Statements* stms = parser_parse_statements(parser, scopeOS);
+            ASTN_Statements* stms = parser_parse_statements(parser);
 
-            stm.clauses.statements = realloc(stm.clauses.statements, (stm.clauses.size + 1) * sizeof(ASTN_Statements*));
-            stm.clauses.value = realloc(stm.clauses.value, (stm.clauses.size + 1) * sizeof(AST_Node*));
-            stm.clauses.value[stm.clauses.size] = expr;
-            stm.clauses.statements[stm.clauses.size] = stms;
-
-            stm.clauses.size++;
-        } else if (parser->cur->type == TOK_DEFAULT) {
+            ASTN_SwitchClause clause = { .value = expr, .statements = stms };
+            AST_VEC_PUSH(&parser->arena, stm.clauses, clause);
+        } else if (PCT(parser) == TOK_DEFAULT) {
             if (default_case_found) {
                 REPORT_ERROR(parser->lexer, "E_MULTIPLE_DEFAULT");
                 return stm;
@@ -2041,13 +2872,13 @@ ASTN_SwitchStm parser_parse_switch_stm(Parser* parser, uint8_t scopeOS) {
                 return stm;
             }
 
-            ASTN_Statements* stms = parser_parse_statements(parser, scopeOS);
+            ASTN_Statements* stms = parser_parse_statements(parser);
 
             stm.default_stms = stms;
         }
     }
 
-    parser->scope = temp;
+    PLS(parser);
     parser_consume(parser);
 
     return stm;
@@ -2055,38 +2886,38 @@ ASTN_SwitchStm parser_parse_switch_stm(Parser* parser, uint8_t scopeOS) {
 
 
 
-ASTN_TryStm parser_parse_try_stm(Parser* parser, uint8_t scopeOS) {
-    ASTN_TryStm stm;
+ASTN_TryStm parser_parse_try_stm(Parser* parser) {
+    ASTN_TryStm stm = {0};
     parser_consume(parser);
 
-    __uint128_t temp = parser->scope;
-
     if (!parser_expect(parser, TOK_LBRACE)) {
         REPORT_ERROR(parser->lexer, "E_LBRACE");
         return stm;
     }
 
-    PES(parser);
-    scopeOS += 1;
+    PES(parser, SCOPE_TRY);
 
-    stm.try_statements = parser_parse_statements(parser, scopeOS);
+    stm.try_statements = parser_parse_statements(parser);
+
+    PLS(parser);
 
     if (!parser_expect(parser, TOK_RBRACE)) {
         REPORT_ERROR(parser->lexer, "E_RBRACE");
         return stm;
     }
 
-    if (parser->cur->type == TOK_FINALLY) {
+    if (PCT(parser) == TOK_FINALLY) {
         parser_consume(parser);
         if (!parser_expect(parser, TOK_LBRACE)) {
             REPORT_ERROR(parser->lexer, "E_LBRACE");
             return stm;
         }
 
-        PES(parser);
-        scopeOS += 1;
+        PES(parser, SCOPE_TRY);
+
+        stm.finally_statements = parser_parse_statements(parser);
 
-        stm.finally_statements = parser_parse_statements(parser, scopeOS);
+        PLS(parser);
 
         if (!parser_expect(parser, TOK_RBRACE)) {
             REPORT_ERROR(parser->lexer, "E_RBRACE");
@@ -2094,20 +2925,17 @@ ASTN_TryStm parser_parse_try_stm(Parser* parser, uint8_t scopeOS) {
         }
     }
 
-    stm.except_branches.errors = calloc(1, sizeof(uint32_t));
-    stm.except_branches.statements = calloc(1, sizeof(ASTN_Statements));
-    stm.except_branches.size = 0;
 
 
-    while (parser->cur->type == TOK_EXCEPT) {
+    while (PCT(parser) == TOK_EXCEPT) {
         parser_consume(parser);
         
-        if (parser->cur->type != TOK_IDEN) {
+        if (PCT(parser) != TOK_IDEN) {
             REPORT_ERROR(parser->lexer, "E_EXCPET_IDEN");
             return stm;
         }
 
-        Symbol* sym = symtbl_lookup(parser->tbl, parser->cur->value, 0, 0);
+        Symbol* sym = parser_find(parser, PCA(parser));
         if (!sym || sym->data.type != SYMBOL_ERR) {
             REPORT_ERROR(parser->lexer, "E_PROP_ERRTT");
             return stm;
@@ -2120,36 +2948,34 @@ ASTN_TryStm parser_parse_try_stm(Parser* parser, uint8_t scopeOS) {
             return stm;
         }
         
-        PES(parser);
-        scopeOS += 1;
+        PES(parser, SCOPE_TRY);
 
-        ASTN_Statements* stms = parser_parse_statements(parser, scopeOS);
+        ASTN_Statements* stms = parser_parse_statements(parser);
+
+        PLS(parser);
 
         if (!parser_expect(parser, TOK_RBRACE)) {
             REPORT_ERROR(parser->lexer, "E_RBRACE");
             return stm;
         }
 
-        stm.except_branches.errors = realloc(stm.except_branches.errors, (stm.except_branches.size + 1) * sizeof(uint32_t));
-        stm.except_branches.statements = realloc(stm.except_branches.statements, (stm.except_branches.size + 1) * sizeof(ASTN_Statements*));
-
-        stm.except_branches.errors[stm.except_branches.size] = sym->data.id;
-        stm.except_branches.statements[stm.except_branches.size] = stms;
-        stm.except_branches.size++;
+        ASTN_ExceptBranch branch = { .error = SYMBOL_IDEN(sym), .statements = stms };
+        AST_VEC_PUSH(&parser->arena, stm.except_branches, branch);
     }
 
 
-    if (parser->cur->type == TOK_FINALLY) {
+    if (PCT(parser) == TOK_FINALLY) {
         parser_consume(parser);
         if (!parser_expect(parser, TOK_LBRACE)) {
             REPORT_ERROR(parser->lexer, "E_LBRACE");
             return stm;
         }
 
-        PES(parser);
-        scopeOS += 1;
+        PES(parser, SCOPE_TRY);
 
-        stm.finally_statements = parser_parse_statements(parser, scopeOS);
+        stm.finally_statements = parser_parse_statements(parser);
+
+        PLS(parser);
 
         if (!parser_expect(parser, TOK_RBRACE)) {
             REPORT_ERROR(parser->lexer, "E_RBRACE");
@@ -2158,23 +2984,19 @@ ASTN_TryStm parser_parse_try_stm(Parser* parser, uint8_t scopeOS) {
     }
 
 
-    parser->scope = temp;
-
     return stm;
 }
 
-ASTN_WhileStm parser_parse_while_stm(Parser* parser, uint8_t scopeOS) {
-    ASTN_WhileStm stm;
+ASTN_WhileStm parser_parse_while_stm(Parser* parser) {
+    ASTN_WhileStm stm = {0};
     parser_consume(parser);
 
-    __uint128_t temp = parser->scope;
-
     if (!parser_expect(parser, TOK_LPAREN)) {
         REPORT_ERROR(parser->lexer, "E_LPAREN");
         return stm;
     }
 
-    stm.condition_expr = parser_parse_expr(parser, scopeOS);
+    stm.condition_expr = parser_parse_expression(parser);
 
     if (!parser_expect(parser, TOK_RPAREN)) {
         REPORT_ERROR(parser->lexer, "E_RPAREN");
@@ -2186,40 +3008,41 @@ ASTN_WhileStm parser_parse_while_stm(Parser* parser, uint8_t scopeOS) {
         return stm;
     }
 
-    PES(parser);
-    scopeOS += 1;
+    PES(parser, SCOPE_LOOP);
+
+    stm.statements = parser_parse_statements(parser);
 
-    stm.statements = parser_parse_statements(parser, scopeOS);
+    PLS(parser);
 
     if (!parser_expect(parser, TOK_RBRACE)) {
         REPORT_ERROR(parser->lexer, "E_RBRACE");
         return stm;
     }
 
-    parser->scope = temp;
-
     return stm;
 }
 
-ASTN_ReturnStm parser_parse_return_stm(Parser* parser, uint8_t scopeOS) {
+ASTN_ReturnStm parser_parse_return_stm(Parser* parser) {
     parser_consume(parser);
     ASTN_ReturnStm statement;
 
-    statement.expr = parser_parse_expr(parser, scopeOS);
+    statement.expr = parser_parse_expression(parser);
 
     return statement;    
 }
 
-ASTN_ThrowStm parser_parse_throw_stm(Parser* parser, uint8_t scopeOS) {
+ASTN_ThrowStm parser_parse_throw_stm(Parser* parser) {
     parser_consume(parser);
-    ASTN_ThrowStm statement;
+    ASTN_ThrowStm statement = {0};
+    statement.args = 0;
+    statement.size = 0;
 
-    if (parser->cur->type != TOK_IDEN) {
+    if (PCT(parser) != TOK_IDEN) {
         REPORT_ERROR(parser->lexer, "E_THROW_IDEN");
         return statement;
     }
 
-    Symbol* sym = symtbl_lookup(parser->tbl, parser->cur->value, 0, 0);
+    Symbol* sym = parser_find(parser, PCA(parser));
     if (!sym || sym->data.type != SYMBOL_ERR) {
         REPORT_ERROR(parser->lexer, "E_PROP_ERRTT");
         return statement;
@@ -2227,9 +3050,9 @@ ASTN_ThrowStm parser_parse_throw_stm(Parser* parser, uint8_t scopeOS) {
 
     parser_consume(parser);
     
-    statement.iden = sym->data.id;
+    statement.iden = SYMBOL_IDEN(sym);
 
-    if (parser->cur->type == TOK_SC) {
+    if (PCT(parser) == TOK_SC) {
         return statement;
     }
 
@@ -2239,79 +3062,74 @@ ASTN_ThrowStm parser_parse_throw_stm(Parser* parser, uint8_t scopeOS) {
     } 
 
 
-    ASTN_CallParams* params = calloc(1, sizeof(ASTN_CallParams));
-
-    params->size = 0;
-    params->item_size = sizeof(AST_Node*);
-    params->parameter = calloc(1, sizeof(AST_Node*));
+    ASTN_ExprPool* exprs = &parser->exprs;
+    size_t scratch = exprs->scratch_size;
 
+    while (PCT(parser) != TOK_RPAREN) {
+        ast_scratch_push(exprs, parser_parse_expression(parser));
 
-    while (parser->cur->type != TOK_RPAREN) {
-        params->parameter[params->size] = parser_parse_expr(parser, scopeOS);
-
-        if (!(parser_expect(parser, TOK_COMMA)) && (parser->cur->type != TOK_RPAREN)) {
-            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", parser->cur->value);
+        if (!(parser_expect(parser, TOK_COMMA)) && (PCT(parser) != TOK_RPAREN)) {
+            REPORT_ERROR(parser->lexer, "E_PARAMS_COMMA", PCV(parser));
+            exprs->scratch_size = scratch;
             return statement;
         }         
-
-        params->parameter = realloc(params->parameter, (params->size + 1) * sizeof(AST_Node));
-        params->size++;
     }
 
     parser_consume(parser);
 
-    statement.params = params;
+    statement.size = (uint32_t)(exprs->scratch_size - scratch);
+    statement.args = ast_scratch_pop(exprs, scratch);
 
     return statement;
 }
 
 
-ASTN_Statement parser_parse_statement(Parser* parser, uint8_t scopeOS) {
-    ASTN_Statement stm;
+ASTN_Statement parser_parse_statement(Parser* parser) {
+    ASTN_Statement stm = {0};
     stm.type = -1;
 
-    switch (parser->cur->type) {
+    switch (PCT(parser)) {
         case TOK_RETURN:
             stm.type = STMT_RETURN;
-            stm.data.return_stm = parser_parse_return_stm(parser, scopeOS);
+            stm.data.return_stm = parser_parse_return_stm(parser);
             break;
         case TOK_THROW:
             stm.type = STMT_THROW;
-            stm.data.throw_stm = parser_parse_throw_stm(parser, scopeOS);
+            stm.data.throw_stm = parser_parse_throw_stm(parser);
             break;
         case TOK_VAR:
         case TOK_CONST:
         case TOK_MUT:
             stm.type = STMT_VARIABLE_DECL;
-            stm.data.variable_decl = parser_parse_var_decl(parser, scopeOS);
+            stm.data.variable_decl = parser_parse_var_decl(parser);
             break;
         case TOK_IDEN:
             stm.type = STMT_CALL;
-            stm.data.call = parser_parse_call(parser, scopeOS);
-            if (stm.data.call.identifier != 0) { break; }
+            stm.data.call = parser_parse_call(parser);
+            if (stm.data.call.identifier.atom != 0) { break; }
             
             stm.type = STMT_EXPRESSION;
-            stm.data.expression = *parser_parse_expression(parser, scopeOS);
+            stm.data.expression = parser_parse_expression(parser);
             break;
         case TOK_IF:
             stm.type = STMT_CONDITIONAL;
-            stm.data.conditional = parser_parse_cond_stm(parser, scopeOS);
+            stm.data.conditional = parser_parse_cond_stm(parser);
             return stm; break;
         case TOK_WHILE:
             stm.type = STMT_WHILE_LOOP;
-            stm.data.while_loop = parser_parse_while_stm(parser, scopeOS);
+            stm.data.while_loop = parser_parse_while_stm(parser);
             return stm; break;
         case TOK_SWITCH:
             stm.type = STMT_SWITCH;
-            stm.data.switch_stm = parser_parse_switch_stm(parser, scopeOS);
+            stm.data.switch_stm = parser_parse_switch_stm(parser);
             return stm; break;
         case TOK_TRY:
             stm.type = STMT_TRY;
-            stm.data.try_stm = parser_parse_try_stm(parser, scopeOS);
+            stm.data.try_stm = parser_parse_try_stm(parser);
             return stm; break;
         case TOK_FOR:
             stm.type = STMT_FOR_LOOP;
-            stm.data.for_loop = parser_parse_for_stm(parser, scopeOS);
+            stm.data.for_loop = parser_parse_for_stm(parser);
             return stm; break;
         case TOK_BREAK:
             parser_consume(parser);
@@ -2335,20 +3153,15 @@ ASTN_Statement parser_parse_statement(Parser* parser, uint8_t scopeOS) {
     return stm;
 }
 
-ASTN_Statements* parser_parse_statements(Parser* parser, uint8_t scopeOS) {
-    ASTN_Statements* stms = malloc(sizeof(ASTN_Statements));
-    stms->statement = NULL;
-    stms->size = 0;
-    stms->item_size = sizeof(ASTN_Statement*);
+ASTN_Statements* parser_parse_statements(Parser* parser) {
+    ASTN_Statements* stms = arena_calloc(&parser->arena, 1, sizeof(ASTN_Statements));
 
-    while (parser->cur->type != TOK_EOF && parser->cur->type != TOK_RBRACE && parser->cur->type != TOK_CASE && parser->cur->type != TOK_DEFAULT) {
-        AST_Node* node = ast_init(STMT);
-        node->data.stm = parser_parse_statement(parser, scopeOS);
+    while (PCT(parser) != TOK_EOF && PCT(parser) != TOK_RBRACE && PCT(parser) != TOK_CASE && PCT(parser) != TOK_DEFAULT) {
+        AST_Node* node = ast_init(&parser->arena, STMT);
+        node->data.stm = parser_parse_statement(parser);
         
         if (node->data.stm.type != -1) {
-            stms->statement = realloc(stms->statement, (stms->size + 1) * stms->item_size);
-            stms->statement[stms->size] = node;
-            stms->size++;
+            AST_VEC_PUSH(&parser->arena, *stms, node);
         }
     }
 
@@ -2358,7 +3171,7 @@ ASTN_Statements* parser_parse_statements(Parser* parser, uint8_t scopeOS) {
 
 AST_Node* parser_parse_mep_decl(Parser* parser) {
     symtbl_insert(parser, symbol_init(
-        (char*)"MEP", SYMBOL_MEP, parser->scope, parser->nest, 0, 0, 0, 0, parser->lexer->cl, parser->lexer->cc
+        intern_atom("MEP", 3), SYMBOL_MEP, parser->scope, parser->nest, 0, 0, 0, 0, PCL(parser), PCC(parser)
     ));
 
     parser_consume(parser);
@@ -2368,16 +3181,16 @@ AST_Node* parser_parse_mep_decl(Parser* parser) {
     }
 
     if (!(parser_expect_spec_value(parser, TOK_IDEN, "main"))) {
-        REPORT_ERROR(parser->lexer, "E_MEP_NAME_MAIN", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_MEP_NAME_MAIN", PCV(parser));
         return NULL;
     }
 
     if (!(parser_expect(parser, TOK_FN_ARROW))) {
-        REPORT_ERROR(parser->lexer, "E_FN_ARROW", parser->cur->value);
+        REPORT_ERROR(parser->lexer, "E_FN_ARROW", PCV(parser));
         return NULL;
     }
 
-    AST_Node* node = ast_init(MEP);
+    AST_Node* node = ast_init(&parser->arena, MEP);
     node->data.mep.parameters = parser_parse_parameters(parser);
     if (node->data.mep.parameters == NULL) {
         return NULL;
@@ -2385,7 +3198,12 @@ AST_Node* parser_parse_mep_decl(Parser* parser) {
 
     parser_expect(parser, TOK_LBRACE);
 
-    node->data.mep.statements = parser_parse_statements(parser, 0);
+    if (parser->lazy) {
+        node->data.mep.body = parser_skip_body(parser);
+        return node;
+    }
+
+    node->data.mep.statements = parser_parse_statements(parser);
     if (node->data.mep.statements == NULL) {
         return NULL;
     }
@@ -2393,32 +3211,96 @@ AST_Node* parser_parse_mep_decl(Parser* parser) {
     return node;
 }
 
-void symtbl_insert(Parser* parser, Symbol* symbol) {
-    if (!parser->tbl) {
-        exit(EXIT_FAILURE);
-        return;
+ASTN_Statements* parser_parse_body(Parser* parser, AST_Node* node) {
+    /*
+    Parses the statements of a function declaration or MEP whose body a lazy parser skipped, in
+    the scope they were skipped in, with the symbols then in scope bound again (so they come out
+    as they would have in place); diagnostics are reported now
+    return: pointer to the statements (the same ones on later calls); NULL if the node has none
+    */
+
+    ASTN_Body** body;
+    ASTN_Statements** stms;
+    Symbol* self = NULL;
+
+    if (node && node->type == MEP) {
+        body = &node->data.mep.body;
+        stms = &node->data.mep.statements;
+    } else if (node && node->type == STMT && node->data.stm.type == STMT_FUNCTION_DECL) {
+        body = &node->data.stm.data.function_decl.body;
+        stms = &node->data.stm.data.function_decl.statements;
+        self = symtbl_find(parser->tbl, node->data.stm.data.function_decl.identifier.atom, 0);
+    } else {
+        return NULL;
     }
 
-    Symbol* checks = parser->tbl->symbol;
-    while (checks != NULL) {
-        if (checks->data.id == symbol->data.id) {
-            REPORT_ERROR(parser->lexer, "U_ATO_DPRED");
-            return; 
-        }
-        checks = checks->next;
+    if (!*body) {
+        return *stms;
+    }
+
+    size_t pos = parser->pos;
+    ScopeId scope = parser->scope;
+    ScopeId highest_scope = parser->highest_scope;
+    uint8_t nest = parser->nest;
+    uint32_t owner = parser->owner;
+    Symbol* hidden = parser->hidden;
+    size_t depth = symtbl_depth(parser->tbl);
+
+    parser_seek(parser, (*body)->start);
+    parser->scope = (*body)->scope;
+    parser->highest_scope = (*body)->scope;
+    parser->nest = (*body)->nest;
+    parser->owner = (*body)->owner;
+    // (a top-level function doesn't see itself, as it's declared after its body)
+    parser->hidden = (self && self->data.owner == parser->owner) ? self : NULL;
+
+    symtbl_enter(parser->tbl);
+
+    for (size_t i = 0; i < (*body)->bound_size; i++) {
+        symtbl_bind(parser->tbl, (*body)->bound[i]);
+    }
+
+    *stms = parser_parse_statements(parser);
+    symtbl_leave(parser->tbl, depth);
+
+    // (a 'case' or 'default' ends the statements before the closing brace)
+    if (parser->pos != (*body)->end) {
+        REPORT_ERROR(parser->lexer, "E_RBRACE");
     }
 
+    *body = NULL;
 
-    if (parser->tbl->symbol == NULL) {
-        parser->tbl->symbol = symbol;
+    parser_seek(parser, pos);
+    parser->scope = scope;
+    parser->highest_scope = highest_scope;
+    parser->nest = nest;
+    parser->owner = owner;
+    parser->hidden = hidden;
+
+    return *stms;
+}
+
+void symtbl_insert(Parser* parser, Symbol* symbol) {
+    if (!parser->tbl) {
+        exit(EXIT_FAILURE);
         return;
     }
 
-    Symbol* current = parser->tbl->symbol;
+    symbol->data.owner = parser->owner;
+
+    // (the keys a declaration adds are its own: its scopes are numbered apart from any other's
+    // and only declarations parsed on the calling thread declare at scope 0, so which symbol
+    // of a key comes first never depends on how the workers interleave)
+    Symbol* held = symtbl_add(parser->tbl, symbol);
+
+    if (held != symbol) {
+        // (parser_reparse leaves the declarations after the ones it parses again declared)
+        parser->displaced = parser->displaced || (parser->ranks && held->data.owner && parser->owner &&
+            parser->ranks[held->data.owner] > parser->ranks[parser->owner]);
 
-    while (current->next != NULL) {
-        current = current->next;
+        REPORT_ERROR(parser->lexer, "U_ATO_DPRED");
+        return; 
     }
 
-    current->next = symbol;
+    symtbl_bind(parser->tbl, symbol);
 }
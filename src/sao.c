@@ -2,7 +2,9 @@
 
 
 void SAO(AST_Node *root) {
-    trav(root);
+    for (size_t i = 0; i < root->data.root.size; i++) {
+        trav(AST_VEC_ITEMS(root->data.root)[i]);
+    }
 
     // optimize and analyze
 }
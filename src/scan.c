@@ -0,0 +1,231 @@
+#include "scan.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// scalar kernels (reference behaviour, also used for the tails of the vector kernels)
+
+static inline bool scan_is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool scan_is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool scan_is_iden(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || scan_is_digit(c) || c == '_';
+}
+
+static inline bool scan_is_string(char c) {
+    return c != '"' && c != '\\' && c != '\0';
+}
+
+static inline bool scan_is_line(char c) {
+    return c != '\n' && c != '\v';
+}
+
+#define SCAN_SCALAR(name, is_member) \
+    static size_t name(const char* buf, size_t n) { \
+        size_t i = 0; \
+        while (i < n && is_member(buf[i])) { \
+            i++; \
+        } \
+        return i; \
+    }
+
+SCAN_SCALAR(scan_blanks_scalar, scan_is_blank)
+SCAN_SCALAR(scan_iden_scalar, scan_is_iden)
+SCAN_SCALAR(scan_digits_scalar, scan_is_digit)
+SCAN_SCALAR(scan_string_scalar, scan_is_string)
+SCAN_SCALAR(scan_line_scalar, scan_is_line)
+
+#ifdef SCAN_X86
+
+// vector kernels: classify a block into a byte mask (0xFF = member of the run), then the first
+// clear bit of the movemask is the end of the run. Bytes >= 0x80 compare as negative and so
+// never fall into an ASCII range, matching the scalar kernels
+
+#define SCAN_SSE2_RANGE(v, lo, hi) \
+    _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8((lo) - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8((hi) + 1)))
+
+static inline __m128i scan_sse2_blanks(__m128i v) {
+    return _mm_or_si128(_mm_or_si128(
+        _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+        _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+}
+
+static inline __m128i scan_sse2_digits(__m128i v) {
+    return SCAN_SSE2_RANGE(v, '0', '9');
+}
+
+static inline __m128i scan_sse2_iden(__m128i v) {
+    return _mm_or_si128(_mm_or_si128(SCAN_SSE2_RANGE(v, 'a', 'z'), SCAN_SSE2_RANGE(v, 'A', 'Z')),
+        _mm_or_si128(SCAN_SSE2_RANGE(v, '0', '9'), _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+}
+
+static inline __m128i scan_sse2_string(__m128i v) {
+    __m128i stop = _mm_or_si128(_mm_or_si128(
+        _mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+        _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+
+    return _mm_xor_si128(stop, _mm_set1_epi8(-1));
+}
+
+static inline __m128i scan_sse2_line(__m128i v) {
+    __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\v')));
+
+    return _mm_xor_si128(stop, _mm_set1_epi8(-1));
+}
+
+#define SCAN_SSE2(name, classify, tail) \
+    static size_t name(const char* buf, size_t n) { \
+        size_t i = 0; \
+        for (; i + 16 <= n; i += 16) { \
+            __m128i v = _mm_loadu_si128((const __m128i*)(buf + i)); \
+            unsigned int mask = ~(unsigned int)_mm_movemask_epi8(classify(v)) & 0xFFFFu; \
+            if (mask) { \
+                return i + (size_t)__builtin_ctz(mask); \
+            } \
+        } \
+        return i + tail(buf + i, n - i); \
+    }
+
+SCAN_SSE2(scan_blanks_sse2, scan_sse2_blanks, scan_blanks_scalar)
+SCAN_SSE2(scan_iden_sse2, scan_sse2_iden, scan_iden_scalar)
+SCAN_SSE2(scan_digits_sse2, scan_sse2_digits, scan_digits_scalar)
+SCAN_SSE2(scan_string_sse2, scan_sse2_string, scan_string_scalar)
+SCAN_SSE2(scan_line_sse2, scan_sse2_line, scan_line_scalar)
+
+#define SCAN_AVX2_TARGET __attribute__((target("avx2")))
+
+#define SCAN_AVX2_RANGE(v, lo, hi) \
+    _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8((lo) - 1)), \
+        _mm256_cmpgt_epi8(_mm256_set1_epi8((hi) + 1), v))
+
+static inline SCAN_AVX2_TARGET __m256i scan_avx2_blanks(__m256i v) {
+    return _mm256_or_si256(_mm256_or_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+}
+
+static inline SCAN_AVX2_TARGET __m256i scan_avx2_digits(__m256i v) {
+    return SCAN_AVX2_RANGE(v, '0', '9');
+}
+
+static inline SCAN_AVX2_TARGET __m256i scan_avx2_iden(__m256i v) {
+    return _mm256_or_si256(_mm256_or_si256(SCAN_AVX2_RANGE(v, 'a', 'z'), SCAN_AVX2_RANGE(v, 'A', 'Z')),
+        _mm256_or_si256(SCAN_AVX2_RANGE(v, '0', '9'), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'))));
+}
+
+static inline SCAN_AVX2_TARGET __m256i scan_avx2_string(__m256i v) {
+    __m256i stop = _mm256_or_si256(_mm256_or_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+        _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+
+    return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+}
+
+static inline SCAN_AVX2_TARGET __m256i scan_avx2_line(__m256i v) {
+    __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\v')));
+
+    return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+}
+
+#define SCAN_AVX2(name, classify, tail) \
+    static SCAN_AVX2_TARGET size_t name(const char* buf, size_t n) { \
+        size_t i = 0; \
+        for (; i + 32 <= n; i += 32) { \
+            __m256i v = _mm256_loadu_si256((const __m256i*)(buf + i)); \
+            unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(classify(v)); \
+            if (mask) { \
+                return i + (size_t)__builtin_ctz(mask); \
+            } \
+        } \
+        return i + tail(buf + i, n - i); \
+    }
+
+// tails of less than 32 bytes go through the 16 byte kernel before falling back to scalar
+SCAN_AVX2(scan_blanks_avx2, scan_avx2_blanks, scan_blanks_sse2)
+SCAN_AVX2(scan_iden_avx2, scan_avx2_iden, scan_iden_sse2)
+SCAN_AVX2(scan_digits_avx2, scan_avx2_digits, scan_digits_sse2)
+SCAN_AVX2(scan_string_avx2, scan_avx2_string, scan_string_sse2)
+SCAN_AVX2(scan_line_avx2, scan_avx2_line, scan_line_sse2)
+
+#endif // SCAN_X86
+
+static const Scanner scanners[] = {
+#ifdef SCAN_X86
+    { "avx2", scan_blanks_avx2, scan_iden_avx2, scan_digits_avx2, scan_string_avx2, scan_line_avx2 },
+    { "sse2", scan_blanks_sse2, scan_iden_sse2, scan_digits_sse2, scan_string_sse2, scan_line_sse2 },
+#endif
+    { "scalar", scan_blanks_scalar, scan_iden_scalar, scan_digits_scalar, scan_string_scalar, scan_line_scalar },
+};
+
+Scanner scanner = { "scalar", scan_blanks_scalar, scan_iden_scalar, scan_digits_scalar, scan_string_scalar, scan_line_scalar };
+
+static pthread_once_t scan_once = PTHREAD_ONCE_INIT;
+
+static bool scan_supported(const char* isa) {
+    /*
+    Checks whether the running cpu can execute provided implementation
+    return: true if supported
+    */
+
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+
+    if (strcmp(isa, "avx2") == 0) {
+        return __builtin_cpu_supports("avx2");
+    } else if (strcmp(isa, "sse2") == 0) {
+        return __builtin_cpu_supports("sse2");
+    }
+#endif
+
+    return strcmp(isa, "scalar") == 0;
+}
+
+static bool scan_select(const char* isa) {
+    for (size_t i = 0; i < sizeof(scanners) / sizeof(scanners[0]); i++) {
+        if (strcmp(scanners[i].isa, isa) == 0 && scan_supported(isa)) {
+            scanner = scanners[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void scan_select_default(void) {
+    // (the vector kernels aren't measurably faster end to end: the runs they scan are short and
+    // lexing time goes to storing tokens and interning names; lexer_bench --scan compares them)
+    scan_select("scalar");
+}
+
+bool scan_use(const char* isa) {
+    /*
+    Selects provided implementation ("avx2", "sse2" or "scalar") for all scanners, in place of
+    the one scan_init picks; meant for tests and benchmarks, before any lexer runs (scanner is
+    read without a lock)
+    return: false (and leaves the selection untouched) if unknown or unsupported by the cpu
+    */
+
+    pthread_once(&scan_once, scan_select_default);
+
+    return scan_select(isa);
+}
+
+void scan_init(void) {
+    /*
+    Selects the scalar implementation, once (lexers initialized on any # of threads at once all
+    call it), unless scan_use already selected one
+    */
+
+    pthread_once(&scan_once, scan_select_default);
+}
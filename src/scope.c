@@ -0,0 +1,90 @@
+#include "scope.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+ScopeTree* scope_init() {
+    /*
+    Makes a tree holding just the top level (id 0)
+    return: pointer to the tree
+    */
+
+    ScopeTree* tree = calloc(1, sizeof(ScopeTree));
+
+    if (!tree) {
+        exit(EXIT_FAILURE);
+    }
+
+    scope_reserve(tree, 1);
+
+    return tree;
+}
+
+void scope_free(ScopeTree* tree) {
+    if (!tree) {
+        return;
+    }
+
+    free(tree->scopes);
+    free(tree);
+}
+
+ScopeId scope_reserve(ScopeTree* tree, size_t count) {
+    /*
+    Hands out a run of provided # of ids, entries zeroed until each is opened (only while no
+    other thread uses the tree: entries may move)
+    return: first id of the run
+    */
+
+    size_t first = tree->size;
+
+    if (first + count > UINT32_MAX) {
+        exit(EXIT_FAILURE);
+    }
+
+    if (first + count > tree->capacity) {
+        size_t capacity = (tree->capacity) ? tree->capacity : 256;
+
+        while (capacity < first + count) {
+            capacity *= 2;
+        }
+
+        tree->scopes = realloc(tree->scopes, capacity * sizeof(Scope));
+
+        if (!tree->scopes) {
+            exit(EXIT_FAILURE);
+        }
+
+        tree->capacity = capacity;
+    }
+
+    memset(tree->scopes + first, 0, count * sizeof(Scope));
+    tree->size = first + count;
+
+    return (ScopeId)first;
+}
+
+void scope_open(ScopeTree* tree, ScopeId id, ScopeId parent, uint8_t kind) {
+    /*
+    Links provided (reserved) id under the scope enclosing it (threads may open ids of runs of
+    their own at once)
+    */
+
+    tree->scopes[id] = (Scope){ parent, (uint16_t)(tree->scopes[parent].depth + 1), kind };
+}
+
+ScopeId scope_parent(ScopeTree* tree, ScopeId id) {
+    /*
+    return: id of the scope enclosing provided one (0 for the top level)
+    */
+
+    return tree->scopes[id].parent;
+}
+
+uint16_t scope_depth(ScopeTree* tree, ScopeId id) {
+    return tree->scopes[id].depth;
+}
+
+uint8_t scope_kind(ScopeTree* tree, ScopeId id) {
+    return tree->scopes[id].kind;
+}
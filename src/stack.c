@@ -4,26 +4,26 @@ Stack* stack_init() {
     Stack* stack = (Stack*)malloc(sizeof(Stack));
     stack->capacity = 8;
     stack->size = 0;
-    stack->data = (__uint128_t*)malloc(stack->capacity * sizeof(__uint128_t));
+    stack->data = (uint32_t*)malloc(stack->capacity * sizeof(uint32_t));
     return stack;
 }
 
-void stack_push(Stack* stack, __uint128_t value) {
+void stack_push(Stack* stack, uint32_t value) {
     if (stack->size == stack->capacity) {
         stack->capacity *= 2;
-        stack->data = (__uint128_t*)realloc(stack->data, stack->capacity * sizeof(__uint128_t));
+        stack->data = (uint32_t*)realloc(stack->data, stack->capacity * sizeof(uint32_t));
     }
     stack->data[stack->size++] = value;
 }
 
-__uint128_t stack_pop(Stack* stack) {
+uint32_t stack_pop(Stack* stack) {
     if (stack->size == 0) {
         return 0;
     }
     return stack->data[--stack->size];
 }
 
-__uint128_t stack_peek(Stack* stack) {
+uint32_t stack_peek(Stack* stack) {
     if (stack->size == 0) {
         return 0;
     }
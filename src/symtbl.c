@@ -3,14 +3,89 @@
 #include <stdio.h>
 #include <string.h>
 
+static SymIndex* symtbl_index_init() {
+    SymIndex* index = calloc(1, sizeof(SymIndex));
+
+    if (!index) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < SYMTBL_SHARDS; i++) {
+        pthread_mutex_init(&index->shards[i].lock, NULL);
+    }
+
+    return index;
+}
+
+static void symtbl_retire(SymSlots* slots) {
+    while (slots != NULL) {
+        SymSlots* retired = slots->retired;
+        free(slots);
+        slots = retired;
+    }
+}
+
 SymTable* symtbl_init() {
     SymTable* table = calloc(1, sizeof(SymTable));
 
+    if (!table) {
+        exit(EXIT_FAILURE);
+    }
+
     table->symbol = NULL;
+    table->index = symtbl_index_init();
 
     return table;
 }
 
+SymTable* symtbl_init_shared(SymTable* owner) {
+    /*
+    Makes a table of its own symbols and scopes whose symbols go to provided table's index, so
+    each thread of a parse adds to one index through a table of its own (owner outlives it)
+    return: pointer to the table
+    */
+
+    SymTable* table = calloc(1, sizeof(SymTable));
+
+    if (!table) {
+        exit(EXIT_FAILURE);
+    }
+
+    table->owner = owner;
+    table->index = owner->index;
+
+    return table;
+}
+
+void symtbl_release(SymTable* table) {
+    /*
+    Frees the index (unless shared) and the scopes of a table, leaving its symbols and itself
+    to whatever holds them
+    */
+
+    if (table->index && !table->owner) {
+        for (size_t i = 0; i < SYMTBL_SHARDS; i++) {
+            pthread_mutex_destroy(&table->index->shards[i].lock);
+            symtbl_retire(table->index->shards[i].slots);
+        }
+
+        free(table->index);
+    }
+
+    table->index = NULL;
+
+    free(table->visible);
+
+    if (table->frames) {
+        stack_free(table->bound);
+        stack_free(table->frames);
+    }
+
+    table->visible = NULL;
+    table->visible_size = 0;
+    table->bound = table->frames = NULL;
+}
+
 void symtbl_free(SymTable* table) {
     if (!table) {
         return;
@@ -25,14 +100,222 @@ void symtbl_free(SymTable* table) {
         current = next;
     }
 
+    symtbl_release(table);
     free(table);
 }
 
-Symbol* symbol_init(char* id, unsigned int type, unsigned int scope, unsigned int nest, uint8_t mem_type, 
-    uint8_t mem_mod, uint8_t mem_sto, uint8_t  access_type, uint8_t decl_line, uint8_t decl_col) {
+static Symbol symtbl_removed; // (its address marks slots of removed keys)
+#define SYMTBL_REMOVED (&symtbl_removed)
+
+static SymShard* symtbl_shard(SymIndex* index, uint64_t hash) {
+    return &index->shards[(hash >> 32) % SYMTBL_SHARDS];
+}
+
+static SymSlot* symtbl_probe(SymSlots* slots, uint32_t atom, ScopeId scope, uint64_t hash, Symbol** held) {
+    /*
+    Probes provided slots for a key (no lock needed: keys are never moved nor removed from slots
+    readers can see), handing back the symbol it saw in the slot ending the probe: a writer may
+    fill an empty slot with another key right after, so the slot mustn't be loaded again (a
+    removed key's slot ends its probe with SYMTBL_REMOVED)
+    return: pointer to its slot; to the empty slot ending the probe if it's missing
+    */
+
+    size_t mask = slots->capacity - 1;
+
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        SymSlot* slot = &slots->slot[i];
+        Symbol* symbol = __atomic_load_n(&slot->symbol, __ATOMIC_ACQUIRE);
+
+        if (!symbol || (slot->atom == atom && slot->scope == scope)) {
+            *held = symbol;
+            return slot;
+        }
+    }
+}
+
+static void symtbl_grow(SymShard* shard) {
+    /*
+    Moves a shard's keys to slots twice as many, or as many when removed keys filled them (with
+    the shard's lock held); the old slots stay readable, as a lookup may still be probing them
+    */
+
+    SymSlots* old = shard->slots;
+    size_t capacity = (old) ? old->capacity : 16;
+
+    if (old && shard->size * 2 >= capacity) {
+        capacity *= 2;
+    }
+
+    SymSlots* slots = calloc(1, sizeof(SymSlots) + capacity * sizeof(SymSlot));
+
+    if (!slots) {
+        exit(EXIT_FAILURE);
+    }
+
+    slots->capacity = capacity;
+    slots->retired = old;
+
+    for (size_t i = 0; old && i < old->capacity; i++) {
+        SymSlot* from = &old->slot[i];
+        Symbol* held;
+
+        if (from->symbol && from->symbol != SYMTBL_REMOVED) {
+            *symtbl_probe(slots, from->atom, from->scope, symtbl_hash(from->atom, from->scope), &held) = *from;
+        }
+    }
+
+    shard->removed = 0;
+
+    __atomic_store_n(&shard->slots, slots, __ATOMIC_RELEASE);
+}
+
+static Symbol* symtbl_claim(SymIndex* index, Symbol* symbol) {
+    /*
+    Indexes provided symbol under its atom and scope unless the key is taken (safe to call from
+    any # of threads at once: of symbols of one key added at once, exactly one gets it)
+    return: the symbol holding the key
+    */
+
+    uint32_t atom = symbol->data.atom;
+    ScopeId scope = symbol->data.scope;
+    uint64_t hash = symtbl_hash(atom, scope);
+    SymShard* shard = symtbl_shard(index, hash);
+
+    pthread_mutex_lock(&shard->lock);
+
+    if (!shard->slots || (shard->size + shard->removed + 1) * 4 > shard->slots->capacity * 3) {
+        symtbl_grow(shard);
+    }
+
+    Symbol* held;
+    SymSlot* slot = symtbl_probe(shard->slots, atom, scope, hash, &held);
+
+    if (!held || held == SYMTBL_REMOVED) {
+        shard->removed -= (held == SYMTBL_REMOVED);
+
+        slot->atom = atom;
+        slot->scope = scope;
+        __atomic_store_n(&slot->symbol, symbol, __ATOMIC_RELEASE);
+
+        shard->size++;
+        held = symbol;
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return held;
+}
+
+static void symtbl_link(SymTable* table, Symbol* symbol) {
+    symbol->next = NULL;
+
+    if (table->last) {
+        table->last->next = symbol;
+    } else {
+        table->symbol = symbol;
+    }
+
+    table->last = symbol;
+}
+
+Symbol* symtbl_add(SymTable* table, Symbol* symbol) {
+    /*
+    Indexes provided symbol and links it at the end of the table, unless its atom and scope are
+    already taken (by a symbol of any table sharing the index): claiming the key is one step, so
+    threads adding at once through their own tables can't both get it
+    return: the symbol holding the key (provided one if it was free)
+    */
+
+    Symbol* held = symtbl_claim(table->index, symbol);
+
+    if (held == symbol) {
+        symtbl_link(table, symbol);
+    }
+
+    return held;
+}
+
+void symtbl_remove(SymTable* table, Symbol* symbol) {
+    /*
+    Takes provided symbol out of the index, if it holds its key (it stays linked in the table
+    for the caller to unlink); the key is free to be added again
+    */
+
+    uint32_t atom = symbol->data.atom;
+    ScopeId scope = symbol->data.scope;
+    uint64_t hash = symtbl_hash(atom, scope);
+    SymShard* shard = symtbl_shard(table->index, hash);
+
+    pthread_mutex_lock(&shard->lock);
+
+    Symbol* held = NULL;
+    SymSlot* slot = (shard->slots) ? symtbl_probe(shard->slots, atom, scope, hash, &held) : NULL;
+
+    if (held == symbol) {
+        __atomic_store_n(&slot->symbol, SYMTBL_REMOVED, __ATOMIC_RELEASE);
+
+        shard->size--;
+        shard->removed++;
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+}
+
+void symtbl_index(SymTable* table) {
+    /*
+    Indexes the table again from its list of symbols, once they were linked or unlinked by hand
+    (while no other thread uses its index); of symbols listed under one key, the first one gets it
+    */
+
+    if (!table->index) {
+        table->index = symtbl_index_init();
+    }
+
+    for (size_t i = 0; i < SYMTBL_SHARDS; i++) {
+        SymShard* shard = &table->index->shards[i];
+
+        if (shard->slots) {
+            symtbl_retire(shard->slots->retired);
+            shard->slots->retired = NULL;
+            memset(shard->slots->slot, 0, shard->slots->capacity * sizeof(SymSlot));
+        }
+
+        shard->size = 0;
+        shard->removed = 0;
+    }
+
+    table->last = NULL;
+
+    for (Symbol* symb = table->symbol; symb != NULL; symb = symb->next) {
+        symtbl_claim(table->index, symb);
+        table->last = symb;
+    }
+}
+
+Symbol* symtbl_detach(SymTable* table, Symbol** last) {
+    /*
+    Unlinks every symbol of the table, which stay indexed (for the table sharing the index they
+    are linked into next)
+    return: first of its symbols (still linked through next); last one in provided pointer
+    */
+
+    Symbol* first = table->symbol;
+
+    if (last) {
+        *last = table->last;
+    }
+
+    table->symbol = NULL;
+    table->last = NULL;
+
+    return first;
+}
+
+Symbol* symbol_init(uint32_t atom, unsigned int type, ScopeId scope, unsigned int nest, uint8_t mem_type, 
+    uint8_t mem_mod, uint8_t mem_sto, uint8_t  access_type, unsigned int decl_line, unsigned int decl_col) {
     Symbol* symb = calloc(1, sizeof(Symbol));
 
-    symb->data.id = symtbl_hash((const char*)id, scope);
+    symb->data.atom = atom;
     symb->data.scope = scope;
     symb->data.nest = nest;
     symb->data.type = type;
@@ -54,42 +337,174 @@ Symbol* symbol_init(char* id, unsigned int type, unsigned int scope, unsigned in
 }
 
 
-Symbol* symtbl_lookup(SymTable* table, char* id, unsigned int scope, uint8_t scope_offset) {
-    uint32_t hash_id = symtbl_hash((const char*)id, scope);
-    Symbol* current = table->symbol;
+Symbol* symtbl_find(SymTable* table, uint32_t atom, ScopeId scope) {
+    /*
+    Looks the symbol of provided atom and scope up in the table's index, taking no lock (threads
+    may be adding to it meanwhile)
+    return: pointer to the symbol; NULL if none is declared there
+    */
 
-    while (current != NULL) {
-        if (current->data.id == hash_id) {
-            return current;
+    if (!table->index) {
+        return NULL;
+    }
+
+    uint64_t hash = symtbl_hash(atom, scope);
+    SymSlots* slots = __atomic_load_n(&symtbl_shard(table->index, hash)->slots, __ATOMIC_ACQUIRE);
+    Symbol* held = NULL;
+
+    if (slots) {
+        symtbl_probe(slots, atom, scope, hash, &held);
+    }
+
+    return (held != SYMTBL_REMOVED) ? held : NULL;
+}
+
+size_t symtbl_size(SymTable* table) {
+    /*
+    return: # of keys indexed (by every table sharing the index)
+    */
+
+    size_t size = 0;
+
+    for (size_t i = 0; table->index && i < SYMTBL_SHARDS; i++) {
+        SymShard* shard = &table->index->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        size += shard->size;
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return size;
+}
+
+void symtbl_enter(SymTable* table) {
+    /*
+    Opens a scope inside the innermost open one: the symbols bound from now on are looked up
+    before the ones they hide, until it's left
+    */
+
+    if (!table->frames) {
+        table->bound = stack_init();
+        table->frames = stack_init();
+    }
+
+    stack_push(table->frames, (uint32_t)table->bound->size);
+}
+
+void symtbl_bind(SymTable* table, Symbol* symbol) {
+    /*
+    Makes provided (added) symbol the one its name looks up to until the innermost open scope is
+    left, hiding the one bound before it; nothing is bound while no scope is open
+    */
+
+    if (!table->frames || stack_is_empty(table->frames)) {
+        return;
+    }
+
+    uint32_t atom = symbol->data.atom;
+
+    if (atom >= table->visible_size) {
+        size_t size = (table->visible_size) ? table->visible_size : 256;
+
+        while (size <= atom) {
+            size *= 2;
         }
-        current = current->next;
+
+        table->visible = realloc(table->visible, size * sizeof(Symbol*));
+
+        if (!table->visible) {
+            exit(EXIT_FAILURE);
+        }
+
+        memset(table->visible + table->visible_size, 0, (size - table->visible_size) * sizeof(Symbol*));
+        table->visible_size = size;
     }
 
-    for (unsigned int i = 1; i <= scope_offset && scope >= i; ++i) {
-        current = table->symbol;
-        hash_id = symtbl_hash((const char*)id, scope - i);
-        while (current != NULL) {
-            if (current->data.id == hash_id) {
-                return current;
-            }
-            current = current->next;
+    symbol->shadow = table->visible[atom];
+    table->visible[atom] = symbol;
+    stack_push(table->bound, atom);
+}
+
+void symtbl_leave(SymTable* table, size_t depth) {
+    /*
+    Leaves the innermost open scopes until provided # of them are open, unbinding the symbols of
+    each (so the ones they hid are looked up again) in O(# of symbols they bound): the symbol
+    an entry of bound stands for is the innermost one of its atom, as any bound after it are
+    unbound first
+    */
+
+    while (symtbl_depth(table) > depth) {
+        size_t size = stack_pop(table->frames);
+
+        while (table->bound->size > size) {
+            uint32_t atom = stack_pop(table->bound);
+            Symbol* symb = table->visible[atom];
+
+            table->visible[atom] = symb->shadow;
+            symb->shadow = NULL;
         }
     }
+}
+
+size_t symtbl_depth(SymTable* table) {
+    /*
+    return: # of open scopes
+    */
 
-    return NULL;
+    return (table->frames) ? table->frames->size : 0;
 }
 
+size_t symtbl_bound(SymTable* table, Symbol** symbols) {
+    /*
+    Writes the symbols bound in the open scopes, outermost first, to provided array (unless
+    NULL), walking each atom's shadow chain from the innermost entry of bound outwards
+    return: # of symbols bound
+    */
+
+    size_t size = (table->bound) ? table->bound->size : 0;
+
+    if (!symbols) {
+        return size;
+    }
+
+    uint32_t* atoms = (size) ? table->bound->data : NULL;
 
-int32_t symtbl_hash(const char* key, unsigned int scope) {
-    int32_t hash_val = 5381;
+    for (size_t k = size; k-- > 0;) {
+        symbols[k] = table->visible[atoms[k]];
+        table->visible[atoms[k]] = symbols[k]->shadow;
+    }
 
-    while (*key) {
-        hash_val = ((hash_val << 5) + hash_val) + *key++;
+    // (the innermost symbol of each atom is written back last)
+    for (size_t k = 0; k < size; k++) {
+        table->visible[atoms[k]] = symbols[k];
     }
 
-    hash_val = ((hash_val << 5) + hash_val) + scope;
+    return size;
+}
+
+Symbol* symtbl_lookup(SymTable* table, uint32_t atom) {
+    /*
+    Looks provided atom up in the open scopes of the table (its own, even if it shares an index),
+    innermost first: a single probe, however deep the scopes are nested
+    return: pointer to the symbol; NULL if none is bound under it
+    */
+
+    return (atom < table->visible_size) ? table->visible[atom] : NULL;
+}
+
+
+uint64_t symtbl_hash(uint32_t atom, ScopeId scope) {
+    /*
+    Mixes the key of a symbol (both halves reach every bit)
+    return: 64-bit hash of provided atom and scope
+    */
+
+    uint64_t hash = ((uint64_t)scope << 32) | atom;
+
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
 
-    return hash_val;
+    return hash ^ (hash >> 31);
 }
 
 
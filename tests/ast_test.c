@@ -0,0 +1,274 @@
+#include <criterion/criterion.h>
+
+#include "parser.h"
+#include "test_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+TestSuite(ast);
+
+static Parser* test_parse(const char* source, bool cons) {
+    Parser* parser = test_parser(source);
+
+    if (cons) {
+        ast_pool_cons(&parser->exprs);
+    }
+
+    parser_parse_parallel(parser, 4);
+
+    return parser;
+}
+
+static size_t test_print(ASTN_ExprPool* pool, ASTN_ExprRef ref, char* buf, size_t size) {
+    // writes the whole tree of an expression, operands included, as nested parens
+    if (!ref) {
+        return (size_t)snprintf(buf, size, "()");
+    }
+
+    ASTN_ExprNode* node = AST_EXPR(pool, ref);
+    int len = snprintf(buf, size, "(%u %u", node->type, node->op);
+
+    switch (node->type) {
+        case EXPR_IDENTIFIER:
+            len += snprintf(buf + len, size - len, " %s@%u", intern_name(node->data.identifier.atom), node->data.identifier.scope);
+            break;
+        case EXPR_LITERAL:
+            len += snprintf(buf + len, size - len, " %d:%llu", pool->literals[node->data.literal].type,
+                (unsigned long long)pool->literals[node->data.literal].value.uint.bit64);
+            break;
+        case EXPR_FUNCTION_CALL: {
+            ASTN_Call* call = &pool->calls[node->data.call];
+            len += snprintf(buf + len, size - len, " %s@%u", intern_name(call->identifier.atom), call->identifier.scope);
+
+            for (uint32_t i = 0; i < call->size; i++) {
+                len += (int)test_print(pool, pool->args[call->args + i], buf + len, size - len);
+            }
+
+            break;
+        }
+        case EXPR_FACTOR:
+        case EXPR_NEST:
+        case EXPR_POSTFIX:
+            len += (int)test_print(pool, node->data.unary_op.expr, buf + len, size - len);
+            break;
+        default:
+            len += (int)test_print(pool, node->data.binary_op.left, buf + len, size - len);
+            len += (int)test_print(pool, node->data.binary_op.right, buf + len, size - len);
+            break;
+    }
+
+    return (size_t)(len + snprintf(buf + len, size - len, ")"));
+}
+
+static size_t test_exprs(ASTN_Statements* stms, ASTN_ExprRef* refs, size_t size) {
+    // gathers the expressions of variable declarations, returns and loops, in order
+    for (size_t i = 0; stms && i < stms->size; i++) {
+        ASTN_Statement* stm = &AST_VEC_ITEMS(*stms)[i]->data.stm;
+
+        if (stm->type == STMT_VARIABLE_DECL) {
+            refs[size++] = stm->data.variable_decl.expr;
+        } else if (stm->type == STMT_RETURN) {
+            refs[size++] = stm->data.return_stm.expr;
+        } else if (stm->type == STMT_WHILE_LOOP) {
+            refs[size++] = stm->data.while_loop.condition_expr;
+            size = test_exprs(stm->data.while_loop.statements, refs, size);
+        }
+    }
+
+    return size;
+}
+
+static ASTN_ExprRef* test_fn_exprs(Parser* parser, size_t decl, size_t* size) {
+    static ASTN_ExprRef refs[64];
+
+    AST_Node* node = AST_VEC_ITEMS(parser->root->data.root)[decl];
+    *size = test_exprs(node->data.stm.data.function_decl.statements, refs, 0);
+
+    return refs;
+}
+
+Test(ast, cons_same_tree) {
+    // enough functions for parser_parse_parallel to merge the pools of several workers
+    static char source[1 << 20];
+    size_t len = 0;
+
+    for (int n = 0; n < 2000; n++) {
+        len += (size_t)snprintf(source + len, sizeof(source) - len,
+            "fn f%d => (int: a, int: c) {\n"
+            "    var int: t = a * 9 + (c << 2) - %d;\n"
+            "    while (a < t) {\n"
+            "        return (a * 9) + (c << 2) - -t;\n"
+            "    }\n"
+            "    var int: u = f%d(a, c) + f%d(a, c);\n"
+            "    return (a * 9) + (c << 2) - 3 * t++;\n"
+            "}\n\n", n, n % 7, n, n);
+    }
+
+    Parser* plain = test_parse(source, false);
+    Parser* cons = test_parse(source, true);
+
+    cr_assert_eq(cons->root->data.root.size, plain->root->data.root.size,
+        "ast: # of declarations changed with hash-consing");
+    cr_assert_lt(cons->exprs.size, plain->exprs.size / 2,
+        "ast: hash-consing should share equal expressions: %zu nodes of %zu", cons->exprs.size, plain->exprs.size);
+
+    static char a[4096], b[4096];
+
+    for (size_t i = 0; i < plain->root->data.root.size; i++) {
+        size_t size, cons_size;
+        ASTN_ExprRef* refs = test_fn_exprs(plain, i, &size);
+        ASTN_ExprRef plain_refs[64];
+        memcpy(plain_refs, refs, size * sizeof(ASTN_ExprRef));
+
+        ASTN_ExprRef* cons_refs = test_fn_exprs(cons, i, &cons_size);
+
+        cr_assert_eq(cons_size, size,
+            "ast: # of expressions of function %zu changed with hash-consing", i);
+
+        for (size_t k = 0; k < size; k++) {
+            test_print(&plain->exprs, plain_refs[k], a, sizeof(a));
+            test_print(&cons->exprs, cons_refs[k], b, sizeof(b));
+
+            cr_assert_str_eq(b, a,
+                "ast: expression %zu of function %zu changed with hash-consing", k, i);
+        }
+    }
+
+    parser_free(plain);
+    parser_free(cons);
+}
+
+Test(ast, cons_shares) {
+    const char* source =
+        "fn g => (int: x) {\n"
+        "    return x;\n"
+        "}\n"
+        "fn f => (int: x) {\n"
+        "    var int: a = (x + 2) * (x + 2);\n"
+        "    var int: b = g(x) + g(x);\n"
+        "    var int: c = x++ + x++;\n"
+        "    return (x + 2);\n"
+        "}\n";
+
+    Parser* parser = test_parse(source, true);
+    Parser* again = test_parse(source, true);
+    ASTN_ExprPool* pool = &parser->exprs;
+
+    size_t size;
+    ASTN_ExprRef* refs = test_fn_exprs(parser, 1, &size);
+
+    cr_assert_eq(size, 4,
+        "ast: expected 4 expressions found %zu", size);
+
+    ASTN_ExprNode* a = AST_EXPR(pool, refs[0]);
+    ASTN_ExprNode* b = AST_EXPR(pool, refs[1]);
+    ASTN_ExprNode* c = AST_EXPR(pool, refs[2]);
+
+    cr_assert_eq(a->data.binary_op.left, a->data.binary_op.right,
+        "ast: equal pure operands should share one node");
+    cr_assert_eq(refs[3], a->data.binary_op.left,
+        "ast: equal pure expressions of different statements should share one node");
+    cr_assert_neq(ast_expr_hash(pool, refs[3]), 0,
+        "ast: shared expression should carry a hash");
+
+    cr_assert_neq(b->data.binary_op.left, b->data.binary_op.right,
+        "ast: calls should never be shared");
+    cr_assert_eq(ast_expr_hash(pool, refs[1]), 0,
+        "ast: expression holding calls shouldn't carry a hash");
+    cr_assert_neq(c->data.binary_op.left, c->data.binary_op.right,
+        "ast: ++ should never be shared");
+
+    // hashes are structural, so a second parse gives them again
+    size_t again_size;
+    ASTN_ExprRef* again_refs = test_fn_exprs(again, 1, &again_size);
+
+    for (size_t k = 0; k < size; k++) {
+        cr_assert_eq(ast_expr_hash(&again->exprs, again_refs[k]), ast_expr_hash(pool, refs[k]),
+            "ast: hash of expression %zu changed between parses", k);
+    }
+
+    parser_free(again);
+    parser_free(parser);
+}
+
+Test(ast, scopes) {
+    // (a block numbered past a sibling one still sees the function's scope)
+    const char* source =
+        "fn f => (int: a) {\n"
+        "    while (a < 1) {\n"
+        "        var int: a = 2;\n"
+        "        return a;\n"
+        "    }\n"
+        "    while (a < 2) {\n"
+        "        return a;\n"
+        "    }\n"
+        "    return a;\n"
+        "}\n";
+
+    Parser* parser = test_parse(source, false);
+    ASTN_ExprPool* pool = &parser->exprs;
+
+    cr_assert_eq(parser->lexer->errors, 0,
+        "ast: expected no diagnostics found %zu", (size_t)parser->lexer->errors);
+
+    size_t size;
+    ASTN_ExprRef* refs = test_fn_exprs(parser, 0, &size);
+
+    cr_assert_eq(size, 6,
+        "ast: expected 6 expressions found %zu", size);
+
+    ASTN_Iden param = AST_EXPR(pool, AST_EXPR(pool, refs[0])->data.binary_op.left)->data.identifier;
+    ASTN_Iden local = AST_EXPR(pool, refs[2])->data.identifier;
+
+    cr_assert_neq(local.scope, param.scope,
+        "ast: local should hide the parameter inside its block");
+    cr_assert(AST_IDEN_EQ(AST_EXPR(pool, refs[4])->data.identifier, param),
+        "ast: parameter should be found from a later sibling block");
+    cr_assert(AST_IDEN_EQ(AST_EXPR(pool, refs[5])->data.identifier, param),
+        "ast: parameter should be found again once the block is left");
+
+    parser_free(parser);
+}
+
+Test(ast, duplicates) {
+    // redeclarations are reported the same, and the same symbols kept, on any # of threads
+    // (enough functions for parser_parse_parallel to spread them over several workers)
+    static char source[1 << 21];
+    size_t len = 0;
+
+    for (int n = 0; n < 10000; n++) {
+        len += (size_t)snprintf(source + len, sizeof(source) - len,
+            "fn d%d => (int: a) {\n"
+            "    var int: x = a + %d;\n"
+            "    var int: x = a;\n"
+            "    return x;\n"
+            "}\n\n", n, n);
+    }
+
+    Parser* parallel = test_parse(source, false);
+
+    Parser* serial = test_parser(source);
+    parser_parse_parallel(serial, 1);
+
+    cr_assert_eq(parallel->lexer->errors, 10000,
+        "ast: expected 10000 redeclarations reported found %zu", (size_t)parallel->lexer->errors);
+    cr_assert_eq(serial->lexer->errors, parallel->lexer->errors,
+        "ast: # of diagnostics changed with the # of threads");
+
+    Symbol* a = parallel->tbl->symbol;
+    Symbol* b = serial->tbl->symbol;
+
+    for (; a && b; a = a->next, b = b->next) {
+        cr_assert(a->data.atom == b->data.atom && a->data.scope == b->data.scope && a->data.decl_line == b->data.decl_line,
+            "ast: symbol %s changed with the # of threads", intern_name(a->data.atom));
+        cr_assert_eq(symtbl_find(parallel->tbl, a->data.atom, a->data.scope), a,
+            "ast: listed symbol %s should hold its key", intern_name(a->data.atom));
+    }
+
+    cr_assert(!a && !b,
+        "ast: # of symbols changed with the # of threads");
+
+    parser_free(parallel);
+    parser_free(serial);
+}
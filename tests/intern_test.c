@@ -0,0 +1,73 @@
+#include <criterion/criterion.h>
+
+#include "intern.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+TestSuite(intern);
+
+Test(intern, atom) {
+    uint32_t a = intern_atom("accumulated", 11);
+    uint32_t b = intern_atom("accumulated_weight", 18);
+
+    cr_assert_neq(a, 0,
+        "intern: 0 should never be handed out");
+    cr_assert_neq(a, b,
+        "intern: different names should get different atoms");
+    cr_assert_eq(intern_atom("accumulated_weight", 11), a,
+        "intern: the same bytes should get the same atom");
+    cr_assert_str_eq(intern_name(b), "accumulated_weight",
+        "intern: name of an atom should round trip");
+    cr_assert_eq(intern_len(b), 18,
+        "intern: expected length 18 found %zu", intern_len(b));
+    cr_assert_eq(intern_hash(a), intern_hash_bytes("accumulated", 11),
+        "intern: hash of an atom should be the hash of its name");
+    cr_assert_leq(b, intern_count(),
+        "intern: atoms should be dense");
+    cr_assert_str_eq(intern_name(0), "",
+        "intern: atom 0 should have no name");
+}
+
+static void* test_intern_run(void* arg) {
+    // every thread interns the same names, in a different order
+    uint32_t* atoms = arg;
+    char name[32];
+
+    for (int k = 0; k < 20000; k++) {
+        int i = (k * 7919 + (int)atoms[0]) % 20000;
+        snprintf(name, sizeof(name), "threaded_%d", i);
+        atoms[1 + i] = intern_atom(name, strlen(name));
+    }
+
+    return NULL;
+}
+
+Test(intern, threads) {
+    static uint32_t atoms[4][20001];
+    pthread_t handles[4];
+
+    for (int t = 0; t < 4; t++) {
+        atoms[t][0] = (uint32_t)t * 5000;
+        pthread_create(&handles[t], NULL, test_intern_run, atoms[t]);
+    }
+
+    for (int t = 0; t < 4; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    char name[32];
+
+    for (int i = 0; i < 20000; i++) {
+        snprintf(name, sizeof(name), "threaded_%d", i);
+
+        for (int t = 1; t < 4; t++) {
+            cr_assert_eq(atoms[t][1 + i], atoms[0][1 + i],
+                "intern: %s got different atoms on different threads", name);
+        }
+
+        cr_assert_str_eq(intern_name(atoms[0][1 + i]), name,
+            "intern: %s got the atom of another name", name);
+    }
+}
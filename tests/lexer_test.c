@@ -2,6 +2,8 @@
 
 #include "lexer.h"
 
+#include <pthread.h>
+
 TestSuite(lexer);
 
 Test(lexer, init) {
@@ -10,20 +12,283 @@ Test(lexer, init) {
     cr_assert_not_null(lexer, 
         "lexer: lexer struct shouldn't be null");
 
-    cr_assert_eq(lexer->buf_size, 1075,
-        "lexer: lexer buffer initialized incorrectly %d -> %d", 1075, lexer->buf_size);
+    cr_assert_eq(lexer->buf_size, 1076,
+        "lexer: lexer buffer initialized incorrectly %d -> %zu", 1076, lexer->buf_size);
+    cr_assert_eq(lexer->buf[lexer->buf_size], '\0',
+        "lexer: lexer buffer should be '\\0' terminated");
     cr_assert_eq(lexer->i, 0,
-        "lexer: lexer index initialized incorrectly %d -> %d", 0, lexer->i);
-    cr_assert_eq(lexer->cl, 1,
-        "lexer: lexer current line initialized incorrectly %d -> %d", 1, lexer->cl);
-    cr_assert_eq(lexer->cc, 1,
-        "lexer: lexer current column initialized incorrectly %d -> %d", 1, lexer->cc);
+        "lexer: lexer index initialized incorrectly %d -> %zu", 0, lexer->i);
+    cr_assert_eq(lexer_line(lexer, lexer->i), 1,
+        "lexer: lexer current line initialized incorrectly %d -> %u", 1, lexer_line(lexer, lexer->i));
+    cr_assert_eq(lexer_column(lexer, lexer->i), 1,
+        "lexer: lexer current column initialized incorrectly %d -> %u", 1, lexer_column(lexer, lexer->i));
     cr_assert_eq(lexer->c, 'i',
         "lexer: lexer current char initialized incorrectly %c -> %c", 'i', lexer->c);
 
     lexer_free(lexer);
 }
 
+Test(lexer, init_from_buffer) {
+    char buf[] = "fn x => ();";
+    Lexer* lexer = lexer_init_from_buffer(buf, 2);
+
+    cr_assert_not_null(lexer,
+        "lexer: lexer struct shouldn't be null");
+    cr_assert_eq(lexer->buf, buf,
+        "lexer: lexer should read the provided buffer in place");
+    cr_assert_eq(lexer->buf_size, 2,
+        "lexer: lexer buffer initialized incorrectly %d -> %zu", 2, lexer->buf_size);
+
+    Token* token = lexer_next_token(lexer);
+    cr_assert_eq(token->type, TOK_FN,
+        "lexer: mismatch in expected token type: expected: %d found: %d", TOK_FN, token->type);
+
+    token = lexer_next_token(lexer);
+    cr_assert_eq(token->type, TOK_EOF,
+        "lexer: lexer should stop at the provided size: expected: %d found: %d", TOK_EOF, token->type);
+
+    lexer_free(lexer);
+}
+
+Test(lexer, locations) {
+    char buf[] = "fn\n  x =>\v\n\"a\nb\" y";
+    Lexer* lexer = lexer_init_from_buffer(buf, sizeof(buf) - 1);
+
+    size_t offsets[] = { 0, 2, 5, 11, 13, 16 };
+    unsigned int lines[] = { 1, 1, 2, 4, 4, 5 };
+    unsigned int cols[] = { 1, 3, 3, 1, 3, 3 };
+
+    cr_assert_eq(lexer->lines_size, 5,
+        "lexer: mismatch in the # of indexed lines: expected: %d found: %zu", 5, lexer->lines_size);
+
+    for (int i = 0; i < 6; i++) {
+        cr_assert_eq(lexer_line(lexer, offsets[i]), lines[i],
+            "lexer: mismatch in the line of offset %zu: expected: %u found: %u", offsets[i], lines[i], lexer_line(lexer, offsets[i]));
+        cr_assert_eq(lexer_column(lexer, offsets[i]), cols[i],
+            "lexer: mismatch in the column of offset %zu: expected: %u found: %u", offsets[i], cols[i], lexer_column(lexer, offsets[i]));
+    }
+
+    lexer_free(lexer);
+}
+
+Test(lexer, scanners) {
+    char buf[] = "\tvar_with_a_name_longer_than_one_vector_block_0123456789\r\n"
+        "                                        123_456_789_012_345\n"
+        "  \"string literal spanning\nmore than thirty two bytes \\t ok\" x";
+    const char* isas[] = { "avx2", "sse2", "scalar" };
+
+    int types[] = { TOK_IDEN, TOK_L_LUINT, TOK_L_STRING, TOK_IDEN, TOK_EOF };
+    unsigned int lines[] = { 1, 2, 3, 4, 4 };
+
+    for (int n = 0; n < 3; n++) {
+        if (!scan_use(isas[n])) {
+            continue;
+        }
+
+        Lexer* lexer = lexer_init_from_buffer(buf, sizeof(buf) - 1);
+
+        for (int i = 0; i < 5; i++) {
+            Token* token = lexer_next_token(lexer);
+
+            cr_assert_eq(token->type, types[i],
+                "lexer: [%s] mismatch in expected token type: expected: %d found: %d", isas[n], types[i], token->type);
+            cr_assert_eq(lexer_line(lexer, token->offset), lines[i],
+                "lexer: [%s] mismatch in expected token line: expected: %u found: %u", isas[n], lines[i], lexer_line(lexer, token->offset));
+        }
+
+        lexer_free(lexer);
+    }
+}
+
+static char test_threads_buf[] = "fn f => (int: a) {\n    return a * 3 - 1.5f;\n}\n";
+
+static void* test_init_run(void* arg) {
+    Lexer* lexer = lexer_init_from_buffer(test_threads_buf, sizeof(test_threads_buf) - 1);
+    TokenStream* tokens = lexer_tokenize_all(lexer);
+
+    *(size_t*)arg = tokens->size;
+
+    token_stream_free(tokens);
+    lexer_free(lexer);
+
+    return NULL;
+}
+
+Test(lexer, init_threads) {
+    // lexers made on several threads at once (the first ones pick the scanners)
+    pthread_t threads[8];
+    size_t sizes[8];
+
+    for (int i = 0; i < 8; i++) {
+        cr_assert_eq(pthread_create(&threads[i], NULL, test_init_run, &sizes[i]), 0,
+            "lexer: couldn't start thread %d", i);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        pthread_join(threads[i], NULL);
+
+        cr_assert_eq(sizes[i], sizes[0],
+            "lexer: thread %d lexed %zu tokens, thread 0 %zu", i, sizes[i], sizes[0]);
+    }
+
+    cr_assert_gt(sizes[0], 1,
+        "lexer: expected the tokens of the buffer");
+}
+
+Test(lexer, parallel) {
+    const char* unit = "fn f => (int: a) {\n    fprint(\"multi\nline \\\" string\");\n    return a * 3 - 1.5f;\n}\n";
+    size_t unit_len = strlen(unit), size = 0, capacity = (size_t)3 << 20;
+    char* buf = malloc(capacity + 1);
+
+    cr_assert_not_null(buf, "lexer: failed to allocate the test buffer");
+
+    while (size + unit_len <= capacity) {
+        memcpy(buf + size, unit, unit_len);
+        size += unit_len;
+    }
+    buf[size] = '\0';
+
+    Lexer* sequential = lexer_init_from_buffer(buf, size);
+    Lexer* parallel = lexer_init_from_buffer(buf, size);
+    TokenStream* expected = lexer_tokenize_all(sequential);
+    TokenStream* found = lexer_tokenize_parallel(parallel, 3);
+
+    cr_assert_eq(found->size, expected->size,
+        "lexer: parallel token count mismatch: expected: %zu found: %zu", expected->size, found->size);
+
+    for (size_t i = 0; i < expected->size; i++) {
+        cr_assert(found->type[i] == expected->type[i] && found->offset[i] == expected->offset[i] &&
+            found->len[i] == expected->len[i],
+            "lexer: parallel token %zu differs from the sequential one", i);
+    }
+
+    token_stream_free(expected);
+    token_stream_free(found);
+    lexer_free(sequential);
+    lexer_free(parallel);
+    free(buf);
+}
+
+Test(lexer, int_literals) {
+    char buf[] = "255 256 4294967296 18446744073709551616 -128 -129 -2147483649 1_000 "
+        "340282366920938463463374607431768211456";
+
+    int types[] = { TOK_L_SSUINT, TOK_L_SUINT, TOK_L_LUINT, TOK_L_LLUINT, TOK_L_SSINT, TOK_L_SINT, TOK_L_LINT,
+        TOK_L_SUINT, TOK_EOF };
+    __uint128_t values[] = { 255, 256, (__uint128_t)1 << 32, (__uint128_t)1 << 64, (__uint128_t)-128, (__uint128_t)-129,
+        (__uint128_t)-2147483649LL, 1000, 0 };
+
+    Lexer* lexer = lexer_init_from_buffer(buf, sizeof(buf) - 1);
+    TokenStream* stream = lexer_tokenize_all(lexer);
+
+    // the last literal overflows 128 bits and is dropped with a diagnostic
+    cr_assert_eq(stream->size, 9,
+        "lexer: mismatch in expected token count: expected: %d found: %zu", 9, stream->size);
+
+    for (size_t i = 0; i < stream->size; i++) {
+        cr_assert_eq(stream->type[i], types[i],
+            "lexer: mismatch in expected token type: expected: %d found: %d", types[i], stream->type[i]);
+        cr_assert(token_stream_number(stream, i) == values[i],
+            "lexer: mismatch in the parsed value of token %zu", i);
+    }
+
+    token_stream_free(stream);
+    lexer_free(lexer);
+}
+
+Test(lexer, recovery) {
+    size_t count = 100000, size = 0;
+    char* buf = malloc(5 * count + 16);
+
+    cr_assert_not_null(buf, "lexer: failed to allocate the test buffer");
+
+    // a long run of malformed tokens must neither recurse nor stop the lexer
+    for (size_t i = 0; i < count; i++) {
+        const char* bad = (i % 2) ? "@ " : "1__2 ";
+
+        memcpy(buf + size, bad, strlen(bad));
+        size += strlen(bad);
+    }
+
+    memcpy(buf + size, "x;", 3);
+    size += 2;
+
+    Lexer* lexer = lexer_init_from_buffer(buf, size);
+    TokenStream* stream = lexer_tokenize_all(lexer);
+
+    cr_assert_eq(stream->size, 3,
+        "lexer: mismatch in expected token count: expected: %d found: %zu", 3, stream->size);
+    cr_assert_eq(stream->type[0], TOK_IDEN,
+        "lexer: mismatch in expected token type: expected: %d found: %d", TOK_IDEN, stream->type[0]);
+    cr_assert_eq(lexer->errors, count,
+        "lexer: mismatch in the # of raised errors: expected: %zu found: %zu", count, lexer->errors);
+
+    token_stream_free(stream);
+    lexer_free(lexer);
+    free(buf);
+}
+
+typedef struct TestKeyword {
+    const char* name;
+    uint8_t type;
+} TestKeyword;
+
+#define TEST_KEYWORD(name, type) { name, type },
+
+Test(lexer, keywords) {
+    static const TestKeyword list[] = { KEYWORD_LIST(TEST_KEYWORD) };
+    size_t size = sizeof(list) / sizeof(list[0]);
+    const char* taken[KEYWORD_TABLE_SIZE] = {0};
+    char buf[MAX_KEYWORD_LEN + 2];
+
+    cr_assert_eq(size, NO_OF_KEYWORDS,
+        "lexer: expected %d keywords found %zu", NO_OF_KEYWORDS, size);
+
+    for (size_t i = 0; i < size; i++) {
+        size_t len = strlen(list[i].name);
+        unsigned int slot = KEYWORD_HASH(list[i].name[0], list[i].name[len - 1], len);
+
+        cr_assert_leq(len, MAX_KEYWORD_LEN,
+            "lexer: keyword %s is longer than MAX_KEYWORD_LEN", list[i].name);
+        cr_assert_null(taken[slot],
+            "lexer: keywords %s and %s share slot %u", list[i].name, taken[slot], slot);
+        taken[slot] = list[i].name;
+
+        cr_assert_eq(lexer_keyword(list[i].name, len), list[i].type,
+            "lexer: keyword %s should map to type %d", list[i].name, list[i].type);
+
+        // (near misses of a keyword are identifiers)
+        memcpy(buf, list[i].name, len);
+        buf[len] = '_';
+        cr_assert_eq(lexer_keyword(buf, len + 1), TOK_IDEN,
+            "lexer: %.*s shouldn't be a keyword", (int)len + 1, buf);
+        buf[0] = 'Z';
+        cr_assert_eq(lexer_keyword(buf, len), TOK_IDEN,
+            "lexer: %.*s shouldn't be a keyword", (int)len, buf);
+    }
+
+    // every keyword round-trips through the lexer as its own token
+    char source[1024];
+    size_t at = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        at += (size_t)snprintf(source + at, sizeof(source) - at, "%s ", list[i].name);
+    }
+
+    Lexer* lexer = lexer_init_from_buffer(source, at);
+    TokenStream* stream = lexer_tokenize_all(lexer);
+
+    for (size_t i = 0; i < size; i++) {
+        cr_assert_eq(stream->type[i], list[i].type,
+            "lexer: %s lexed as type %d, expected %d", list[i].name, stream->type[i], list[i].type);
+        cr_assert_str_eq(token_stream_value(stream, i), list[i].name,
+            "lexer: keyword %s should keep its text", list[i].name);
+    }
+
+    token_stream_free(stream);
+    lexer_free(lexer);
+}
+
 Test(lexer, lex) {
     Lexer* lexer = lexer_init("../examples/test/1.nex");
 
@@ -55,8 +320,8 @@ Test(lexer, lex) {
 
     for (int i = 0; i < 304; i++) {
         Token* token = lexer_next_token(lexer);
-        cr_assert_str_eq(token->value, values[i], 
-            "lexer: mismatch in expected token value: expected: %s found: %s", values[i], token->value);
+        cr_assert_str_eq(lexer_token_value(lexer, token), values[i], 
+            "lexer: mismatch in expected token value: expected: %s found: %s", values[i], lexer_token_value(lexer, token));
         cr_assert_eq(token->type, types[i],
             "lexer: mismatch in expected token type: expected: %d found: %d", types[i], token->type);
     }
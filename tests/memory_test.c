@@ -0,0 +1,146 @@
+#include <criterion/criterion.h>
+
+#include "memory.h"
+#include "ast.h"
+
+#include <stdint.h>
+#include <string.h>
+
+TestSuite(memory);
+
+Test(memory, alloc) {
+    Arena arena;
+    arena_init(&arena);
+
+    cr_assert_null(arena.head,
+        "memory: arena shouldn't allocate a block before its first use");
+
+    for (size_t i = 1; i < 10000; i++) {
+        char* ptr = arena_alloc(&arena, i % 100 + 1);
+
+        cr_assert_eq((uintptr_t)ptr % ARENA_ALIGN, 0,
+            "memory: allocation %zu isn't aligned to %d bytes", i, ARENA_ALIGN);
+        memset(ptr, 0xAB, i % 100 + 1);
+    }
+
+    char* large = arena_alloc(&arena, ARENA_BLOCK_SIZE * 2);
+    char* after = arena_alloc(&arena, 16);
+
+    memset(large, 0, ARENA_BLOCK_SIZE * 2);
+
+    cr_assert(after < large || after >= large + ARENA_BLOCK_SIZE * 2,
+        "memory: a large allocation shouldn't overlap later ones");
+
+    arena_free(&arena);
+
+    cr_assert_null(arena.head,
+        "memory: arena should be empty after arena_free");
+    cr_assert_eq(arena.allocated, 0,
+        "memory: arena should be empty after arena_free");
+}
+
+Test(memory, realloc) {
+    Arena arena;
+    arena_init(&arena);
+
+    size_t* items = NULL;
+    size_t moves = 0;
+
+    for (size_t size = 0; size < 100000; size++) {
+        size_t* grown = arena_realloc(&arena, items, size * sizeof(size_t), (size + 1) * sizeof(size_t));
+
+        moves += (grown != items);
+        items = grown;
+        items[size] = size;
+
+        // interleaved allocations must not land inside the array's reserved capacity
+        memset(arena_alloc(&arena, 24), 0xFF, 24);
+    }
+
+    for (size_t i = 0; i < 100000; i++) {
+        cr_assert_eq(items[i], i,
+            "memory: grown array lost item %zu: found %zu", i, items[i]);
+    }
+
+    cr_assert_lt(moves, 32,
+        "memory: growing one item at a time should only move the array log(n) times, moved %zu", moves);
+
+    arena_free(&arena);
+}
+
+Test(memory, adopt) {
+    Arena arena, from;
+    arena_init(&arena);
+    arena_init(&from);
+
+    char* kept = arena_strndup(&from, "kept alive", 4);
+    arena_alloc(&arena, 16);
+    arena_adopt(&arena, &from);
+
+    cr_assert_null(from.head,
+        "memory: adopted arena should be left empty");
+    cr_assert_str_eq(kept, "kept",
+        "memory: adopted allocation should stay valid: expected: kept found: %s", kept);
+
+    arena_free(&from);
+    arena_free(&arena);
+}
+
+Test(memory, vec) {
+    Arena arena;
+    arena_init(&arena);
+
+    ASTN_Statements stms = {0};
+    AST_Node* nodes = arena_calloc(&arena, 100000, sizeof(AST_Node));
+
+    for (size_t i = 0; i < AST_VEC_SMALL(stms); i++) {
+        AST_VEC_PUSH(&arena, stms, &nodes[i]);
+    }
+
+    cr_assert_eq(stms.capacity, 0,
+        "memory: %zu items should still be kept inline", AST_VEC_SMALL(stms));
+
+    // inline items go along with a copy of the vector
+    ASTN_Statements copy = stms;
+    size_t allocated = arena.allocated;
+
+    cr_assert_eq(AST_VEC_ITEMS(copy)[0], &nodes[0],
+        "memory: copied vector lost its inline items");
+    cr_assert_eq(arena.allocated, allocated,
+        "memory: inline items shouldn't be allocated");
+
+    size_t moves = 0;
+
+    for (size_t i = stms.size; i < 100000; i++) {
+        AST_Node** items = AST_VEC_ITEMS(stms);
+        AST_VEC_PUSH(&arena, stms, &nodes[i]);
+        moves += (AST_VEC_ITEMS(stms) != items);
+    }
+
+    for (size_t i = 0; i < 100000; i++) {
+        cr_assert_eq(AST_VEC_ITEMS(stms)[i], &nodes[i],
+            "memory: grown vector lost item %zu", i);
+    }
+
+    cr_assert_lt(moves, 32,
+        "memory: growing one item at a time should only move the vector log(n) times, moved %zu", moves);
+
+    // reserving room spills the items right away
+    AST_VEC(ASTN_ElifBranch) branches = {0};
+    AST_VEC_RESERVE(&arena, branches, 10);
+
+    for (uint32_t i = 0; i < 10; i++) {
+        ASTN_ElifBranch branch = { .condition = i, .statements = &stms };
+        AST_VEC_PUSH(&arena, branches, branch);
+    }
+
+    cr_assert_geq(branches.capacity, 10,
+        "memory: reserved vector should hold 10 items: found capacity %u", branches.capacity);
+
+    for (uint32_t i = 0; i < 10; i++) {
+        cr_assert_eq(AST_VEC_ITEMS(branches)[i].condition, i,
+            "memory: reserved vector lost item %u", i);
+    }
+
+    arena_free(&arena);
+}
@@ -0,0 +1,223 @@
+#include <criterion/criterion.h>
+
+#include "parser.h"
+#include "nexast.h"
+#include "io.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+TestSuite(nexast);
+
+static const char* test_file = "../examples/α-roadmap/3.nex";
+static const char* test_cache = "nexast_test.nexast";
+
+static uint64_t test_hash(size_t* size) {
+    SourceBuffer src = io_load_file((char*)test_file);
+    uint64_t hash = nexast_hash(src.data, src.size);
+
+    *size = src.size;
+    io_free_file(&src);
+
+    return hash;
+}
+
+static void test_same_tree(AST_Node* a, ASTN_ExprPool* a_exprs, AST_Node* b, ASTN_ExprPool* b_exprs) {
+    cr_assert_eq(a->type, b->type,
+        "nexast: node type changed: expected: %d found: %d", a->type, b->type);
+
+    if (a->type == ROOT) {
+        cr_assert_eq(a->data.root.size, b->data.root.size,
+            "nexast: # of declarations changed: expected: %u found: %u", a->data.root.size, b->data.root.size);
+
+        for (size_t i = 0; i < a->data.root.size; i++) {
+            test_same_tree(AST_VEC_ITEMS(a->data.root)[i], a_exprs, AST_VEC_ITEMS(b->data.root)[i], b_exprs);
+        }
+    } else if (a->type == STMT && a->data.stm.type == STMT_FUNCTION_DECL) {
+        ASTN_FunctionDecl* fa = &a->data.stm.data.function_decl;
+        ASTN_FunctionDecl* fb = &b->data.stm.data.function_decl;
+
+        cr_assert(AST_IDEN_EQ(fa->identifier, fb->identifier),
+            "nexast: function identifier changed");
+        cr_assert_eq(fa->parameters->size, fb->parameters->size,
+            "nexast: # of parameters changed");
+
+        for (size_t i = 0; i < fa->parameters->size; i++) {
+            cr_assert_str_eq(AST_VEC_ITEMS(*fa->parameters)[i]->identifier, AST_VEC_ITEMS(*fb->parameters)[i]->identifier,
+                "nexast: parameter name changed");
+        }
+
+        cr_assert_eq(fa->statements->size, fb->statements->size,
+            "nexast: # of statements changed");
+
+        for (size_t i = 0; i < fa->statements->size; i++) {
+            test_same_tree(AST_VEC_ITEMS(*fa->statements)[i], a_exprs, AST_VEC_ITEMS(*fb->statements)[i], b_exprs);
+        }
+    } else if (a->type == STMT) {
+        cr_assert_eq(a->data.stm.type, b->data.stm.type,
+            "nexast: statement type changed: expected: %d found: %d", a->data.stm.type, b->data.stm.type);
+    }
+}
+
+Test(nexast, round_trip) {
+    size_t size;
+    uint64_t hash = test_hash(&size);
+
+    Parser* parser = parser_init((char*)test_file);
+    parser_parse(parser);
+
+    cr_assert(nexast_write((char*)test_cache, hash, size, parser->root, &parser->exprs, parser->tbl),
+        "nexast: image should be written");
+
+    // (each copy is relocated to wherever it was mapped)
+    NexAst* first = nexast_load((char*)test_cache, hash, size);
+    NexAst* second = nexast_load((char*)test_cache, hash, size);
+
+    cr_assert_not_null(first,
+        "nexast: image should load");
+    cr_assert_not_null(second,
+        "nexast: image should load while another copy is mapped");
+    cr_assert_neq((void*)second->root, (void*)first->root,
+        "nexast: copies of an image should be mapped apart");
+
+    NexAst* loaded[] = { first, second };
+
+    for (size_t k = 0; k < 2; k++) {
+        NexAst* ast = loaded[k];
+
+        test_same_tree(parser->root, &parser->exprs, ast->root, ast->exprs);
+
+        cr_assert_eq(ast->exprs->size, parser->exprs.size,
+            "nexast: # of expressions changed: expected: %zu found: %zu", parser->exprs.size, ast->exprs->size);
+        cr_assert(memcmp(ast->exprs->nodes, parser->exprs.nodes, parser->exprs.size * sizeof(ASTN_ExprNode)) == 0,
+            "nexast: expressions changed");
+
+        Symbol* expected = parser->tbl->symbol;
+        Symbol* found = ast->tbl.symbol;
+
+        for (; expected && found; expected = expected->next, found = found->next) {
+            cr_assert_eq(found->data.atom, expected->data.atom,
+                "nexast: symbol changed: expected: %u found: %u", expected->data.atom, found->data.atom);
+        }
+
+        cr_assert(!expected && !found,
+            "nexast: # of symbols changed");
+    }
+
+    nexast_free(second);
+    nexast_free(first);
+    parser_free(parser);
+    remove(test_cache);
+}
+
+Test(nexast, atoms) {
+    // names interned before the parse (or never used by it) take no part in the image
+    char name[32];
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(name, sizeof(name), "nexast_unused_%d", i);
+        intern_atom(name, strlen(name));
+    }
+
+    size_t size;
+    uint64_t hash = test_hash(&size);
+
+    Parser* parser = parser_init((char*)test_file);
+    parser_parse(parser);
+
+    cr_assert(nexast_write((char*)test_cache, hash, size, parser->root, &parser->exprs, parser->tbl),
+        "nexast: image should be written");
+
+    SourceBuffer image = io_load_file((char*)test_cache);
+    NexAstHeader head;
+    memcpy(&head, image.data, sizeof(head));
+
+    cr_assert(head.atoms_size > 0 && head.atoms_size < 1000,
+        "nexast: image should only name the atoms it holds, it names %llu", (unsigned long long)head.atoms_size);
+    // (the image numbers atoms its own way: the first symbol's is found by its name in the image)
+    uint32_t atom;
+    memcpy(&atom, image.data + head.symbols + offsetof(Symbol, data.atom), sizeof(atom));
+
+    cr_assert(atom >= 1 && atom <= head.atoms_size,
+        "nexast: atom %u of the image has no name", atom);
+
+    const char* names = image.data + head.atoms;
+    const char* first = NULL;
+
+    for (uint32_t i = 1; i <= head.atoms_size; i++) {
+        cr_assert_neq(strncmp(names, "nexast_unused_", 14), 0,
+            "nexast: image shouldn't name atoms it doesn't hold");
+
+        first = (i == atom) ? names : first;
+        names += strlen(names) + 1;
+    }
+
+    cr_assert_str_eq(first, intern_name(parser->tbl->symbol->data.atom),
+        "nexast: image named the first symbol '%s'", first);
+
+    io_free_file(&image);
+
+    NexAst* ast = nexast_load((char*)test_cache, hash, size);
+
+    cr_assert_not_null(ast,
+        "nexast: image should load");
+
+    Symbol* expected = parser->tbl->symbol;
+    Symbol* found = ast->tbl.symbol;
+
+    for (; expected && found; expected = expected->next, found = found->next) {
+        cr_assert_str_eq(intern_name(found->data.atom), intern_name(expected->data.atom),
+            "nexast: symbol name changed");
+    }
+
+    nexast_free(ast);
+    parser_free(parser);
+    remove(test_cache);
+}
+
+Test(nexast, stale) {
+    size_t size;
+    uint64_t hash = test_hash(&size);
+
+    Parser* parser = parser_init((char*)test_file);
+    parser_parse(parser);
+
+    cr_assert(nexast_write((char*)test_cache, hash, size, parser->root, &parser->exprs, parser->tbl),
+        "nexast: image should be written");
+
+    cr_assert_null(nexast_load((char*)test_cache, hash ^ 1, size),
+        "nexast: image of another source shouldn't load");
+    cr_assert_null(nexast_load((char*)test_cache, hash, size + 1),
+        "nexast: image of another source shouldn't load");
+    cr_assert_null(nexast_load("nexast_test_missing.nexast", hash, size),
+        "nexast: missing image shouldn't load");
+
+    parser_free(parser);
+    remove(test_cache);
+}
+
+Test(nexast, path) {
+    char* path = nexast_path("build/cache", "../examples/test/1.nex");
+
+    cr_assert(strncmp(path, "build/cache/1-", 14) == 0 && strlen(path) == 14 + 16 + 7 && strcmp(path + 30, ".nexast") == 0,
+        "nexast: cache of a .nex file should be named after it and its path's hash: found: %s", path);
+
+    // (one path however it's spelled, and another one for a source of the same name elsewhere)
+    char* same = nexast_path("build/cache", "../examples/../examples/test/./1.nex");
+    char* other = nexast_path("build/cache", "../examples/α-roadmap/1.nex");
+
+    cr_assert_str_eq(same, path,
+        "nexast: one source should have one cache however its path is spelled: %s and %s", path, same);
+    cr_assert(strcmp(other, path) != 0,
+        "nexast: sources of one name in different directories should have caches of their own: %s", path);
+    free(same);
+    free(other);
+    free(path);
+
+    path = nexast_path(".", "main.src");
+
+    cr_assert(strncmp(path, "./main.src-", 11) == 0 && strcmp(path + strlen(path) - 7, ".nexast") == 0,
+        "nexast: cache of another file should extend its name: found: %s", path);
+    free(path);
+}
@@ -10,10 +10,10 @@ Test(parser, init) {
 
     cr_assert_not_null(parser->lexer,
         "parser: lexer shouldn't be null");
-    cr_assert_not_null(parser->cur,
-        "parser: current token shouldn't be null"
+    cr_assert_not_null(parser->tokens,
+        "parser: token stream shouldn't be null"
     );
-    cr_assert_not_null(parser->tree,
+    cr_assert_not_null(parser->root,
         "parser: ast shouldn't be null");
     cr_assert_not_null(parser->tbl,
         "parser: table shouldn't be null");
@@ -0,0 +1,237 @@
+#include <criterion/criterion.h>
+
+#include "parser.h"
+#include "test_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+TestSuite(reparse);
+
+static char test_edited[1024]; // source as of the last test_edit, for a fresh parse to compare
+
+static const char* test_source =
+    "fn add => (int: a, int: b) {\n"
+    "    return a + b;\n"
+    "}\n"
+    "\n"
+    "fn twice => (int: x) {\n"
+    "    var int: y = add(x, x);\n"
+    "    return y * 2;\n"
+    "}\n"
+    "\n"
+    "fn thrice => (int: z) {\n"
+    "    while (z < 3) {\n"
+    "        return z * 3;\n"
+    "    }\n"
+    "}\n";
+
+static Parser* test_parse(const char* source) {
+    Parser* parser = test_parser(source);
+    parser_parse(parser);
+
+    return parser;
+}
+
+static bool test_edit(Parser* parser, const char* source, const char* old, const char* new) {
+    // applies the edit to the parser and keeps the edited source for a fresh parse to compare
+    const char* at = strstr(source, old);
+    size_t offset = (size_t)(at - source);
+
+    cr_assert_not_null(at,
+        "reparse: %s isn't in the source", old);
+    snprintf(test_edited, sizeof(test_edited), "%.*s%s%s", (int)offset, source, new, at + strlen(old));
+
+    return parser_reparse(parser, offset, strlen(old), new, strlen(new));
+}
+
+static void test_same_parse(Parser* parser) {
+    Parser* fresh = test_parse(test_edited);
+
+    TokenStream* a = parser->tokens;
+    TokenStream* b = fresh->tokens;
+
+    cr_assert_eq(a->size, b->size,
+        "reparse: # of tokens differs from a fresh lex: expected: %zu found: %zu", b->size, a->size);
+
+    for (size_t i = 0; i < a->size; i++) {
+        cr_assert(a->type[i] == b->type[i] && a->offset[i] == b->offset[i] && a->len[i] == b->len[i],
+            "reparse: token %zu differs from a fresh lex", i);
+        cr_assert_eq(token_stream_number(a, i), token_stream_number(b, i),
+            "reparse: value of token %zu differs from a fresh lex", i);
+    }
+
+    for (size_t i = 0; i < parser->lexer->lines_size; i++) {
+        cr_assert_eq(parser->lexer->lines[i], fresh->lexer->lines[i],
+            "reparse: line %zu starts elsewhere than on a fresh lex", i + 1);
+    }
+
+    ASTN_Root* ra = &parser->root->data.root;
+    ASTN_Root* rb = &fresh->root->data.root;
+
+    cr_assert_eq(ra->size, rb->size,
+        "reparse: # of declarations differs from a fresh parse: expected: %u found: %u", rb->size, ra->size);
+
+    for (size_t i = 0; i < ra->size; i++) {
+        cr_assert(parser->spans[i].start == fresh->spans[i].start && parser->spans[i].end == fresh->spans[i].end,
+            "reparse: tokens of declaration %zu differ from a fresh parse", i);
+
+        if (AST_VEC_ITEMS(*rb)[i]->data.stm.type != STMT_FUNCTION_DECL) {
+            continue;
+        }
+
+        ASTN_FunctionDecl* fa = &AST_VEC_ITEMS(*ra)[i]->data.stm.data.function_decl;
+        ASTN_FunctionDecl* fb = &AST_VEC_ITEMS(*rb)[i]->data.stm.data.function_decl;
+
+        cr_assert(AST_IDEN_EQ(fa->identifier, fb->identifier),
+            "reparse: declaration %zu differs from a fresh parse", i);
+        cr_assert_eq(fa->statements->size, fb->statements->size,
+            "reparse: # of statements of declaration %zu differs from a fresh parse", i);
+    }
+
+    // (scope ids differ, the ones of declarations parsed again being taken later)
+    size_t symbols = 0, fresh_symbols = 0;
+    Symbol* symb = parser->tbl->symbol;
+
+    for (Symbol* other = fresh->tbl->symbol; other != NULL; other = other->next) {
+        fresh_symbols++;
+
+        if (symb) {
+            cr_assert(symb->data.atom == other->data.atom && symb->data.type == other->data.type,
+                "reparse: symbol %zu differs from a fresh parse", fresh_symbols);
+            cr_assert_eq(symtbl_find(parser->tbl, symb->data.atom, symb->data.scope), symb,
+                "reparse: symbol %zu isn't indexed", fresh_symbols);
+            symbols++;
+            symb = symb->next;
+        }
+    }
+
+    for (; symb != NULL; symb = symb->next) {
+        symbols++;
+    }
+
+    cr_assert_eq(symbols, fresh_symbols,
+        "reparse: # of symbols differs from a fresh parse: expected: %zu found: %zu", fresh_symbols, symbols);
+
+    parser_free(fresh);
+}
+
+Test(reparse, in_place) {
+    Parser* parser = test_parse(test_source);
+    ASTN_Root* root = &parser->root->data.root;
+
+    AST_Node* add = AST_VEC_ITEMS(*root)[0];
+    AST_Node* twice = AST_VEC_ITEMS(*root)[1];
+    AST_Node* thrice = AST_VEC_ITEMS(*root)[2];
+
+    cr_assert(test_edit(parser, test_source, "add(x, x)", "add(x, 123456) + add(x, x)"),
+        "reparse: an edit inside a function body should be parsed in place");
+
+    cr_assert_eq(AST_VEC_ITEMS(*root)[0], add,
+        "reparse: declaration before the edit should be kept");
+    cr_assert_neq(AST_VEC_ITEMS(*root)[1], twice,
+        "reparse: edited declaration should be parsed again");
+    cr_assert_eq(AST_VEC_ITEMS(*root)[2], thrice,
+        "reparse: declaration after the edit should be kept");
+
+    test_same_parse(parser);
+
+    // shrinking back moves the tokens after it the other way
+    char edited[1024];
+    snprintf(edited, sizeof(edited), "%s", test_edited);
+
+    cr_assert(test_edit(parser, edited, "123456) + add(x, x)", "1)"),
+        "reparse: an edit inside a function body should be parsed in place");
+    cr_assert_eq(AST_VEC_ITEMS(*root)[2], thrice,
+        "reparse: declaration after the edit should be kept");
+
+    test_same_parse(parser);
+
+    parser_free(parser);
+}
+
+Test(reparse, lazy) {
+    Parser* parser = test_parser(test_source);
+    parser->lazy = true;
+    parser_parse(parser);
+
+    AST_Node* thrice = AST_VEC_ITEMS(parser->root->data.root)[2];
+
+    cr_assert(test_edit(parser, test_source, "return a + b;", "var int: c = a;\n    return a + b + c;"),
+        "reparse: an edit inside a function body should be parsed in place");
+
+    // the skipped body after the edit moved along with its tokens
+    ASTN_Statements* stms = parser_parse_body(parser, thrice);
+
+    cr_assert_not_null(stms,
+        "reparse: moved body should still parse");
+    cr_assert_eq(stms->size, 1,
+        "reparse: moved body should parse the same: expected: 1 statement found: %u", stms->size);
+    cr_assert_eq(AST_VEC_ITEMS(*stms)[0]->data.stm.type, STMT_WHILE_LOOP,
+        "reparse: moved body should parse the same");
+
+    parser_free(parser);
+}
+
+Test(reparse, garbage) {
+    // replaced declarations are freed by a whole parse once they'd take half of the memory
+    char other[1024];
+    const char* sources[2] = { test_source, other };
+    const char* bodies[2] = { "return y * 2;", "return y * 4;" };
+
+    snprintf(other, sizeof(other), "%s", test_source);
+    memcpy(strstr(other, bodies[0]), bodies[1], strlen(bodies[1]));
+
+    Parser* parser = test_parse(test_source);
+    size_t allocated = parser->arena.allocated;
+    size_t in_place = 0;
+
+    for (size_t i = 0; i < 200; i++) {
+        in_place += test_edit(parser, sources[i % 2], bodies[i % 2], bodies[(i + 1) % 2]);
+
+        cr_assert_leq(parser->arena.allocated, 4 * allocated,
+            "reparse: %zu bytes held after %zu edits (%zu after parsing)", parser->arena.allocated, i + 1, allocated);
+    }
+
+    cr_assert(in_place > 100 && in_place < 200,
+        "reparse: expected most edits in place and a few whole parses, %zu of 200 were in place", in_place);
+
+    test_same_parse(parser);
+
+    parser_free(parser);
+}
+
+Test(reparse, fallback) {
+    Parser* parser = test_parse(test_source);
+
+    // renaming a function changes what every other declaration sees
+    cr_assert(!test_edit(parser, test_source, "fn thrice", "fn triple"),
+        "reparse: renaming a function should parse the whole file again");
+
+    test_same_parse(parser);
+
+    size_t size = parser->lexer->buf_size;
+
+    cr_assert(!parser_reparse(parser, size + 1, 0, "x", 1),
+        "reparse: an edit past the end shouldn't apply");
+    cr_assert_eq(parser->lexer->buf_size, size,
+        "reparse: an edit past the end shouldn't change the source");
+
+    parser_free(parser);
+}
+
+Test(reparse, displaced) {
+    // a name a declaration after the edit holds goes to the edited one on a whole parse
+    char source[1024];
+
+    snprintf(source, sizeof(source), "enum color { red }\n\n%s", test_source);
+
+    Parser* parser = test_parse(source);
+
+    cr_assert(!test_edit(parser, source, "{ red }", "{ red, thrice }"),
+        "reparse: declaring a name held by a later declaration should parse the whole file again");
+
+    test_same_parse(parser);
+
+    parser_free(parser);
+}
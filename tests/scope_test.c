@@ -0,0 +1,204 @@
+#include <criterion/criterion.h>
+
+#include "parser.h"
+#include "test_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+TestSuite(scope);
+
+Test(scope, tree) {
+    ScopeTree* tree = scope_init();
+
+    cr_assert_eq(tree->size, 1,
+        "scope: a new tree should hold just the top level");
+
+    ScopeId decl = scope_reserve(tree, 3);
+    ScopeId other = scope_reserve(tree, 2);
+
+    cr_assert_eq(decl, 1,
+        "scope: expected the first run to start at 1 found %u", decl);
+    cr_assert_eq(other, decl + 3,
+        "scope: runs should be dense: expected %u found %u", decl + 3, other);
+
+    scope_open(tree, decl, 0, SCOPE_DECL);
+    scope_open(tree, decl + 1, decl, SCOPE_FUNCTION);
+    scope_open(tree, decl + 2, decl + 1, SCOPE_LOOP);
+
+    cr_assert_eq(scope_parent(tree, decl + 2), decl + 1,
+        "scope: expected parent %u found %u", decl + 1, scope_parent(tree, decl + 2));
+    cr_assert_eq(scope_parent(tree, decl), 0,
+        "scope: a declaration's own scope should be under the top level");
+    cr_assert_eq(scope_depth(tree, decl + 2), 3,
+        "scope: expected depth 3 found %u", scope_depth(tree, decl + 2));
+    cr_assert_eq(scope_kind(tree, decl + 1), SCOPE_FUNCTION,
+        "scope: kind should round trip");
+    cr_assert_eq(scope_kind(tree, other), SCOPE_ROOT,
+        "scope: a reserved scope shouldn't be open");
+
+    // (entries stay put by id as the tree grows)
+    scope_reserve(tree, 100000);
+
+    cr_assert_eq(scope_parent(tree, decl + 2), decl + 1,
+        "scope: growing the tree should keep its scopes");
+
+    scope_free(tree);
+}
+
+static Parser* test_parse(const char* source, unsigned int threads) {
+    Parser* parser = test_parser(source);
+    parser_parse_parallel(parser, threads);
+
+    return parser;
+}
+
+static Symbol* test_symbol(Parser* parser, const char* name) {
+    Symbol* symb = parser->tbl->symbol;
+
+    while (symb != NULL && strcmp(intern_name(symb->data.atom), name) != 0) {
+        symb = symb->next;
+    }
+
+    cr_assert_not_null(symb,
+        "scope: %s wasn't declared", name);
+
+    return symb;
+}
+
+Test(scope, parser) {
+    // a local declared after a loop is back in the function's scope
+    const char* source =
+        "fn f => (int: a) {\n"
+        "    for (var int: i = 0; i < a; i++) {\n"
+        "        if (i < 2) {\n"
+        "            var int: inner = i;\n"
+        "        }\n"
+        "    }\n"
+        "    var int: after = a;\n"
+        "    return after;\n"
+        "}\n"
+        "fn g => (int: b) {\n"
+        "    return b;\n"
+        "}\n";
+
+    Parser* parser = test_parse(source, 2);
+    ScopeTree* tree = parser->scopes;
+
+    cr_assert_eq(parser->lexer->errors, 0,
+        "scope: expected no diagnostics found %zu", (size_t)parser->lexer->errors);
+
+    Symbol* a = test_symbol(parser, "a");
+    Symbol* inner = test_symbol(parser, "inner");
+    Symbol* after = test_symbol(parser, "after");
+    Symbol* b = test_symbol(parser, "b");
+
+    cr_assert_eq(after->data.scope, a->data.scope,
+        "scope: a local after a block should be in the function's scope");
+    cr_assert_eq(scope_kind(tree, a->data.scope), SCOPE_FUNCTION,
+        "scope: parameters should be in a function scope");
+    cr_assert_eq(scope_kind(tree, inner->data.scope), SCOPE_BRANCH,
+        "scope: expected a branch scope found kind %u", scope_kind(tree, inner->data.scope));
+    cr_assert_eq(scope_kind(tree, scope_parent(tree, inner->data.scope)), SCOPE_LOOP,
+        "scope: the branch should be inside the loop");
+    cr_assert_eq(scope_parent(tree, scope_parent(tree, inner->data.scope)), a->data.scope,
+        "scope: the loop should be inside the function");
+    cr_assert_eq(scope_depth(tree, inner->data.scope), scope_depth(tree, a->data.scope) + 2,
+        "scope: expected depth %u found %u", scope_depth(tree, a->data.scope) + 2, scope_depth(tree, inner->data.scope));
+    cr_assert_eq(scope_kind(tree, scope_parent(tree, a->data.scope)), SCOPE_DECL,
+        "scope: the function should be inside its declaration's scope");
+
+    // runs are handed out in source order, whichever thread parses them
+    cr_assert_gt(b->data.scope, inner->data.scope,
+        "scope: a later declaration's scopes should be numbered past an earlier one's");
+    cr_assert_eq(tree->size, 7,
+        "scope: ids should be dense: %zu reserved for 7 scopes", tree->size);
+
+    Parser* serial = test_parse(source, 1);
+
+    cr_assert_eq(test_symbol(serial, "b")->data.scope, b->data.scope,
+        "scope: scopes changed with the # of threads");
+
+    parser_free(serial);
+    parser_free(parser);
+}
+
+Test(scope, order) {
+    // a body only sees the declarations before it, whichever thread parses it
+    const char* before =
+        "fn f => (int: a) {\n"
+        "    return a;\n"
+        "}\n"
+        "fn g => (int: b) {\n"
+        "    return f(b);\n"
+        "}\n";
+    const char* after =
+        "fn f => (int: a) {\n"
+        "    return g(a);\n"
+        "}\n"
+        "fn g => (int: b) {\n"
+        "    return b;\n"
+        "}\n";
+    const char* self =
+        "fn f => (int: a) {\n"
+        "    return f(a);\n"
+        "}\n";
+
+    for (unsigned int threads = 1; threads <= 4; threads++) {
+        Parser* parser = test_parse(before, threads);
+
+        cr_assert_eq(parser->lexer->errors, 0,
+            "scope: a call to an earlier function failed with %u threads", threads);
+        parser_free(parser);
+
+        parser = test_parse(after, threads);
+
+        cr_assert_eq(parser->lexer->errors, 1,
+            "scope: a call to a later function should fail with %u threads", threads);
+        parser_free(parser);
+
+        parser = test_parse(self, threads);
+
+        cr_assert_eq(parser->lexer->errors, 1,
+            "scope: a function shouldn't see itself with %u threads", threads);
+        parser_free(parser);
+    }
+}
+
+Test(scope, truncated) {
+    const char* source =
+        "fn f => (int: a) {\n"
+        "    return a;\n"
+        "}\n"
+        "fn g => (int: b) {\n"
+        "    return b +\n";
+
+    for (unsigned int threads = 1; threads <= 2; threads++) {
+        Parser* parser = test_parse(source, threads);
+
+        cr_assert_gt(parser->lexer->errors, 0,
+            "scope: a truncated source should be reported with %u threads", threads);
+
+        parser_free(parser);
+    }
+}
+
+Test(scope, attr_example) {
+    // a function of an attr is declared in the attr's scope, apart from a top-level name
+    for (unsigned int threads = 1; threads <= 2; threads++) {
+        Parser* parser = parser_init("../examples/attr.nex");
+        parser_parse_parallel(parser, threads);
+
+        cr_assert_eq(parser->lexer->errors, 0,
+            "scope: examples/attr.nex should parse without errors with %u threads", threads);
+
+        Symbol* talk = symtbl_find(parser->tbl, intern_atom("talk", 4), 0);
+
+        cr_assert(talk && talk->data.type == SYMBOL_ATTR,
+            "scope: talk should name the attr at the top level with %u threads", threads);
+        cr_assert_neq(test_symbol(parser, "talk")->data.scope, 0,
+            "scope: function of an attr shouldn't be declared at the top level with %u threads", threads);
+
+        parser_free(parser);
+    }
+}
@@ -2,8 +2,16 @@
 
 #include "symtbl.h"
 
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
 TestSuite(symtbl);
 
+static uint32_t test_atom(const char* name) {
+    return intern_atom(name, strlen(name));
+}
+
 Test(symtbl, init) {
     SymTable* table = symtbl_init();
 
@@ -18,14 +26,14 @@ Test(symtbl, init) {
 Test(symtbl, insert_symbol) {
     SymTable* table = symtbl_init();
 
-    Symbol* symbol = symbol_init("is_alive", 1, 0, TOK_BOOL, 0, TOK_VAR, TOK_PUB, 23, 1);
+    Symbol* symbol = symbol_init(test_atom("is_alive"), SYMBOL_VARIABLE, 1, 0, TOK_BOOL, 0, TOK_VAR, TOK_PUB, 23, 1);
     
-    cr_assert_eq(symbol->data.id, -607172399,
-        "symtbl: symbol id was initialized incorrectly: expected: -607172399 found: %d", symbol->data.id);
+    cr_assert_eq(symbol->data.atom, test_atom("is_alive"),
+        "symtbl: symbol atom was initialized incorrectly: expected: %u found: %u", test_atom("is_alive"), symbol->data.atom);
     cr_assert_eq(symbol->data.scope, 1,
-        "symtbl: symbol scope was initialized incorrectly: expected: 1 found: %d", symbol->data.id);
+        "symtbl: symbol scope was initialized incorrectly: expected: 1 found: %u", symbol->data.scope);
     cr_assert_eq(symbol->data.nest, 0,
-        "symtbl: symbol nesting level was initialized incorrectly: expected: 0 found: %d", symbol->data.id);
+        "symtbl: symbol nesting level was initialized incorrectly: expected: 0 found: %u", symbol->data.nest);
     cr_assert_eq(symbol->data.mem_type, TOK_BOOL,
         "symtbl: symbol memory type was initialized incorrectly: expected: %d found: %d", TOK_BOOL, symbol->data.mem_type);
     cr_assert_eq(symbol->data.mem_mod, 0,
@@ -39,10 +47,10 @@ Test(symtbl, insert_symbol) {
     cr_assert_eq(symbol->data.decl_col, 1,
         "symtbl: symbol column was initialized incorrectly: expected: 1 found: %d", symbol->data.decl_col);
 
-    Symbol* symbol2 = symbol_init("hp", 1, 0, TOK_INT, TOK_SHORT, TOK_VAR, TOK_PUB, 98, 23);
+    Symbol* symbol2 = symbol_init(test_atom("hp"), SYMBOL_VARIABLE, 1, 0, TOK_INT, TOK_SHORT, TOK_VAR, TOK_PUB, 98, 23);
 
-    symtbl_insert(table, symbol);
-    symtbl_insert(table, symbol2);
+    symtbl_add(table, symbol);
+    symtbl_add(table, symbol2);
 
     cr_assert_eq(table->symbol, symbol,
         "symtbl: symbol not insterted propperly into table");
@@ -65,14 +73,14 @@ Test(symtbl, lookup_symbol) {
     uint8_t line_arr[] = {12, 23, 34, 45, 56, 67, 78};
     
     for (int i = 0; i < 7; i++) {
-        symtbl_insert(
+        symtbl_add(
             table, 
-            symbol_init(iden_arr[i], scope_arr[i], nest_arr[i], type_arr[i],
+            symbol_init(test_atom(iden_arr[i]), SYMBOL_VARIABLE, scope_arr[i], nest_arr[i], type_arr[i],
             mod_arr[i], sto_arr[i], access_arr[i], line_arr[i], 1)
         );
     }    
 
-    Symbol* symbol = symtbl_lookup(table, "grav", 0);
+    Symbol* symbol = symtbl_find(table, test_atom("grav"), 4);
 
     cr_assert_not_null(symbol,
         "symtbl: symbol lookup failed");
@@ -85,11 +93,11 @@ Test(symtbl, lookup_symbol) {
 Test(symtbl, borrow_symbol) {
     SymTable* table = symtbl_init();
 
-    Symbol* symbol = symbol_init("is_alive", 0, 0, TOK_BOOL, 0, TOK_VAR, TOK_PUB, 23, 1);
-    Symbol* borrower = symbol_init("game_loop", 0, 0, TOK_INT, TOK_SHORT, TOK_VAR, TOK_PUB, 98, 23);
+    Symbol* symbol = symbol_init(test_atom("is_alive"), SYMBOL_VARIABLE, 0, 0, TOK_BOOL, 0, TOK_VAR, TOK_PUB, 23, 1);
+    Symbol* borrower = symbol_init(test_atom("game_loop"), SYMBOL_VARIABLE, 0, 0, TOK_INT, TOK_SHORT, TOK_VAR, TOK_PUB, 98, 23);
 
-    symtbl_insert(table, symbol);
-    symtbl_insert(table, borrower);
+    symtbl_add(table, symbol);
+    symtbl_add(table, borrower);
 
     symtbl_borrowsym(table, symbol, borrower);
 
@@ -99,4 +107,404 @@ Test(symtbl, borrow_symbol) {
         "symtbl: borrow symbol did not update borrower_list proopperly");
 
     symtbl_free(table);
-}
\ No newline at end of file
+}
+Test(symtbl, index) {
+    SymTable* table = symtbl_init();
+    char name[32];
+
+    for (int i = 0; i < 100000; i++) {
+        snprintf(name, sizeof(name), "symbol_%d", i);
+        symtbl_add(table, symbol_init(test_atom(name), SYMBOL_VARIABLE, i % 64, 0, 0, 0, 0, 0, i, 1));
+    }
+
+    cr_assert_eq(symtbl_size(table), 100000,
+        "symtbl: expected 100000 indexed symbols found %zu", symtbl_size(table));
+
+    for (int i = 0; i < SYMTBL_SHARDS; i++) {
+        SymShard* shard = &table->index->shards[i];
+
+        cr_assert(shard->size > 0 && shard->size * 4 <= shard->slots->capacity * 3,
+            "symtbl: shard %d should hold symbols and be kept at most 3/4 full", i);
+    }
+
+    for (int i = 0; i < 100000; i++) {
+        snprintf(name, sizeof(name), "symbol_%d", i);
+        Symbol* symbol = symtbl_find(table, test_atom(name), i % 64);
+
+        cr_assert(symbol && symbol->data.decl_line == i,
+            "symtbl: symbol %d wasn't found", i);
+    }
+
+    cr_assert_null(symtbl_find(table, test_atom("symbol_1"), 2),
+        "symtbl: symbol shouldn't be found in another scope");
+
+    // a name declared twice in one scope keeps the first one, and the second isn't listed
+    Symbol* again = symbol_init(test_atom("symbol_7"), SYMBOL_VARIABLE, 7, 0, 0, 0, 0, 0, -1, 1);
+    Symbol* held = symtbl_add(table, again);
+
+    cr_assert(held != again && held->data.decl_line == 7,
+        "symtbl: adding a name declared twice should give the first one");
+    cr_assert_eq(symtbl_find(table, test_atom("symbol_7"), 7), held,
+        "symtbl: lookup of a name declared twice should find the first one");
+    cr_assert_neq(table->last, again,
+        "symtbl: symbol declared twice shouldn't be linked");
+
+    free(again);
+
+    symtbl_free(table);
+}
+
+Test(symtbl, remove) {
+    SymTable* table = symtbl_init();
+    Symbol* symbols[1000];
+    char name[32];
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(name, sizeof(name), "symbol_%d", i);
+        symbols[i] = symbol_init(test_atom(name), SYMBOL_VARIABLE, 0, 0, 0, 0, 0, 0, i, 1);
+        symtbl_add(table, symbols[i]);
+    }
+
+    // removed keys stop being found and can be added again, over and over without growing
+    // (the removed symbols stay linked, as the table leaves unlinking them to the caller)
+    size_t capacity = 0;
+
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 1000; i += 2) {
+            symtbl_remove(table, symbols[i]);
+
+            cr_assert_null(symtbl_find(table, symbols[i]->data.atom, 0),
+                "symtbl: removed symbol %d shouldn't be found", i);
+        }
+
+        cr_assert_eq(symtbl_size(table), 500,
+            "symtbl: expected 500 indexed symbols after removing half found %zu", symtbl_size(table));
+
+        for (int i = 0; i < 1000; i += 2) {
+            symbols[i] = symbol_init(symbols[i]->data.atom, SYMBOL_VARIABLE, 0, 0, 0, 0, 0, 0, i, 1);
+
+            cr_assert_eq(symtbl_add(table, symbols[i]), symbols[i],
+                "symtbl: removed key %d should be free to add again", i);
+        }
+
+        for (int i = 0; i < 1000; i++) {
+            cr_assert_eq(symtbl_find(table, symbols[i]->data.atom, 0), symbols[i],
+                "symtbl: symbol %d wasn't found", i);
+        }
+
+        for (int i = 0; round == 0 && i < SYMTBL_SHARDS; i++) {
+            capacity += table->index->shards[i].slots->capacity;
+        }
+    }
+
+    size_t last = 0;
+
+    for (int i = 0; i < SYMTBL_SHARDS; i++) {
+        last += table->index->shards[i].slots->capacity;
+    }
+
+    cr_assert_leq(last, capacity,
+        "symtbl: removing and adding keys back shouldn't grow the index: %zu slots, then %zu", capacity, last);
+
+    // (only removes what holds the key)
+    Symbol* other = symbol_init(symbols[1]->data.atom, SYMBOL_VARIABLE, 0, 0, 0, 0, 0, 0, -1, 1);
+
+    symtbl_remove(table, other);
+
+    cr_assert_eq(symtbl_find(table, symbols[1]->data.atom, 0), symbols[1],
+        "symtbl: removing a symbol not holding its key shouldn't remove the key");
+
+    free(other);
+    symtbl_free(table);
+}
+
+Test(symtbl, detach) {
+    SymTable* table = symtbl_init();
+    SymTable* child = symtbl_init_shared(table);
+
+    symtbl_add(table, symbol_init(test_atom("outer"), SYMBOL_FUNCTION, 0, 0, 0, 0, 0, 0, 1, 1));
+    symtbl_add(child, symbol_init(test_atom("inner"), SYMBOL_VARIABLE, 3, 0, 0, 0, 0, 0, 2, 1));
+    symtbl_add(child, symbol_init(test_atom("other"), SYMBOL_VARIABLE, 3, 0, 0, 0, 0, 0, 3, 1));
+
+    cr_assert_not_null(symtbl_find(child, test_atom("outer"), 0),
+        "symtbl: symbol of the table sharing its index should be found");
+    cr_assert_not_null(symtbl_find(table, test_atom("inner"), 3),
+        "symtbl: symbol added through a sharing table should be found");
+
+    Symbol* last;
+    Symbol* first = symtbl_detach(child, &last);
+
+    cr_assert(first && first->next == last && last->next == NULL,
+        "symtbl: detached symbols should stay linked in order");
+    cr_assert(child->symbol == NULL && child->last == NULL,
+        "symtbl: detached table should be empty");
+    cr_assert_eq(symtbl_find(table, test_atom("inner"), 3), first,
+        "symtbl: detached symbol should stay indexed");
+
+    // symbols linked by hand stay found, and unlinked ones are gone, once the table is indexed again
+    table->last->next = first;
+    symtbl_index(table);
+
+    cr_assert_eq(table->last, last,
+        "symtbl: indexing should find the last symbol");
+    cr_assert_eq(symtbl_find(child, test_atom("other"), 3), last,
+        "symtbl: symbol linked by hand should be found once indexed");
+
+    table->symbol->next = NULL;
+    symtbl_index(table);
+
+    cr_assert_null(symtbl_find(table, test_atom("inner"), 3),
+        "symtbl: symbol unlinked by hand shouldn't be found once indexed");
+    cr_assert_eq(symtbl_size(table), 1,
+        "symtbl: expected 1 indexed symbol found %zu", symtbl_size(table));
+
+    free(first);
+    free(last);
+    symtbl_free(child);
+    symtbl_free(table);
+}
+
+typedef struct TestAdder {
+    SymTable* table;
+    int thread;
+    size_t held; // # of contested keys this thread got
+} TestAdder;
+
+static void* test_add_run(void* arg) {
+    // adds 20000 keys of its own and the same 20000 contested keys as every other thread
+    TestAdder* adder = (TestAdder*)arg;
+    char name[32];
+
+    for (int i = 0; i < 20000; i++) {
+        snprintf(name, sizeof(name), "own_%d_%d", adder->thread, i);
+        symtbl_add(adder->table, symbol_init(test_atom(name), SYMBOL_VARIABLE, (unsigned int)i % 64, 0, 0, 0, 0, 0, i, 1));
+
+        snprintf(name, sizeof(name), "contested_%d", i);
+        Symbol* symb = symbol_init(test_atom(name), SYMBOL_VARIABLE, (unsigned int)i % 64, 0, 0, 0, 0, 0, i, 1);
+
+        if (symtbl_add(adder->table, symb) == symb) {
+            adder->held++;
+        } else {
+            free(symb);
+        }
+    }
+
+    return NULL;
+}
+
+Test(symtbl, threads) {
+    SymTable* table = symtbl_init();
+    TestAdder adders[4];
+    pthread_t handles[4];
+
+    for (int t = 0; t < 4; t++) {
+        adders[t] = (TestAdder){ symtbl_init_shared(table), t, 0 };
+        pthread_create(&handles[t], NULL, test_add_run, &adders[t]);
+    }
+
+    size_t held = 0;
+
+    for (int t = 0; t < 4; t++) {
+        pthread_join(handles[t], NULL);
+        held += adders[t].held;
+    }
+
+    cr_assert_eq(held, 20000,
+        "symtbl: every contested key should be held by exactly one thread, %zu were", held);
+    cr_assert_eq(symtbl_size(table), 100000,
+        "symtbl: expected 100000 indexed symbols found %zu", symtbl_size(table));
+
+    char name[32];
+
+    for (int i = 0; i < 20000; i++) {
+        for (int t = 0; t < 4; t++) {
+            snprintf(name, sizeof(name), "own_%d_%d", t, i);
+            Symbol* symb = symtbl_find(table, test_atom(name), (unsigned int)i % 64);
+
+            cr_assert(symb && symb->data.decl_line == i,
+                "symtbl: %s wasn't found", name);
+        }
+    }
+
+    for (int t = 0; t < 4; t++) {
+        symtbl_free(adders[t].table);
+    }
+
+    symtbl_free(table);
+}
+
+Test(symtbl, collision) {
+    SymTable* table = symtbl_init();
+
+    // ("ab" and "bA" hash alike under the 32-bit string hash symbols used to be known by)
+    Symbol* ab = symbol_init(test_atom("ab"), SYMBOL_VARIABLE, 3, 0, 0, 0, 0, 0, 1, 1);
+    Symbol* ba = symbol_init(test_atom("bA"), SYMBOL_VARIABLE, 3, 0, 0, 0, 0, 0, 2, 1);
+
+    symtbl_add(table, ab);
+    symtbl_add(table, ba);
+
+    cr_assert_eq(symtbl_find(table, test_atom("ab"), 3), ab,
+        "symtbl: names with colliding hashes should stay apart");
+    cr_assert_eq(symtbl_find(table, test_atom("bA"), 3), ba,
+        "symtbl: names with colliding hashes should stay apart");
+    cr_assert_neq(symtbl_hash(ab->data.atom, 3), symtbl_hash(ab->data.atom, 4),
+        "symtbl: scope should take part in the hash");
+
+    symtbl_free(table);
+}
+
+typedef struct TestRacer {
+    SymTable* table;
+    uint32_t* keys; // atoms (all in scope 1) sharing a shard and their first slot
+    int first; // writers add every other key from it; readers look all of them up
+    int* done;
+    size_t wrong; // # of lookups a reader got another key's symbol from
+} TestRacer;
+
+static void* test_write_run(void* arg) {
+    TestRacer* racer = (TestRacer*)arg;
+
+    for (int i = racer->first; i < 48; i += 2) {
+        symtbl_add(racer->table, symbol_init(racer->keys[i], SYMBOL_VARIABLE, 1, 0, 0, 0, 0, 0, i, 1));
+    }
+
+    return NULL;
+}
+
+static void* test_read_run(void* arg) {
+    // (keys past the first 48 are never added, so their probes end on slots being filled)
+    TestRacer* racer = (TestRacer*)arg;
+
+    while (!__atomic_load_n(racer->done, __ATOMIC_ACQUIRE)) {
+        for (int i = 0; i < 64; i++) {
+            Symbol* symb = symtbl_find(racer->table, racer->keys[i], 1);
+
+            if (symb && (symb->data.atom != racer->keys[i] || symb->data.scope != 1)) {
+                racer->wrong++;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+Test(symtbl, race) {
+    // lookups while other threads add keys colliding with theirs
+    uint32_t keys[64];
+    size_t size = 0;
+    uint64_t first = symtbl_hash(1u << 24, 1);
+
+    for (uint32_t atom = 1u << 24; size < 64; atom++) {
+        uint64_t hash = symtbl_hash(atom, 1);
+
+        if ((hash >> 32) % SYMTBL_SHARDS == (first >> 32) % SYMTBL_SHARDS && (hash & 0xFF) == (first & 0xFF)) {
+            keys[size++] = atom;
+        }
+    }
+
+    size_t wrong = 0;
+
+    for (int round = 0; round < 200; round++) {
+        SymTable* table = symtbl_init();
+        int done = 0;
+        TestRacer racers[4];
+        pthread_t handles[4];
+
+        for (int t = 0; t < 4; t++) {
+            racers[t] = (TestRacer){ (t < 2) ? symtbl_init_shared(table) : table, keys, t, &done, 0 };
+        }
+
+        pthread_create(&handles[2], NULL, test_read_run, &racers[2]);
+        pthread_create(&handles[3], NULL, test_read_run, &racers[3]);
+        pthread_create(&handles[0], NULL, test_write_run, &racers[0]);
+        pthread_create(&handles[1], NULL, test_write_run, &racers[1]);
+
+        pthread_join(handles[0], NULL);
+        pthread_join(handles[1], NULL);
+        __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+        pthread_join(handles[2], NULL);
+        pthread_join(handles[3], NULL);
+
+        wrong += racers[2].wrong + racers[3].wrong;
+
+        for (int i = 0; i < 48; i++) {
+            Symbol* symb = symtbl_find(table, keys[i], 1);
+
+            cr_assert(symb && symb->data.decl_line == i,
+                "symtbl: key %d wasn't found after the race", i);
+        }
+
+        symtbl_free(racers[0].table);
+        symtbl_free(racers[1].table);
+        symtbl_free(table);
+    }
+
+    cr_assert_eq(wrong, 0,
+        "symtbl: %zu lookups found a symbol of another key", wrong);
+}
+
+Test(symtbl, scopes) {
+    SymTable* table = symtbl_init();
+
+    Symbol* global = symbol_init(test_atom("x"), SYMBOL_VARIABLE, 0, 0, 0, 0, 0, 0, 1, 1);
+    Symbol* param = symbol_init(test_atom("x"), SYMBOL_VARIABLE, 1, 0, 0, 0, 0, 0, 2, 1);
+    Symbol* local = symbol_init(test_atom("x"), SYMBOL_VARIABLE, 2, 0, 0, 0, 0, 0, 3, 1);
+    Symbol* other = symbol_init(test_atom("y"), SYMBOL_VARIABLE, 2, 0, 0, 0, 0, 0, 4, 1);
+
+    // (nothing is bound while no scope is open)
+    symtbl_add(table, global);
+    symtbl_bind(table, global);
+
+    cr_assert_null(symtbl_lookup(table, global->data.atom),
+        "symtbl: symbol shouldn't be bound outside of a scope");
+
+    symtbl_enter(table);
+    symtbl_add(table, param);
+    symtbl_bind(table, param);
+
+    symtbl_enter(table);
+    symtbl_add(table, local);
+    symtbl_bind(table, local);
+    symtbl_add(table, other);
+    symtbl_bind(table, other);
+
+    cr_assert_eq(symtbl_depth(table), 2,
+        "symtbl: expected 2 open scopes found %zu", symtbl_depth(table));
+    cr_assert_eq(symtbl_lookup(table, local->data.atom), local,
+        "symtbl: innermost symbol should hide the outer one");
+    cr_assert_eq(local->shadow, param,
+        "symtbl: symbol should shadow the one it hides");
+
+    symtbl_leave(table, 1);
+
+    cr_assert_eq(symtbl_lookup(table, local->data.atom), param,
+        "symtbl: hidden symbol should be found once the inner scope is left");
+    cr_assert_null(symtbl_lookup(table, other->data.atom),
+        "symtbl: symbol of a left scope shouldn't be found");
+    cr_assert_eq(symtbl_find(table, other->data.atom, 2), other,
+        "symtbl: symbol of a left scope should stay in the table");
+
+    symtbl_leave(table, 0);
+
+    cr_assert_null(symtbl_lookup(table, param->data.atom),
+        "symtbl: no symbol should be bound once every scope is left");
+    cr_assert_null(param->shadow,
+        "symtbl: unbound symbol shouldn't shadow any");
+
+    // deep nesting still looks up in one probe
+    for (int i = 0; i < 1000; i++) {
+        symtbl_enter(table);
+    }
+
+    symtbl_bind(table, global);
+
+    for (int i = 0; i < 999; i++) {
+        symtbl_enter(table);
+    }
+
+    cr_assert_eq(symtbl_lookup(table, global->data.atom), global,
+        "symtbl: symbol of an outer scope should be found from a nested one");
+
+    symtbl_leave(table, 0);
+    symtbl_free(table);
+}
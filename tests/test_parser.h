@@ -0,0 +1,25 @@
+#ifndef TEST_PARSER_H
+#define TEST_PARSER_H
+
+#include <criterion/criterion.h>
+
+#include "parser.h"
+#include "io.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// parser over a copy of provided source, lexed but not parsed yet (as parser_init leaves one),
+// so tests parse from memory and leave no files behind
+static inline Parser* test_parser(const char* source) {
+    size_t size = strlen(source);
+    SourceBuffer src = { malloc(size + 1), size, 0 };
+
+    cr_assert_not_null(src.data,
+        "test: couldn't copy the source");
+    memcpy(src.data, source, size + 1);
+
+    return parser_init_from_source(src);
+}
+
+#endif // TEST_PARSER_H